@@ -23,8 +23,11 @@ CONFIG += qtquickcompiler
 QT += xml
 QT += svg
 QT += core
+QT += concurrent
 QT += quick
 QT += widgets
+QT += network
+QT += websockets
 QT += serialport
 QT += quickcontrols2
 
@@ -79,20 +82,115 @@ INCLUDEPATH += $$PWD/src
 
 HEADERS += \
     src/AppInfo.h \
+    src/Benchmark/ConsoleBenchmark.h \
+    src/Benchmark/DecoderBenchmark.h \
+    src/Benchmark/FuzzBenchmark.h \
+    src/Benchmark/Generators.h \
+    src/Benchmark/PlotBenchmark.h \
+    src/Benchmark/Report.h \
+    src/CLI/Broadcaster.h \
+    src/CLI/Sniffer.h \
+    src/CLI/Streamer.h \
+    src/Decoder/ModbusMonitor.h \
+    src/Decoder/ModbusRtu.h \
+    src/Decoder/Nmea.h \
+    src/Decoder/NmeaMonitor.h \
+    src/Misc/Histogram.h \
+    src/Misc/LatencyMonitor.h \
+    src/Misc/MemoryMonitor.h \
+    src/Misc/StartupProfiler.h \
+    src/Misc/StatsServer.h \
+    src/Misc/Tracer.h \
     src/Misc/Utilities.h \
+    src/Network/Bridge.h \
+    src/Network/ControlServer.h \
+    src/Network/Rfc2217Backend.h \
+    src/Network/SocketBackend.h \
+    src/Network/TcpClientBackend.h \
+    src/Network/TcpServerBackend.h \
+    src/Network/WebSocketServer.h \
+    src/Network/UdpBackend.h \
+    src/Plot/Dataset.h \
+    src/Plot/FieldParser.h \
+    src/Plot/FieldStatistics.h \
+    src/Plot/LineSplitter.h \
+    src/Plot/Pyramid.h \
+    src/Serial/Backend.h \
     src/Serial/Console.h \
+    src/Serial/Dispatcher.h \
+    src/Serial/LoopbackTester.h \
     src/Serial/Manager.h \
+    src/Serial/PatternGenerator.h \
+    src/Serial/ProcessBackend.h \
+    src/Serial/SerialPortBackend.h \
+    src/Serial/Statistics.h \
+    src/Serial/Subscription.h \
     src/Serial/FileTransmission.h \
+    src/UI/PlotWidget.h \
     src/UI/TerminalWidget.h
 
 SOURCES += \
+    src/Benchmark/ConsoleBenchmark.cpp \
+    src/Benchmark/DecoderBenchmark.cpp \
+    src/Benchmark/FuzzBenchmark.cpp \
+    src/Benchmark/Generators.cpp \
+    src/Benchmark/PlotBenchmark.cpp \
+    src/Benchmark/Report.cpp \
+    src/CLI/Broadcaster.cpp \
+    src/CLI/Sniffer.cpp \
+    src/CLI/Streamer.cpp \
+    src/Decoder/ModbusMonitor.cpp \
+    src/Decoder/ModbusRtu.cpp \
+    src/Decoder/Nmea.cpp \
+    src/Decoder/NmeaMonitor.cpp \
+    src/Misc/Histogram.cpp \
+    src/Misc/LatencyMonitor.cpp \
+    src/Misc/MemoryMonitor.cpp \
+    src/Misc/StartupProfiler.cpp \
+    src/Misc/StatsServer.cpp \
+    src/Misc/Tracer.cpp \
     src/Misc/Utilities.cpp \
+    src/Network/Bridge.cpp \
+    src/Network/ControlServer.cpp \
+    src/Network/Rfc2217Backend.cpp \
+    src/Network/SocketBackend.cpp \
+    src/Network/TcpClientBackend.cpp \
+    src/Network/TcpServerBackend.cpp \
+    src/Network/WebSocketServer.cpp \
+    src/Network/UdpBackend.cpp \
+    src/Plot/Dataset.cpp \
+    src/Plot/FieldParser.cpp \
+    src/Plot/FieldStatistics.cpp \
+    src/Plot/LineSplitter.cpp \
+    src/Plot/Pyramid.cpp \
+    src/Serial/Backend.cpp \
     src/Serial/Console.cpp \
+    src/Serial/Dispatcher.cpp \
+    src/Serial/LoopbackTester.cpp \
     src/Serial/Manager.cpp \
+    src/Serial/PatternGenerator.cpp \
+    src/Serial/ProcessBackend.cpp \
+    src/Serial/SerialPortBackend.cpp \
+    src/Serial/Statistics.cpp \
+    src/Serial/Subscription.cpp \
     src/Serial/FileTransmission.cpp \
+    src/UI/PlotWidget.cpp \
     src/UI/TerminalWidget.cpp \
     src/main.cpp
 
+unix {
+    HEADERS += src/Benchmark/PtyBenchmark.h \
+               src/Misc/SharedRing.h \
+               src/Serial/PtyProcessBackend.h
+    SOURCES += src/Benchmark/PtyBenchmark.cpp \
+               src/Misc/SharedRing.cpp \
+               src/Serial/PtyProcessBackend.cpp
+}
+
+unix:!macx {
+    LIBS += -lrt
+}
+
 #-------------------------------------------------------------------------------
 # Import application resources & QML UI files
 #-------------------------------------------------------------------------------
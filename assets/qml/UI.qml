@@ -25,6 +25,8 @@ import QtQuick.Dialogs 1.1
 import QtQuick.Layouts 1.12
 import QtQuick.Controls 2.12
 
+import Qt.labs.settings 1.0
+
 import "Windows" as Windows
 import "Widgets" as Widgets
 
@@ -110,6 +112,48 @@ Page {
                 Layout.fillWidth: true
             }
 
+            //
+            // Plot button
+            //
+            Button {
+                flat: true
+                icon.width: 24
+                icon.height: 24
+                text: qsTr("Plot") + " "
+                icon.color: palette.buttonText
+                icon.source: "qrc:/icons/workspaces.svg"
+                Layout.alignment: Qt.AlignVCenter
+                onClicked: _plot.showNormal()
+            }
+
+            //
+            // Statistics button
+            //
+            Button {
+                flat: true
+                icon.width: 24
+                icon.height: 24
+                text: qsTr("Statistics") + " "
+                icon.color: palette.buttonText
+                icon.source: "qrc:/icons/toolbox.svg"
+                Layout.alignment: Qt.AlignVCenter
+                onClicked: _fieldStatistics.showNormal()
+            }
+
+            //
+            // Decoders button
+            //
+            Button {
+                flat: true
+                icon.width: 24
+                icon.height: 24
+                text: qsTr("Decoders") + " "
+                icon.color: palette.buttonText
+                icon.source: "qrc:/icons/developer-board.svg"
+                Layout.alignment: Qt.AlignVCenter
+                onClicked: _decoders.showNormal()
+            }
+
             //
             // Serial setup button
             //
@@ -164,16 +208,109 @@ Page {
     }
 
     //
-    // Serial setup dialog
+    // Save serial port settings between runs (the serial setup dialog is only loaded
+    // when the user opens it, so settings are stored here)
     //
-    Windows.SerialSetup {
+    Settings {
+        id: _serialSettings
+        category: "serial"
+        property int port: Cpp_Serial_Manager.portIndex
+        property int baudRate: Cpp_Serial_Manager.baudRateIndex
+        property int dataBits: Cpp_Serial_Manager.dataBitsIndex
+        property int parity: Cpp_Serial_Manager.parityIndex
+        property int flowControl: Cpp_Serial_Manager.flowControlIndex
+        property int stopBits: Cpp_Serial_Manager.stopBitsIndex
+
+        Component.onCompleted: {
+            Cpp_Serial_Manager.portIndex = port
+            Cpp_Serial_Manager.baudRateIndex = baudRate
+            Cpp_Serial_Manager.dataBitsIndex = dataBits
+            Cpp_Serial_Manager.parityIndex = parity
+            Cpp_Serial_Manager.flowControlIndex = flowControl
+            Cpp_Serial_Manager.stopBitsIndex = stopBits
+        }
+    }
+
+    //
+    // Keep saved serial port settings up to date
+    //
+    Connections {
+        target: Cpp_Serial_Manager
+        onPortIndexChanged: _serialSettings.port = Cpp_Serial_Manager.portIndex
+        onParityChanged: _serialSettings.parity = Cpp_Serial_Manager.parityIndex
+        onDataBitsChanged: _serialSettings.dataBits = Cpp_Serial_Manager.dataBitsIndex
+        onStopBitsChanged: _serialSettings.stopBits = Cpp_Serial_Manager.stopBitsIndex
+        onBaudRateIndexChanged: _serialSettings.baudRate = Cpp_Serial_Manager.baudRateIndex
+        onFlowControlChanged: _serialSettings.flowControl = Cpp_Serial_Manager.flowControlIndex
+    }
+
+    //
+    // Serial setup dialog (loaded on demand)
+    //
+    Loader {
         id: _serialSetup
+        active: false
+        sourceComponent: Windows.SerialSetup {}
+
+        function showNormal() {
+            active = true
+            item.showNormal()
+        }
     }
 
     //
-    // File transmission dialog
+    // Plot window (loaded on demand)
+    //
+    Loader {
+        id: _plot
+        active: false
+        sourceComponent: Windows.Plot {}
+
+        function showNormal() {
+            active = true
+            item.showNormal()
+        }
+    }
+
     //
-    Windows.FileTransmission {
+    // Field statistics window (loaded on demand)
+    //
+    Loader {
+        id: _fieldStatistics
+        active: false
+        sourceComponent: Windows.FieldStatistics {}
+
+        function showNormal() {
+            active = true
+            item.showNormal()
+        }
+    }
+
+    //
+    // Decoders window (loaded on demand)
+    //
+    Loader {
+        id: _decoders
+        active: false
+        sourceComponent: Windows.Decoders {}
+
+        function showNormal() {
+            active = true
+            item.showNormal()
+        }
+    }
+
+    //
+    // File transmission dialog (loaded on demand)
+    //
+    Loader {
         id: _fileTransmission
+        active: false
+        sourceComponent: Windows.FileTransmission {}
+
+        function showNormal() {
+            active = true
+            item.showNormal()
+        }
     }
 }
@@ -0,0 +1,479 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+import QtQuick 2.12
+import QtQuick.Window 2.0
+import QtQuick.Layouts 1.12
+import QtQuick.Controls 2.12
+
+import Decoder 1.0 as Decoder
+import Qt.labs.settings 1.0
+
+Window {
+    id: root
+
+    //
+    // Window options
+    //
+    width: 960
+    height: 480
+    minimumWidth: 640
+    minimumHeight: 320
+    title: qsTr("Decoders")
+
+    //
+    // Only decode received data while the window is visible
+    //
+    onVisibleChanged: setDecodersEnabled(visible)
+    Component.onCompleted: setDecodersEnabled(visible)
+
+    //
+    // Enables or disables all decoders
+    //
+    function setDecodersEnabled(enabled) {
+        Decoder.NmeaMonitor.enabled = enabled
+        Decoder.ModbusMonitor.enabled = enabled
+    }
+
+    //
+    // Formats an optional value (values not reported by the receiver are undefined)
+    //
+    function formatValue(value, decimals) {
+        if (value === undefined)
+            return "-"
+
+        return decimals === undefined ? value : value.toFixed(decimals)
+    }
+
+    //
+    // Save settings
+    //
+    Settings {
+        category: "Decoders"
+        property alias x: root.x
+        property alias y: root.y
+        property alias width: root.width
+        property alias height: root.height
+        property alias follow: _follow.checked
+        property alias tab: _tabBar.currentIndex
+    }
+
+    //
+    // Use page item to set application palette
+    //
+    Page {
+        anchors.margins: 0
+        anchors.fill: parent
+        palette.text: app.foregroundColor
+        palette.buttonText: app.foregroundColor
+        palette.windowText: app.foregroundColor
+        palette.window: app.windowBackgroundColor
+
+        ColumnLayout {
+            spacing: app.spacing
+            anchors.fill: parent
+            anchors.margins: app.spacing
+
+            //
+            // Decoder selector
+            //
+            TabBar {
+                id: _tabBar
+                Layout.fillWidth: true
+
+                TabButton {
+                    text: qsTr("Modbus RTU")
+                }
+
+                TabButton {
+                    text: qsTr("NMEA 0183")
+                }
+            }
+
+            StackLayout {
+                Layout.fillWidth: true
+                Layout.fillHeight: true
+                currentIndex: _tabBar.currentIndex
+
+                //
+                // Modbus RTU frames
+                //
+                ColumnLayout {
+                    spacing: app.spacing
+
+                    //
+                    // Counters & controls
+                    //
+                    RowLayout {
+                        spacing: app.spacing
+                        Layout.fillWidth: true
+
+                        Label {
+                            Layout.alignment: Qt.AlignVCenter
+                            text: qsTr("Frames: %1, CRC errors: %2, exceptions: %3")
+                                  .arg(Decoder.ModbusMonitor.frameCount)
+                                  .arg(Decoder.ModbusMonitor.crcErrors)
+                                  .arg(Decoder.ModbusMonitor.exceptions)
+                        }
+
+                        Item {
+                            Layout.fillWidth: true
+                        }
+
+                        CheckBox {
+                            id: _follow
+                            checked: true
+                            text: qsTr("Follow")
+                            Layout.alignment: Qt.AlignVCenter
+                        }
+
+                        Button {
+                            text: qsTr("Clear")
+                            Layout.alignment: Qt.AlignVCenter
+                            onClicked: Decoder.ModbusMonitor.clear()
+                        }
+                    }
+
+                    //
+                    // Frame list
+                    //
+                    ListView {
+                        id: _frames
+                        clip: true
+                        Layout.fillWidth: true
+                        Layout.fillHeight: true
+                        model: Decoder.ModbusMonitor
+                        ScrollBar.vertical: ScrollBar {}
+                        onCountChanged: {
+                            if (_follow.checked)
+                                positionViewAtEnd()
+                        }
+
+                        delegate: RowLayout {
+                            spacing: app.spacing
+                            width: _frames.width
+
+                            readonly property color textColor: crcValid ? palette.text
+                                                                        : "#e0584d"
+
+                            Label {
+                                color: textColor
+                                font.family: app.monoFont
+                                Layout.preferredWidth: 96
+                                text: time.toFixed(6)
+                            }
+
+                            Label {
+                                color: textColor
+                                font.family: app.monoFont
+                                Layout.preferredWidth: 80
+                                text: delta === undefined ? "" : "+" + delta.toFixed(3)
+                            }
+
+                            Label {
+                                color: textColor
+                                font.family: app.monoFont
+                                Layout.preferredWidth: 32
+                                text: address
+                            }
+
+                            Label {
+                                color: textColor
+                                elide: Text.ElideRight
+                                Layout.preferredWidth: 200
+                                text: functionName + " (" + type + ")"
+                            }
+
+                            Label {
+                                color: textColor
+                                elide: Text.ElideRight
+                                Layout.fillWidth: true
+                                font.family: app.monoFont
+                                text: crcValid ? details : qsTr("CRC error: %1").arg(frameData)
+                            }
+                        }
+                    }
+                }
+
+                //
+                // NMEA 0183 sentences
+                //
+                ColumnLayout {
+                    spacing: app.spacing
+
+                    readonly property var position: Decoder.NmeaMonitor.position
+
+                    //
+                    // Counters & controls
+                    //
+                    RowLayout {
+                        spacing: app.spacing
+                        Layout.fillWidth: true
+
+                        Label {
+                            Layout.alignment: Qt.AlignVCenter
+                            text: qsTr("Sentences: %1, checksum errors: %2, malformed: %3")
+                                  .arg(Decoder.NmeaMonitor.sentenceCount)
+                                  .arg(Decoder.NmeaMonitor.checksumErrors)
+                                  .arg(Decoder.NmeaMonitor.malformedSentences)
+                        }
+
+                        Item {
+                            Layout.fillWidth: true
+                        }
+
+                        Button {
+                            text: qsTr("Clear")
+                            Layout.alignment: Qt.AlignVCenter
+                            onClicked: Decoder.NmeaMonitor.clear()
+                        }
+                    }
+
+                    //
+                    // Current fix
+                    //
+                    GridLayout {
+                        columns: 6
+                        rowSpacing: 0
+                        Layout.fillWidth: true
+                        columnSpacing: app.spacing
+
+                        Label { text: qsTr("Time (UTC):") }
+                        Label {
+                            font.family: app.monoFont
+                            Layout.fillWidth: true
+                            text: formatValue(position.time, 2)
+                        }
+
+                        Label { text: qsTr("Latitude:") }
+                        Label {
+                            font.family: app.monoFont
+                            Layout.fillWidth: true
+                            text: formatValue(position.latitude, 7)
+                        }
+
+                        Label { text: qsTr("Fix:") }
+                        Label {
+                            font.family: app.monoFont
+                            Layout.fillWidth: true
+                            text: qsTr("%1 (quality %2, type %3)")
+                                  .arg(position.valid ? qsTr("valid") : qsTr("invalid"))
+                                  .arg(formatValue(position.quality))
+                                  .arg(formatValue(position.fixType))
+                        }
+
+                        Label { text: qsTr("Date:") }
+                        Label {
+                            font.family: app.monoFont
+                            text: formatValue(position.date)
+                        }
+
+                        Label { text: qsTr("Longitude:") }
+                        Label {
+                            font.family: app.monoFont
+                            text: formatValue(position.longitude, 7)
+                        }
+
+                        Label { text: qsTr("Satellites:") }
+                        Label {
+                            font.family: app.monoFont
+                            text: formatValue(position.satellites)
+                        }
+
+                        Label { text: qsTr("Speed (kn):") }
+                        Label {
+                            font.family: app.monoFont
+                            text: formatValue(position.speed, 2)
+                        }
+
+                        Label { text: qsTr("Altitude (m):") }
+                        Label {
+                            font.family: app.monoFont
+                            text: formatValue(position.altitude, 1)
+                        }
+
+                        Label { text: qsTr("PDOP/HDOP/VDOP:") }
+                        Label {
+                            font.family: app.monoFont
+                            text: formatValue(position.pdop, 1) + " / "
+                                  + formatValue(position.hdop, 1) + " / "
+                                  + formatValue(position.vdop, 1)
+                        }
+
+                        Label { text: qsTr("Course (°):") }
+                        Label {
+                            font.family: app.monoFont
+                            text: formatValue(position.course, 1)
+                        }
+                    }
+
+                    //
+                    // Sentence types & satellites in view
+                    //
+                    RowLayout {
+                        spacing: app.spacing
+                        Layout.fillWidth: true
+                        Layout.fillHeight: true
+
+                        ListView {
+                            id: _types
+                            clip: true
+                            Layout.fillWidth: true
+                            Layout.fillHeight: true
+                            ScrollBar.vertical: ScrollBar {}
+                            model: Decoder.NmeaMonitor.types
+                            headerPositioning: ListView.OverlayHeader
+
+                            header: RowLayout {
+                                z: 2
+                                spacing: app.spacing
+                                width: _types.width
+
+                                Label {
+                                    font.bold: true
+                                    text: qsTr("Sentence")
+                                    Layout.preferredWidth: 80
+                                }
+
+                                Label {
+                                    font.bold: true
+                                    text: qsTr("Count")
+                                    Layout.preferredWidth: 80
+                                }
+
+                                Label {
+                                    font.bold: true
+                                    text: qsTr("Errors")
+                                    Layout.preferredWidth: 64
+                                }
+
+                                Label {
+                                    font.bold: true
+                                    text: qsTr("Rate (Hz)")
+                                    Layout.fillWidth: true
+                                }
+                            }
+
+                            delegate: RowLayout {
+                                spacing: app.spacing
+                                width: _types.width
+
+                                Label {
+                                    font.family: app.monoFont
+                                    text: modelData.name
+                                    Layout.preferredWidth: 80
+                                }
+
+                                Label {
+                                    font.family: app.monoFont
+                                    text: modelData.count
+                                    Layout.preferredWidth: 80
+                                }
+
+                                Label {
+                                    font.family: app.monoFont
+                                    text: modelData.errors
+                                    Layout.preferredWidth: 64
+                                    color: modelData.errors > 0 ? "#e0584d" : palette.text
+                                }
+
+                                Label {
+                                    font.family: app.monoFont
+                                    Layout.fillWidth: true
+                                    text: formatValue(modelData.rate, 2)
+                                }
+                            }
+                        }
+
+                        ListView {
+                            id: _satellites
+                            clip: true
+                            Layout.fillWidth: true
+                            Layout.fillHeight: true
+                            ScrollBar.vertical: ScrollBar {}
+                            model: Decoder.NmeaMonitor.satellites
+                            headerPositioning: ListView.OverlayHeader
+
+                            header: RowLayout {
+                                z: 2
+                                spacing: app.spacing
+                                width: _satellites.width
+
+                                Label {
+                                    font.bold: true
+                                    text: qsTr("Satellite")
+                                    Layout.preferredWidth: 80
+                                }
+
+                                Label {
+                                    font.bold: true
+                                    text: qsTr("Elevation")
+                                    Layout.preferredWidth: 80
+                                }
+
+                                Label {
+                                    font.bold: true
+                                    text: qsTr("Azimuth")
+                                    Layout.preferredWidth: 80
+                                }
+
+                                Label {
+                                    font.bold: true
+                                    text: qsTr("SNR (dB)")
+                                    Layout.fillWidth: true
+                                }
+                            }
+
+                            delegate: RowLayout {
+                                spacing: app.spacing
+                                width: _satellites.width
+
+                                Label {
+                                    font.family: app.monoFont
+                                    text: modelData.talker + " " + modelData.prn
+                                    Layout.preferredWidth: 80
+                                }
+
+                                Label {
+                                    font.family: app.monoFont
+                                    Layout.preferredWidth: 80
+                                    text: formatValue(modelData.elevation)
+                                }
+
+                                Label {
+                                    font.family: app.monoFont
+                                    Layout.preferredWidth: 80
+                                    text: formatValue(modelData.azimuth)
+                                }
+
+                                Label {
+                                    font.family: app.monoFont
+                                    Layout.fillWidth: true
+                                    text: formatValue(modelData.snr)
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
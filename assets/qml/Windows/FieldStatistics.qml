@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+import QtQuick 2.12
+import QtQuick.Window 2.0
+import QtQuick.Layouts 1.12
+import QtQuick.Controls 2.12
+
+import Plot 1.0 as Plot
+import Qt.labs.settings 1.0
+
+Window {
+    id: root
+
+    //
+    // Window options
+    //
+    width: 960
+    height: 360
+    minimumWidth: 640
+    minimumHeight: 240
+    title: qsTr("Field statistics")
+
+    //
+    // Only parse received data while the panel is visible
+    //
+    onVisibleChanged: Plot.FieldStatistics.enabled = visible
+    Component.onCompleted: Plot.FieldStatistics.enabled = visible
+
+    //
+    // Column titles & widths
+    //
+    readonly property int columnWidth: 72
+    readonly property var columns: [
+        qsTr("Field"), qsTr("Count"), qsTr("Min"), qsTr("Max"), qsTr("Mean"),
+        qsTr("Std dev"), qsTr("Rate (Hz)"), qsTr("Min"), qsTr("Max"), qsTr("Mean"),
+        qsTr("Std dev"), qsTr("Rate (Hz)")
+    ]
+
+    //
+    // Formats a value of the table (NaN is used for fields without samples)
+    //
+    function format(value) {
+        if (isNaN(value))
+            return "-"
+
+        return parseFloat(Number(value).toPrecision(6)).toString()
+    }
+
+    //
+    // Returns the values of a row of the table
+    //
+    function rowValues(index, field) {
+        return [
+            index + 1, field.count, format(field.min), format(field.max),
+            format(field.mean), format(field.stddev), format(field.rate),
+            format(field.windowMin), format(field.windowMax), format(field.windowMean),
+            format(field.windowStddev), format(field.windowRate)
+        ]
+    }
+
+    //
+    // Save settings
+    //
+    Settings {
+        category: "FieldStatistics"
+        property alias x: root.x
+        property alias y: root.y
+        property alias width: root.width
+        property alias height: root.height
+        property alias window: _window.value
+    }
+
+    //
+    // Use page item to set application palette
+    //
+    Page {
+        anchors.margins: 0
+        anchors.fill: parent
+        palette.text: app.foregroundColor
+        palette.buttonText: app.foregroundColor
+        palette.windowText: app.foregroundColor
+        palette.window: app.windowBackgroundColor
+
+        ColumnLayout {
+            spacing: app.spacing
+            anchors.fill: parent
+            anchors.margins: app.spacing
+
+            //
+            // Statistics controls
+            //
+            RowLayout {
+                spacing: app.spacing
+                Layout.fillWidth: true
+
+                Label {
+                    Layout.alignment: Qt.AlignVCenter
+                    text: qsTr("Fields: %1").arg(Plot.FieldStatistics.fieldCount)
+                }
+
+                Item {
+                    Layout.fillWidth: true
+                }
+
+                Label {
+                    text: qsTr("Window (seconds)") + ":"
+                    Layout.alignment: Qt.AlignVCenter
+                }
+
+                SpinBox {
+                    id: _window
+                    from: 1
+                    value: 60
+                    to: 600
+                    editable: true
+                    Layout.alignment: Qt.AlignVCenter
+                    onValueChanged: Plot.FieldStatistics.window = value
+                }
+
+                Button {
+                    text: qsTr("Clear")
+                    Layout.alignment: Qt.AlignVCenter
+                    onClicked: Plot.FieldStatistics.clear()
+                }
+            }
+
+            //
+            // Group titles
+            //
+            Row {
+                Layout.fillWidth: true
+
+                Item {
+                    width: root.columnWidth * 7
+                    height: 1
+                }
+
+                Label {
+                    font.bold: true
+                    width: root.columnWidth * 5
+                    horizontalAlignment: Text.AlignRight
+                    text: qsTr("Last %1 s").arg(Plot.FieldStatistics.window)
+                }
+            }
+
+            //
+            // Column titles
+            //
+            Row {
+                Layout.fillWidth: true
+
+                Repeater {
+                    model: root.columns
+                    delegate: Label {
+                        font.bold: true
+                        text: modelData
+                        width: root.columnWidth
+                        horizontalAlignment: Text.AlignRight
+                    }
+                }
+            }
+
+            //
+            // Statistics of each field
+            //
+            ListView {
+                clip: true
+                Layout.fillWidth: true
+                Layout.fillHeight: true
+                model: Plot.FieldStatistics.fields
+                ScrollBar.vertical: ScrollBar {}
+
+                delegate: Row {
+                    property int fieldIndex: index
+                    property var fieldValues: rowValues(index, modelData)
+
+                    Repeater {
+                        model: fieldValues
+                        delegate: Label {
+                            text: modelData
+                            font.family: app.monoFont
+                            width: root.columnWidth
+                            horizontalAlignment: Text.AlignRight
+                            color: index === 0 ? Qt.hsva(((fieldIndex * 137) % 360) / 360,
+                                                         180 / 255, 240 / 255, 1)
+                                               : palette.text
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+import QtQuick 2.12
+import QtQuick.Window 2.0
+import QtQuick.Layouts 1.12
+import QtQuick.Controls 2.12
+
+import UI 1.0
+import Plot 1.0 as Plot
+import Qt.labs.settings 1.0
+
+Window {
+    id: root
+
+    //
+    // Window options
+    //
+    width: 800
+    height: 480
+    minimumWidth: 480
+    minimumHeight: 320
+    title: qsTr("Plot")
+
+    //
+    // Only parse received data while the plot is visible
+    //
+    onVisibleChanged: Plot.Dataset.enabled = visible
+    Component.onCompleted: Plot.Dataset.enabled = visible
+
+    //
+    // Save settings
+    //
+    Settings {
+        category: "Plot"
+        property alias x: root.x
+        property alias y: root.y
+        property alias width: root.width
+        property alias height: root.height
+        property alias visibleSamples: _plot.visibleSamples
+    }
+
+    //
+    // Use page item to set application palette
+    //
+    Page {
+        anchors.margins: 0
+        anchors.fill: parent
+        palette.text: app.foregroundColor
+        palette.buttonText: app.foregroundColor
+        palette.windowText: app.foregroundColor
+        palette.window: app.windowBackgroundColor
+
+        ColumnLayout {
+            spacing: app.spacing
+            anchors.fill: parent
+            anchors.margins: app.spacing
+
+            //
+            // Plot controls
+            //
+            RowLayout {
+                spacing: app.spacing
+                Layout.fillWidth: true
+
+                Label {
+                    Layout.alignment: Qt.AlignVCenter
+                    text: qsTr("Channels: %1, samples: %2").arg(Plot.Dataset.channelCount)
+                                                           .arg(Plot.Dataset.sampleCount)
+                }
+
+                Item {
+                    Layout.fillWidth: true
+                }
+
+                Label {
+                    text: qsTr("Visible samples") + ":"
+                    Layout.alignment: Qt.AlignVCenter
+                }
+
+                SpinBox {
+                    from: 10
+                    editable: true
+                    stepSize: 100
+                    to: 1000000000
+                    value: _plot.visibleSamples
+                    Layout.alignment: Qt.AlignVCenter
+                    onValueModified: _plot.visibleSamples = value
+                }
+
+                Button {
+                    checkable: true
+                    text: qsTr("Follow")
+                    checked: _plot.following
+                    Layout.alignment: Qt.AlignVCenter
+                    onClicked: _plot.following = checked
+                }
+
+                Button {
+                    text: qsTr("Clear")
+                    Layout.alignment: Qt.AlignVCenter
+                    onClicked: Plot.Dataset.clear()
+                }
+            }
+
+            //
+            // Plot widget
+            //
+            PlotWidget {
+                id: _plot
+                Layout.fillWidth: true
+                Layout.fillHeight: true
+                textColor: app.foregroundColor
+                backgroundColor: app.windowBackgroundColor
+            }
+        }
+    }
+}
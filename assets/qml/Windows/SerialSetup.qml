@@ -25,8 +25,6 @@ import QtQuick.Window 2.0
 import QtQuick.Layouts 1.12
 import QtQuick.Controls 2.12
 
-import Qt.labs.settings 1.0
-
 Window {
     id: root
 
@@ -40,19 +38,6 @@ Window {
     maximumHeight: column.implicitHeight + 4 * app.spacing
     flags: Qt.Dialog | Qt.WindowCloseButtonHint | Qt.WindowTitleHint
 
-    //
-    // Save settings between runs
-    //
-    Settings {
-        category: "serial"
-        property alias port: _portCombo.currentIndex
-        property alias baudRate: _baudCombo.currentIndex
-        property alias dataBits: _dataCombo.currentIndex
-        property alias parity: _parityCombo.currentIndex
-        property alias flowControl: _flowCombo.currentIndex
-        property alias stopBits: _stopBitsCombo.currentIndex
-    }
-
     //
     // Use page item to set application palette
     //
@@ -99,6 +84,22 @@ Window {
                     }
                 }
 
+                //
+                // Network device address (e.g. tcp://192.168.1.50:23)
+                //
+                Label {
+                    text: qsTr("Address") + ":"
+                } TextField {
+                    id: _address
+                    Layout.fillWidth: true
+                    Layout.minimumWidth: 256
+                    placeholderText: "tcp://host:port"
+                    onAccepted: {
+                        if (text.length > 0)
+                            Cpp_Serial_Manager.connectToPort(text)
+                    }
+                }
+
                 //
                 // Baud rate selector
                 //
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDebug>
+#include <QElapsedTimer>
+
+#include <Serial/Console.h>
+#include <Benchmark/Generators.h>
+#include <Benchmark/ConsoleBenchmark.h>
+
+using namespace Benchmark;
+
+/**
+ * Minimum time spent measuring each function/input combination
+ */
+static const qint64 MIN_NSECS = 250 * 1000 * 1000;
+
+/**
+ * Maximum number of iterations for each function/input combination
+ */
+static const qint64 MAX_ITERATIONS = 100000;
+
+/**
+ * Constructor function, @a maxSize is the size of the largest generated input
+ */
+ConsoleBenchmark::ConsoleBenchmark(const qint64 maxSize)
+    : m_maxSize(qBound<qint64>(1024, maxSize, 100 * 1024 * 1024))
+    , m_report("console")
+    , m_console(Serial::Console::getInstance())
+{
+}
+
+/**
+ * Runs all the benchmarks and writes the report to the given @a output file (or to the
+ * standard output if @a output is empty).
+ *
+ * @returns the exit code of the application
+ */
+int ConsoleBenchmark::exec(const QString &output)
+{
+    // Stop the console from processing received data while we benchmark it
+    m_console->m_timer.stop();
+
+    // Run benchmarks for 1 KB, 10 KB, 100 KB, 1 MB, 10 MB & 100 MB inputs
+    for (qint64 size = 1024; size <= m_maxSize; size *= 10)
+    {
+        const int bytes = static_cast<int>(size);
+        benchmarkInput("ascii", Generators::ascii(bytes));
+        benchmarkInput("utf8", Generators::utf8(bytes));
+        benchmarkInput("binary", Generators::binary(bytes));
+        benchmarkInput("longLine", Generators::longLine(bytes));
+        benchmarkHex(bytes);
+    }
+
+    // Restore console state
+    m_console->clear();
+    m_console->setDisplayMode(Serial::Console::DisplayMode::DisplayPlainText);
+    m_console->m_timer.start();
+
+    // Write report
+    return m_report.write(output) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * Measures the time that the console needs to convert & display the given @a data.
+ */
+void ConsoleBenchmark::benchmarkInput(const QString &input, const QByteArray &data)
+{
+    auto console = m_console;
+    const int size = data.size();
+    const auto text = console->plainTextStr(data);
+
+    // clang-format off
+    measure("plainTextStr", input, size, [&]() {
+        return console->plainTextStr(data);
+    });
+    measure("hexadecimalStr", input, size, [&]() {
+        return console->hexadecimalStr(data);
+    });
+    measure("append", input, size, [&]() {
+        console->append(text);
+        return true;
+    });
+    // clang-format on
+
+    // Measure data to string conversion in both display modes
+    console->setDisplayMode(Serial::Console::DisplayMode::DisplayPlainText);
+    measure("dataToString/plainText", input, size, [&]() {
+        return console->dataToString(data);
+    });
+    console->setDisplayMode(Serial::Console::DisplayMode::DisplayHexadecimal);
+    measure("dataToString/hexadecimal", input, size, [&]() {
+        return console->dataToString(data);
+    });
+    console->setDisplayMode(Serial::Console::DisplayMode::DisplayPlainText);
+}
+
+/**
+ * Measures the time that the console needs to process hexadecimal strings typed by the
+ * user (@c formatUserHex() & @c hexToBytes()).
+ */
+void ConsoleBenchmark::benchmarkHex(const int size)
+{
+    auto console = m_console;
+    const auto text = Generators::hexString(size);
+
+    // clang-format off
+    measure("formatUserHex", "hex", text.length(), [&]() {
+        return console->formatUserHex(text);
+    });
+    measure("hexToBytes", "hex", text.length(), [&]() {
+        return console->hexToBytes(text);
+    });
+    // clang-format on
+}
+
+/**
+ * Calls @a function repeatedly until at least @c MIN_NSECS have been spent executing it
+ * and registers the results in the report. The console buffers are cleared between
+ * iterations (clearing time is not measured).
+ */
+template<typename Function>
+void ConsoleBenchmark::measure(const QString &name, const QString &input, const int size,
+                               Function function)
+{
+    qint64 nsecs = 0;
+    qint64 iterations = 0;
+
+    QElapsedTimer timer;
+    while (iterations == 0 || (nsecs < MIN_NSECS && iterations < MAX_ITERATIONS))
+    {
+        timer.start();
+        auto result = function();
+        nsecs += timer.nsecsElapsed();
+
+        Q_UNUSED(result);
+        m_console->clear();
+        ++iterations;
+    }
+
+    // Calculate average time & throughput
+    const double nsPerIteration = static_cast<double>(nsecs) / iterations;
+    const double mbPerSecond = (size / (1024.0 * 1024.0)) / (nsPerIteration * 1e-9);
+
+    // Register results
+    QJsonObject result;
+    result.insert("function", name);
+    result.insert("input", input);
+    result.insert("bytes", size);
+    result.insert("iterations", iterations);
+    result.insert("nsPerIteration", nsPerIteration);
+    result.insert("mbPerSecond", mbPerSecond);
+    m_report.add(result);
+
+    // Log progress
+    qDebug() << qPrintable(name) << qPrintable(input) << size << "bytes:" << mbPerSecond
+             << "MB/s";
+}
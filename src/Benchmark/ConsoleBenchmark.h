@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef BENCHMARK_CONSOLE_BENCHMARK_H
+#define BENCHMARK_CONSOLE_BENCHMARK_H
+
+#include <QString>
+#include <Benchmark/Report.h>
+
+namespace Serial
+{
+class Console;
+}
+
+namespace Benchmark
+{
+/**
+ * Micro-benchmarks for the data processing functions of the @c Serial::Console class.
+ *
+ * Each function is fed with synthetic inputs (ASCII, mixed UTF-8, binary & long lines)
+ * with sizes ranging from 1 KB up to the maximum size specified by the user (100 MB by
+ * default). Results are written as a JSON document so that different builds can be
+ * compared.
+ */
+class ConsoleBenchmark
+{
+public:
+    ConsoleBenchmark(const qint64 maxSize = 100 * 1024 * 1024);
+    int exec(const QString &output);
+
+private:
+    void benchmarkInput(const QString &input, const QByteArray &data);
+    void benchmarkHex(const int size);
+
+    template<typename Function>
+    void measure(const QString &name, const QString &input, const int size,
+                 Function function);
+
+private:
+    qint64 m_maxSize;
+    Report m_report;
+    Serial::Console *m_console;
+};
+}
+
+#endif
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDebug>
+#include <QElapsedTimer>
+
+#include <Decoder/Nmea.h>
+#include <Decoder/ModbusRtu.h>
+#include <Benchmark/Generators.h>
+#include <Benchmark/DecoderBenchmark.h>
+
+using namespace Benchmark;
+
+/**
+ * Minimum time spent measuring each function/input combination
+ */
+static const qint64 MIN_NSECS = 250 * 1000 * 1000;
+
+/**
+ * Maximum number of iterations for each function/input combination
+ */
+static const qint64 MAX_ITERATIONS = 100000;
+
+/**
+ * Line used as a reference for the real-time factor (115200 baud, 8N1)
+ */
+static const qint32 LINE_BAUD_RATE = 115200;
+static const int LINE_BITS_PER_CHARACTER = 10;
+
+/**
+ * Constructor function, @a maxSize is the size of the largest generated input
+ */
+DecoderBenchmark::DecoderBenchmark(const qint64 maxSize)
+    : m_maxSize(qBound<qint64>(1024, maxSize, 100 * 1024 * 1024))
+    , m_report("decoder")
+{
+}
+
+/**
+ * Runs all the benchmarks and writes the report to the given @a output file (or to the
+ * standard output if @a output is empty).
+ *
+ * @returns the exit code of the application
+ */
+int DecoderBenchmark::exec(const QString &output)
+{
+    // Run benchmarks for 1 KB, 10 KB, 100 KB, 1 MB, 10 MB & 100 MB inputs
+    for (qint64 size = 1024; size <= m_maxSize; size *= 10)
+    {
+        const auto modbus = Generators::modbusRtu(static_cast<int>(size));
+        benchmarkModbus(modbus, 8);
+        benchmarkModbus(modbus, 64);
+        benchmarkModbus(modbus, 4096);
+
+        const auto nmea = Generators::nmea(static_cast<int>(size));
+        benchmarkNmea(nmea, 8);
+        benchmarkNmea(nmea, 64);
+        benchmarkNmea(nmea, 4096);
+    }
+
+    // Write report
+    return m_report.write(output) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * Measures the time needed to split the given Modbus RTU @a data into frames when it
+ * is read in chunks of @a chunkSize bytes
+ */
+void DecoderBenchmark::benchmarkModbus(const QByteArray &data, const int chunkSize)
+{
+    QVector<Decoder::ModbusRtu::Frame> frames;
+    measure("ModbusRtu::process", chunkSize, data, [&]() {
+        Decoder::ModbusRtu decoder;
+        decoder.setLineConfiguration(LINE_BAUD_RATE, LINE_BITS_PER_CHARACTER);
+
+        frames.clear();
+        qint64 timestamp = 0;
+        for (int offset = 0; offset < data.size(); offset += chunkSize)
+        {
+            const int size = qMin(chunkSize, data.size() - offset);
+            timestamp += size * decoder.characterTime();
+            decoder.process(data.constData() + offset, size, timestamp, frames);
+        }
+
+        decoder.flush(timestamp + Decoder::ModbusRtu::IdleTimeout + 1, frames);
+        return frames.count();
+    });
+}
+
+/**
+ * Measures the time needed to validate & decode the given NMEA-0183 @a data when it is
+ * read in chunks of @a chunkSize bytes
+ */
+void DecoderBenchmark::benchmarkNmea(const QByteArray &data, const int chunkSize)
+{
+    measure("Nmea::process", chunkSize, data, [&]() {
+        Decoder::Nmea decoder;
+        for (int offset = 0; offset < data.size(); offset += chunkSize)
+        {
+            const int size = qMin(chunkSize, data.size() - offset);
+            decoder.process(data.constData() + offset, size, offset);
+        }
+
+        return static_cast<int>(decoder.counters().sentences);
+    });
+}
+
+/**
+ * Calls @a function repeatedly until at least @c MIN_NSECS have been spent executing it
+ * and registers the results (throughput in MB/s, messages per second & real-time
+ * factor) in the report, @a function returns the number of decoded frames or sentences.
+ */
+template<typename Function>
+void DecoderBenchmark::measure(const QString &name, const int chunkSize,
+                               const QByteArray &data, Function function)
+{
+    int messages = 0;
+    qint64 nsecs = 0;
+    qint64 iterations = 0;
+
+    QElapsedTimer timer;
+    while (iterations == 0 || (nsecs < MIN_NSECS && iterations < MAX_ITERATIONS))
+    {
+        timer.start();
+        messages = function();
+        nsecs += timer.nsecsElapsed();
+        ++iterations;
+    }
+
+    // Calculate average time & throughput
+    const int size = data.size();
+    const double nsPerIteration = static_cast<double>(nsecs) / iterations;
+    const double bytesPerSecond = size / (nsPerIteration * 1e-9);
+    const double lineBytesPerSecond
+        = static_cast<double>(LINE_BAUD_RATE) / LINE_BITS_PER_CHARACTER;
+
+    // Register results
+    QJsonObject result;
+    result.insert("function", name);
+    result.insert("chunkSize", chunkSize);
+    result.insert("bytes", size);
+    result.insert("messages", messages);
+    result.insert("iterations", iterations);
+    result.insert("nsPerIteration", nsPerIteration);
+    result.insert("mbPerSecond", bytesPerSecond / (1024.0 * 1024.0));
+    result.insert("messagesPerSecond", messages / (nsPerIteration * 1e-9));
+    result.insert("realTimeFactor", bytesPerSecond / lineBytesPerSecond);
+    m_report.add(result);
+
+    // Log progress
+    qDebug() << qPrintable(name) << chunkSize << "byte chunks" << size << "bytes:"
+             << bytesPerSecond / (1024.0 * 1024.0) << "MB/s"
+             << bytesPerSecond / lineBytesPerSecond << "x real time";
+}
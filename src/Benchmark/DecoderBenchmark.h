@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef BENCHMARK_DECODER_BENCHMARK_H
+#define BENCHMARK_DECODER_BENCHMARK_H
+
+#include <QString>
+#include <Benchmark/Report.h>
+
+namespace Benchmark
+{
+/**
+ * Micro-benchmarks for the protocol decoders: the Modbus RTU frame splitter & the
+ * NMEA-0183 decoder are fed in chunks of different sizes (as delivered by the serial
+ * driver), Modbus traffic is back-to-back with timestamps that advance at the speed of
+ * a 115200 baud line. Results include the ratio between the decoding throughput & the
+ * throughput of the line.
+ */
+class DecoderBenchmark
+{
+public:
+    DecoderBenchmark(const qint64 maxSize = 100 * 1024 * 1024);
+    int exec(const QString &output);
+
+private:
+    void benchmarkNmea(const QByteArray &data, const int chunkSize);
+    void benchmarkModbus(const QByteArray &data, const int chunkSize);
+
+    template<typename Function>
+    void measure(const QString &name, const int chunkSize, const QByteArray &data,
+                 Function function);
+
+private:
+    qint64 m_maxSize;
+    Report m_report;
+};
+}
+
+#endif
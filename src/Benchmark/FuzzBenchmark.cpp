@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cmath>
+
+#include <QDebug>
+#include <QElapsedTimer>
+
+#include <Serial/Console.h>
+#include <UI/TerminalWidget.h>
+#include <Benchmark/Generators.h>
+#include <Benchmark/FuzzBenchmark.h>
+
+using namespace Benchmark;
+
+/**
+ * Size of the chunks fed to each function (similar to a serial port read)
+ */
+static const int CHUNK_SIZE = 4096;
+
+/**
+ * Size of the smallest input
+ */
+static const int MIN_SIZE = 16 * 1024;
+
+/**
+ * Minimum time spent measuring each function/input/size combination
+ */
+static const qint64 MIN_NSECS = 100 * 1000 * 1000;
+
+/**
+ * Maximum number of iterations for each function/input/size combination
+ */
+static const qint64 MAX_ITERATIONS = 1000;
+
+/**
+ * Stop measuring larger inputs if a single iteration takes more than this time, the
+ * function is clearly not linear and larger inputs would take forever
+ */
+static const qint64 MAX_NSECS = 10ll * 1000 * 1000 * 1000;
+
+/**
+ * Maximum exponent of the fitted time/size curve (time ~ size^exponent) accepted as
+ * linear behavior, leaves some margin for cache effects & timer noise
+ */
+static const double MAX_EXPONENT = 1.25;
+
+/**
+ * Constructor function, @a maxSize is the size of the largest generated input
+ */
+FuzzBenchmark::FuzzBenchmark(const qint64 maxSize)
+    : m_maxSize(qBound<qint64>(MIN_SIZE * 16, maxSize, 4 * 1024 * 1024))
+    , m_report("fuzz")
+    , m_console(Serial::Console::getInstance())
+    , m_terminal(nullptr)
+{
+}
+
+/**
+ * Destructor function
+ */
+FuzzBenchmark::~FuzzBenchmark()
+{
+    delete m_terminal;
+}
+
+/**
+ * Runs all the benchmarks and writes the report to the given @a output file (or to the
+ * standard output if @a output is empty).
+ *
+ * @returns the exit code of the application, @c EXIT_FAILURE if any function does
+ *          not scale linearly with the size of its input
+ */
+int FuzzBenchmark::exec(const QString &output)
+{
+    // Stop the console from processing received data while we benchmark it
+    m_console->m_timer.stop();
+
+    // Create terminal widget with the same configuration as the QML interface
+    m_terminal = new UI::TerminalWidget;
+    m_terminal->setSize(QSizeF(800, 600));
+    m_terminal->setMaximumBlockCount(12000);
+    m_terminal->setWordWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
+
+    // Run benchmarks
+    bool linear = true;
+    linear &= benchmarkInput("binary", &Generators::binary);
+    linear &= benchmarkInput("giantLine", &Generators::longLine);
+    linear &= benchmarkInput("invalidUtf8", &Generators::invalidUtf8);
+    linear &= benchmarkInput("escapeFlood", &Generators::escapeFlood);
+    linear &= benchmarkInput("carriageReturns", &Generators::carriageReturns);
+
+    // Restore console state
+    m_console->clear();
+    m_console->m_timer.start();
+
+    // Write report
+    if (!m_report.write(output))
+        return EXIT_FAILURE;
+
+    // Report superlinear functions
+    if (!linear)
+    {
+        qWarning() << "Some functions do not scale linearly with the input size";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Splits the given @a data in chunks of @c CHUNK_SIZE bytes & converts them to text in
+ * the same way as the console does with received data.
+ */
+QStringList FuzzBenchmark::split(const QByteArray &data) const
+{
+    QStringList chunks;
+    for (int i = 0; i < data.size(); i += CHUNK_SIZE)
+        chunks.append(m_console->plainTextStr(data.mid(i, CHUNK_SIZE)));
+
+    return chunks;
+}
+
+/**
+ * Generates inputs of increasing size with the given @a generator & checks that the
+ * console & terminal functions process them in linear time.
+ *
+ * @returns @c false if any function does not scale linearly
+ */
+bool FuzzBenchmark::benchmarkInput(const QString &input,
+                                   QByteArray (*generator)(const int))
+{
+    // Generate inputs, sizes grow by a factor of 4
+    QList<int> sizes;
+    QList<QStringList> chunks;
+    for (qint64 size = MIN_SIZE; size <= m_maxSize; size *= 4)
+    {
+        sizes.append(static_cast<int>(size));
+        chunks.append(split(generator(static_cast<int>(size))));
+    }
+
+    // Measure functions
+    bool linear = true;
+    auto console = m_console;
+    auto terminal = m_terminal;
+
+    // clang-format off
+    linear &= checkScaling("Console::append", input, chunks, sizes,
+                           [&](const QString &text) {
+        console->append(text);
+    });
+    linear &= checkScaling("TerminalWidget::vt100Processing", input, chunks, sizes,
+                           [&](const QString &text) {
+        terminal->vt100Processing(text);
+    });
+    linear &= checkScaling("TerminalWidget::insertText", input, chunks, sizes,
+                           [&](const QString &text) {
+        terminal->addText(text, true);
+    });
+    // clang-format on
+
+    return linear;
+}
+
+/**
+ * Feeds each input in @a chunks to @a function, measures the fastest iteration for
+ * each input size & fits the time/size relation with a least squares regression in
+ * log-log space. The slope of the fitted line is the exponent of the time complexity,
+ * which must be close to 1 for linear functions.
+ *
+ * Measurements & the fitted exponent are registered in the report.
+ *
+ * @returns @c false if the function does not scale linearly
+ */
+template<typename Function>
+bool FuzzBenchmark::checkScaling(const QString &name, const QString &input,
+                                 const QList<QStringList> &chunks,
+                                 const QList<int> &sizes, Function function)
+{
+    QList<double> x;
+    QList<double> y;
+    bool aborted = false;
+
+    for (int i = 0; i < sizes.count() && !aborted; ++i)
+    {
+        qint64 nsecs = 0;
+        qint64 fastest = 0;
+        qint64 iterations = 0;
+
+        QElapsedTimer timer;
+        while (iterations == 0 || (nsecs < MIN_NSECS && iterations < MAX_ITERATIONS))
+        {
+            // Reset console & terminal state (not measured)
+            m_console->clear();
+            m_terminal->clear();
+            m_terminal->m_terminalState = UI::TerminalWidget::VT100_Text;
+
+            // Feed all chunks
+            timer.start();
+            foreach (const auto &chunk, chunks.at(i))
+                function(chunk);
+
+            // Update statistics
+            auto elapsed = timer.nsecsElapsed();
+            if (iterations == 0 || elapsed < fastest)
+                fastest = elapsed;
+
+            nsecs += elapsed;
+            ++iterations;
+
+            // Function is way too slow, do not try larger inputs
+            if (elapsed > MAX_NSECS)
+                aborted = true;
+        }
+
+        // Register results
+        const double mbPerSecond
+            = (sizes.at(i) / (1024.0 * 1024.0)) / (qMax<qint64>(1, fastest) * 1e-9);
+        QJsonObject result;
+        result.insert("function", name);
+        result.insert("input", input);
+        result.insert("bytes", sizes.at(i));
+        result.insert("iterations", iterations);
+        result.insert("nsPerIteration", static_cast<double>(fastest));
+        result.insert("mbPerSecond", mbPerSecond);
+        m_report.add(result);
+
+        // Register point for regression
+        x.append(std::log(static_cast<double>(sizes.at(i))));
+        y.append(std::log(static_cast<double>(qMax<qint64>(1, fastest))));
+    }
+
+    // Least squares fit of log(time) = exponent * log(size) + c
+    double exponent = 0;
+    const int n = x.count();
+    if (n >= 2)
+    {
+        double sx = 0, sy = 0, sxx = 0, sxy = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            sx += x.at(i);
+            sy += y.at(i);
+            sxx += x.at(i) * x.at(i);
+            sxy += x.at(i) * y.at(i);
+        }
+
+        exponent = (n * sxy - sx * sy) / (n * sxx - sx * sx);
+    }
+
+    // Register scaling result
+    const bool linear = !aborted && exponent <= MAX_EXPONENT;
+    QJsonObject scaling;
+    scaling.insert("function", name);
+    scaling.insert("input", input);
+    scaling.insert("exponent", exponent);
+    scaling.insert("linear", linear);
+    m_report.add(scaling);
+
+    // Log results
+    if (linear)
+        qDebug() << qPrintable(name) << qPrintable(input) << "exponent:" << exponent;
+    else
+        qWarning() << qPrintable(name) << qPrintable(input) << "exponent:" << exponent
+                   << "(superlinear)";
+
+    return linear;
+}
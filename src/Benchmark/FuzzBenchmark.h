@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef BENCHMARK_FUZZ_BENCHMARK_H
+#define BENCHMARK_FUZZ_BENCHMARK_H
+
+#include <QString>
+#include <QStringList>
+#include <Benchmark/Report.h>
+
+namespace UI
+{
+class TerminalWidget;
+}
+
+namespace Serial
+{
+class Console;
+}
+
+namespace Benchmark
+{
+/**
+ * Throughput fuzz harness for the text processing functions of the console & the
+ * terminal widget (@c Console::append() & @c TerminalWidget::vt100Processing()).
+ *
+ * Random & adversarial inputs (escape floods, carriage return storms, giant lines,
+ * invalid UTF-8 & random binary data) are fed in 4 KB chunks, as if they were received
+ * from a serial port, with sizes growing by a factor of 4. The processing time of each
+ * function/input combination is fitted against the input size, the benchmark fails if
+ * the time grows faster than linearly.
+ */
+class FuzzBenchmark
+{
+public:
+    FuzzBenchmark(const qint64 maxSize = 4 * 1024 * 1024);
+    ~FuzzBenchmark();
+
+    int exec(const QString &output);
+
+private:
+    QStringList split(const QByteArray &data) const;
+    bool benchmarkInput(const QString &input, QByteArray (*generator)(const int));
+
+    template<typename Function>
+    bool checkScaling(const QString &name, const QString &input,
+                      const QList<QStringList> &chunks, const QList<int> &sizes,
+                      Function function);
+
+private:
+    qint64 m_maxSize;
+    Report m_report;
+    Serial::Console *m_console;
+    UI::TerminalWidget *m_terminal;
+};
+}
+
+#endif
@@ -0,0 +1,425 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Decoder/Nmea.h>
+#include <Decoder/ModbusRtu.h>
+#include <Benchmark/Generators.h>
+
+/**
+ * Seed used by all the generators, changing it invalidates previous benchmark results
+ */
+static const quint32 SEED = 0x2545F491;
+
+/**
+ * Returns the next value of the given xorshift32 @a state
+ */
+static inline quint32 NextRandom(quint32 &state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+/**
+ * Generates @a size bytes of printable ASCII text, split in lines of 20 to 100
+ * characters terminated with a "\r\n" sequence (as most MCUs do).
+ */
+QByteArray Benchmark::Generators::ascii(const int size)
+{
+    QByteArray data;
+    data.reserve(size);
+
+    quint32 state = SEED;
+    while (data.size() < size)
+    {
+        auto length = 20 + NextRandom(state) % 80;
+        for (quint32 i = 0; i < length && data.size() < size; ++i)
+            data.append(static_cast<char>(' ' + NextRandom(state) % 95));
+
+        data.append("\r\n");
+    }
+
+    data.truncate(size);
+    return data;
+}
+
+/**
+ * Generates @a size bytes of valid UTF-8 text, mixing ASCII characters with 2-byte,
+ * 3-byte & 4-byte sequences and "\n" line breaks. The data never ends with a partial
+ * UTF-8 sequence.
+ */
+QByteArray Benchmark::Generators::utf8(const int size)
+{
+    // clang-format off
+    static const char *SEQUENCES[] = {
+        "\xC3\xA9",         // LATIN SMALL LETTER E WITH ACUTE
+        "\xCE\xA9",         // GREEK CAPITAL LETTER OMEGA
+        "\xE4\xB8\xAD",     // CJK UNIFIED IDEOGRAPH-4E2D
+        "\xE2\x82\xAC",     // EURO SIGN
+        "\xF0\x9F\x98\x80", // GRINNING FACE
+        "\xF0\x9F\x9B\xB0"  // SATELLITE
+    };
+    // clang-format on
+
+    QByteArray data;
+    data.reserve(size + 4);
+
+    quint32 state = SEED;
+    while (data.size() < size)
+    {
+        auto value = NextRandom(state) % 100;
+        QByteArray token;
+        if (value < 60)
+            token.append(static_cast<char>('a' + value % 26));
+        else if (value < 95)
+            token.append(SEQUENCES[value % 6]);
+        else
+            token.append('\n');
+
+        if (data.size() + token.size() > size)
+            break;
+
+        data.append(token);
+    }
+
+    // Pad with ASCII to obtain the exact size
+    while (data.size() < size)
+        data.append('x');
+
+    return data;
+}
+
+/**
+ * Generates @a size bytes of uniformly distributed random data
+ */
+QByteArray Benchmark::Generators::binary(const int size)
+{
+    QByteArray data(size, '\0');
+
+    quint32 state = SEED;
+    for (int i = 0; i < size; ++i)
+        data[i] = static_cast<char>(NextRandom(state) & 0xFF);
+
+    return data;
+}
+
+/**
+ * Generates a single line of @a size printable ASCII characters, without any line
+ * break sequence.
+ */
+QByteArray Benchmark::Generators::longLine(const int size)
+{
+    QByteArray data(size, '\0');
+
+    quint32 state = SEED;
+    for (int i = 0; i < size; ++i)
+        data[i] = static_cast<char>(' ' + NextRandom(state) % 95);
+
+    return data;
+}
+
+/**
+ * Generates @a size bytes of invalid UTF-8 data: lone continuation bytes, truncated
+ * multi-byte sequences, overlong encodings, encoded surrogates & bytes that never
+ * appear in UTF-8, mixed with ASCII text and line breaks.
+ */
+QByteArray Benchmark::Generators::invalidUtf8(const int size)
+{
+    // clang-format off
+    static const char *SEQUENCES[] = {
+        "\x80",             // Lone continuation byte
+        "\xBF\xBF",         // Continuation bytes without lead byte
+        "\xC3",             // Truncated 2-byte sequence
+        "\xE2\x82",         // Truncated 3-byte sequence
+        "\xF0\x9F\x98",     // Truncated 4-byte sequence
+        "\xC0\x80",         // Overlong NUL
+        "\xE0\x80\xAF",     // Overlong '/'
+        "\xED\xA0\x80",     // Encoded surrogate
+        "\xF4\x90\x80\x80", // Code point above U+10FFFF
+        "\xFE\xFF"          // Bytes that never appear in UTF-8
+    };
+    // clang-format on
+
+    QByteArray data;
+    data.reserve(size + 4);
+
+    quint32 state = SEED;
+    while (data.size() < size)
+    {
+        auto value = NextRandom(state) % 100;
+        if (value < 50)
+            data.append(SEQUENCES[value % 10]);
+        else if (value < 95)
+            data.append(static_cast<char>('a' + value % 26));
+        else
+            data.append('\n');
+    }
+
+    data.truncate(size);
+    return data;
+}
+
+/**
+ * Generates @a size bytes of VT-100 escape sequences with very little text between
+ * them: clear line commands, color & cursor commands that are ignored by the terminal,
+ * unterminated sequences & bare escape characters.
+ */
+QByteArray Benchmark::Generators::escapeFlood(const int size)
+{
+    // clang-format off
+    static const char *SEQUENCES[] = {
+        "\x1B[2K",          // Clear line
+        "\x1B[31m",         // Set foreground color
+        "\x1B[1;32m",       // Set bold & foreground color
+        "\x1B[0m",          // Reset attributes
+        "\x1B[10A",         // Move cursor up
+        "\x1B(B",           // Select character set
+        "\x1B[",            // Unterminated command
+        "\x1B",             // Bare escape character
+        "ok\n",             // Short line
+        "\x1B[2K\rline\r"   // Progress-bar style update
+    };
+    // clang-format on
+
+    QByteArray data;
+    data.reserve(size + 16);
+
+    quint32 state = SEED;
+    while (data.size() < size)
+        data.append(SEQUENCES[NextRandom(state) % 10]);
+
+    data.truncate(size);
+    return data;
+}
+
+/**
+ * Generates @a size bytes of carriage return storms: long runs of "\r", "\r\n"
+ * sequences & progress-bar style lines that are rewritten with "\r".
+ */
+QByteArray Benchmark::Generators::carriageReturns(const int size)
+{
+    QByteArray data;
+    data.reserve(size + 128);
+
+    quint32 state = SEED;
+    while (data.size() < size)
+    {
+        auto value = NextRandom(state) % 3;
+        if (value == 0)
+            data.append(QByteArray(1 + NextRandom(state) % 64, '\r'));
+        else if (value == 1)
+            data.append("\r\n\r\n\r\r\n");
+        else
+            data.append(QByteArray("progress: ") + QByteArray::number(NextRandom(state) % 100)
+                        + "%\r");
+    }
+
+    data.truncate(size);
+    return data;
+}
+
+/**
+ * Generates @a size bytes of CSV telemetry lines (as printed by most firmware), each
+ * line has @a channels comma-separated values with up to 3 decimals, negative values &
+ * occasional exponents, terminated with a "\r\n" sequence.
+ */
+QByteArray Benchmark::Generators::telemetry(const int size, const int channels)
+{
+    QByteArray data;
+    data.reserve(size + 1024);
+
+    quint32 state = SEED;
+    while (data.size() < size)
+    {
+        for (int i = 0; i < channels; ++i)
+        {
+            if (i > 0)
+                data.append(',');
+
+            auto value = static_cast<int>(NextRandom(state) % 2000000) - 1000000;
+            if (NextRandom(state) % 50 == 0)
+                data.append(QByteArray::number(value / 1000.0, 'e', 3));
+            else
+                data.append(QByteArray::number(value / 1000.0, 'f', 3));
+        }
+
+        data.append("\r\n");
+    }
+
+    // Only keep complete lines
+    data.truncate(data.lastIndexOf('\n', size - 1) + 1);
+    return data;
+}
+
+/**
+ * Appends the given Modbus RTU frame (address, function code & payload) to @a data,
+ * followed by its CRC-16
+ */
+static void AppendModbusFrame(QByteArray &data, const QByteArray &frame)
+{
+    const quint16 crc = Decoder::ModbusRtu::crc16(frame.constData(), frame.size());
+    data.append(frame);
+    data.append(static_cast<char>(crc & 0xFF));
+    data.append(static_cast<char>(crc >> 8));
+}
+
+/**
+ * Generates @a size bytes of back-to-back Modbus RTU traffic (without silent
+ * intervals): "read holding registers" requests & responses of 1 to 60 registers,
+ * "write multiple registers" requests & responses and exception responses.
+ */
+QByteArray Benchmark::Generators::modbusRtu(const int size)
+{
+    QByteArray data;
+    data.reserve(size + 1024);
+
+    quint32 state = SEED;
+    while (data.size() < size)
+    {
+        const char address = static_cast<char>(1 + NextRandom(state) % 247);
+        const int count = 1 + static_cast<int>(NextRandom(state) % 60);
+        const char start = static_cast<char>(NextRandom(state));
+
+        // Read holding registers
+        QByteArray request;
+        request.append(address).append('\x03').append('\0').append(start);
+        request.append('\0').append(static_cast<char>(count));
+        AppendModbusFrame(data, request);
+
+        QByteArray response;
+        response.append(address).append('\x03').append(static_cast<char>(count * 2));
+        for (int i = 0; i < count * 2; ++i)
+            response.append(static_cast<char>(NextRandom(state)));
+        AppendModbusFrame(data, response);
+
+        // Write multiple registers
+        QByteArray write;
+        write.append(address).append('\x10').append('\0').append(start);
+        write.append('\0').append('\x02').append('\x04');
+        for (int i = 0; i < 4; ++i)
+            write.append(static_cast<char>(NextRandom(state)));
+        AppendModbusFrame(data, write);
+        AppendModbusFrame(data, write.left(6));
+
+        // Exception response (illegal data address)
+        if (NextRandom(state) % 10 == 0)
+        {
+            QByteArray exception;
+            exception.append(address).append('\x83').append('\x02');
+            AppendModbusFrame(data, exception);
+        }
+    }
+
+    return data;
+}
+
+/**
+ * Appends the given NMEA-0183 sentence @a body (the characters between the '$' & the
+ * '*') to @a data, with its start delimiter, checksum & line ending
+ */
+static void AppendNmeaSentence(QByteArray &data, const char *body, const int length)
+{
+    char checksum[8];
+    qsnprintf(checksum, sizeof(checksum), "*%02X\r\n",
+              Decoder::Nmea::checksum(body, body + length));
+
+    data.append('$');
+    data.append(body, length);
+    data.append(checksum);
+}
+
+/**
+ * Generates @a size bytes of NMEA-0183 traffic as transmitted by a GNSS receiver: each
+ * epoch contains GGA, RMC, GSA, VTG & three GSV sentences (twelve satellites), the
+ * position follows a random walk.
+ */
+QByteArray Benchmark::Generators::nmea(const int size)
+{
+    QByteArray data;
+    data.reserve(size + 1024);
+
+    int epoch = 0;
+    char body[128];
+    double latitude = 4807.038;
+    double longitude = 1131.000;
+    quint32 state = SEED;
+    while (data.size() < size)
+    {
+        // Advance time (10 Hz) & position
+        const double time = 120000 + (epoch % 36000) / 10.0;
+        latitude += (static_cast<int>(NextRandom(state) % 201) - 100) * 1e-5;
+        longitude += (static_cast<int>(NextRandom(state) % 201) - 100) * 1e-5;
+        const double speed = (NextRandom(state) % 1000) / 10.0;
+        const double course = (NextRandom(state) % 3600) / 10.0;
+        const int satellites = 8 + static_cast<int>(NextRandom(state) % 5);
+        ++epoch;
+
+        // Position & fix
+        int length = qsnprintf(body, sizeof(body),
+                               "GPGGA,%09.2f,%09.4f,N,%010.4f,E,1,%02d,0.9,545.4,M,"
+                               "46.9,M,,",
+                               time, latitude, longitude, satellites);
+        AppendNmeaSentence(data, body, length);
+
+        length = qsnprintf(body, sizeof(body),
+                           "GPRMC,%09.2f,A,%09.4f,N,%010.4f,E,%05.1f,%05.1f,230394,"
+                           "003.1,W,A",
+                           time, latitude, longitude, speed, course);
+        AppendNmeaSentence(data, body, length);
+
+        length = qsnprintf(body, sizeof(body),
+                           "GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1");
+        AppendNmeaSentence(data, body, length);
+
+        length = qsnprintf(body, sizeof(body), "GPVTG,%05.1f,T,,M,%05.1f,N,%05.1f,K,A",
+                           course, speed, speed * 1.852);
+        AppendNmeaSentence(data, body, length);
+
+        // Satellites in view
+        for (int message = 0; message < 3; ++message)
+        {
+            length = qsnprintf(body, sizeof(body), "GPGSV,3,%d,12", message + 1);
+            for (int i = 0; i < 4; ++i)
+            {
+                length += qsnprintf(body + length, sizeof(body) - length,
+                                    ",%02d,%02d,%03d,%02d", message * 4 + i + 1,
+                                    static_cast<int>(NextRandom(state) % 90),
+                                    static_cast<int>(NextRandom(state) % 360),
+                                    static_cast<int>(20 + NextRandom(state) % 30));
+            }
+
+            AppendNmeaSentence(data, body, length);
+        }
+    }
+
+    return data;
+}
+
+/**
+ * Generates an hexadecimal string (such as the ones typed by the user in the send
+ * text field) of approximately @a size characters, bytes are separated with a space.
+ */
+QString Benchmark::Generators::hexString(const int size)
+{
+    return QString::fromLatin1(binary(qMax(1, size / 3)).toHex(' ').toUpper());
+}
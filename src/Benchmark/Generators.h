@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef BENCHMARK_GENERATORS_H
+#define BENCHMARK_GENERATORS_H
+
+#include <QString>
+#include <QByteArray>
+
+namespace Benchmark
+{
+/**
+ * Synthetic input generators used by the benchmark suites. All generators are
+ * deterministic (fixed seed), so that results obtained with different builds can be
+ * compared against each other.
+ */
+namespace Generators
+{
+QByteArray ascii(const int size);
+QByteArray utf8(const int size);
+QByteArray binary(const int size);
+QByteArray longLine(const int size);
+QByteArray invalidUtf8(const int size);
+QByteArray escapeFlood(const int size);
+QByteArray carriageReturns(const int size);
+QByteArray telemetry(const int size, const int channels);
+QByteArray nmea(const int size);
+QByteArray modbusRtu(const int size);
+QString hexString(const int size);
+}
+}
+
+#endif
@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cmath>
+#include <string.h>
+
+#include <QDebug>
+#include <QElapsedTimer>
+
+#include <Plot/Dataset.h>
+#include <Plot/Pyramid.h>
+#include <Plot/FieldParser.h>
+#include <Plot/FieldStatistics.h>
+#include <Benchmark/Generators.h>
+#include <Benchmark/PlotBenchmark.h>
+
+using namespace Benchmark;
+
+/**
+ * Minimum time spent measuring each function/input combination
+ */
+static const qint64 MIN_NSECS = 250 * 1000 * 1000;
+
+/**
+ * Maximum number of iterations for each function/input combination
+ */
+static const qint64 MAX_ITERATIONS = 100000;
+
+/**
+ * Width (in pixel columns) of the frames queried from the pyramid
+ */
+static const int FRAME_COLUMNS = 1920;
+
+/**
+ * Constructor function, @a maxSize is the size of the largest generated input
+ */
+PlotBenchmark::PlotBenchmark(const qint64 maxSize)
+    : m_maxSize(qBound<qint64>(1024, maxSize, 100 * 1024 * 1024))
+    , m_report("plot")
+{
+}
+
+/**
+ * Runs all the benchmarks and writes the report to the given @a output file (or to the
+ * standard output if @a output is empty).
+ *
+ * @returns the exit code of the application
+ */
+int PlotBenchmark::exec(const QString &output)
+{
+    // Check statistics windows that start before the application did
+    if (!checkFieldStatistics())
+        return EXIT_FAILURE;
+
+    // Run benchmarks for 1 KB, 10 KB, 100 KB, 1 MB, 10 MB & 100 MB inputs
+    for (qint64 size = 1024; size <= m_maxSize; size *= 10)
+    {
+        const int bytes = static_cast<int>(size);
+        benchmarkParse(Generators::telemetry(bytes, 1), 1);
+        benchmarkParse(Generators::telemetry(bytes, 10), 10);
+        benchmarkParse(Generators::telemetry(bytes, 50), 50);
+    }
+
+    // Run pyramid benchmarks for 1M, 10M & 100M samples
+    for (qint64 samples = 1000 * 1000; samples <= m_maxSize; samples *= 10)
+        benchmarkPyramid(samples);
+
+    // Restore dataset state
+    Plot::Dataset::getInstance()->clear();
+    Plot::Dataset::getInstance()->setEnabled(false);
+
+    // Write report
+    return m_report.write(output) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * Merges the statistics window of a field that received samples during the first two
+ * seconds after startup (when the window reaches before the first timestamp) and
+ * compares the result with the expected values.
+ *
+ * @returns @c true if the window summaries are correct
+ */
+bool PlotBenchmark::checkFieldStatistics()
+{
+    using Plot::FieldStatistics;
+
+    // Ring of empty one-second summaries
+    FieldStatistics::Accumulator accumulator;
+    FieldStatistics::resetBucket(accumulator.total, -1);
+    accumulator.ring = QVector<FieldStatistics::Bucket>(FieldStatistics::MaxWindow,
+                                                        accumulator.total);
+
+    // Samples received during the first & second seconds
+    FieldStatistics::resetBucket(accumulator.ring[0], 0);
+    FieldStatistics::addValue(accumulator.ring[0], 1);
+    FieldStatistics::addValue(accumulator.ring[0], 2);
+    FieldStatistics::addValue(accumulator.ring[0], 3);
+    FieldStatistics::resetBucket(accumulator.ring[1], 1);
+    FieldStatistics::addValue(accumulator.ring[1], 6);
+
+    // Publish during the first & second seconds with the longest window
+    const int window = FieldStatistics::MaxWindow;
+    const auto first = FieldStatistics::windowSummary(accumulator, 0, window);
+    const auto second = FieldStatistics::windowSummary(accumulator, 1, window);
+    const bool passed = first.count == 3 && first.mean == 2 && first.min == 1
+                        && first.max == 3 && second.count == 4 && second.mean == 3
+                        && second.min == 1 && second.max == 6;
+
+    // Register results
+    QJsonObject result;
+    result.insert("function", "FieldStatistics::windowSummary");
+    result.insert("window", window);
+    result.insert("passed", passed);
+    m_report.add(result);
+    if (!passed)
+        qWarning() << "FieldStatistics::windowSummary: wrong summary after startup";
+
+    return passed;
+}
+
+/**
+ * Measures the time needed to extract the numeric fields of the given CSV @a data
+ */
+void PlotBenchmark::benchmarkParse(const QByteArray &data, const int channels)
+{
+    // Split lines & parse fields without allocating memory
+    measure("FieldParser::parseLine", channels, data, [&]() {
+        double values[Plot::Dataset::MaxChannels];
+        const char *cursor = data.constData();
+        const char *end = cursor + data.size();
+        const char *lineEnd;
+        qint64 fields = 0;
+        while ((lineEnd = static_cast<const char *>(memchr(cursor, '\n', end - cursor))))
+        {
+            fields += Plot::FieldParser::parseLine(cursor, lineEnd, values,
+                                                   Plot::Dataset::MaxChannels);
+            cursor = lineEnd + 1;
+        }
+
+        return fields;
+    });
+
+    // Reference implementation with QString functions
+    measure("QString::split", channels, data, [&]() {
+        double sum = 0;
+        auto lines = QString::fromUtf8(data).split('\n', QString::SkipEmptyParts);
+        foreach (auto line, lines)
+        {
+            foreach (auto field, line.trimmed().split(','))
+                sum += field.toDouble();
+        }
+
+        return sum;
+    });
+
+    // Parse stage of the plot (including channel storage)
+    auto dataset = Plot::Dataset::getInstance();
+    dataset->setEnabled(true);
+    measure("Dataset::append", channels, data, [&]() {
+        dataset->clear();
+        dataset->append(data);
+        return dataset->sampleCount();
+    });
+}
+
+/**
+ * Fills a pyramid with the given number of @a samples & measures the append throughput
+ * and the time needed to obtain the min/max columns of a frame at different zoom levels
+ */
+void PlotBenchmark::benchmarkPyramid(const qint64 samples)
+{
+    // Fill pyramid with a noisy sine wave
+    QElapsedTimer timer;
+    Plot::Pyramid pyramid;
+    timer.start();
+    for (qint64 i = 0; i < samples; ++i)
+        pyramid.append(static_cast<float>(std::sin(i * 0.001) + (i % 7) * 0.01));
+
+    const qint64 appendNsecs = timer.nsecsElapsed();
+
+    // Register append results
+    QJsonObject append;
+    append.insert("function", "Pyramid::append");
+    append.insert("samples", samples);
+    append.insert("bytes", pyramid.memoryUsage());
+    append.insert("nsPerSample", static_cast<double>(appendNsecs) / samples);
+    append.insert("samplesPerSecond", samples / (appendNsecs * 1e-9));
+    m_report.add(append);
+    qDebug() << "Pyramid::append" << samples << "samples:"
+             << samples / (appendNsecs * 1e-9) << "samples/s";
+
+    // Query frames of the whole history, 1% of the history & 2 samples per column
+    QVector<float> min(FRAME_COLUMNS);
+    QVector<float> max(FRAME_COLUMNS);
+    const qint64 windows[] = { samples, samples / 100, FRAME_COLUMNS * 2 };
+    for (const qint64 window : windows)
+    {
+        // Pan the window through the history
+        qint64 frames = 0;
+        timer.start();
+        while (frames == 0 || timer.nsecsElapsed() < MIN_NSECS)
+        {
+            const qint64 last = samples - (frames * 7919) % (samples - window + 1);
+            pyramid.columns(last - window, last, FRAME_COLUMNS, min.data(), max.data());
+            ++frames;
+        }
+
+        // Register results
+        const double nsPerFrame = static_cast<double>(timer.nsecsElapsed()) / frames;
+        QJsonObject result;
+        result.insert("function", "Pyramid::columns");
+        result.insert("samples", samples);
+        result.insert("visibleSamples", window);
+        result.insert("columns", FRAME_COLUMNS);
+        result.insert("iterations", frames);
+        result.insert("nsPerFrame", nsPerFrame);
+        result.insert("framesPerSecond", 1e9 / nsPerFrame);
+        m_report.add(result);
+        qDebug() << "Pyramid::columns" << samples << "samples" << window
+                 << "visible:" << nsPerFrame / 1000 << "us/frame";
+    }
+}
+
+/**
+ * Calls @a function repeatedly until at least @c MIN_NSECS have been spent executing it
+ * and registers the results (throughput in MB/s & lines per second) in the report.
+ */
+template<typename Function>
+void PlotBenchmark::measure(const QString &name, const int channels,
+                            const QByteArray &data, Function function)
+{
+    qint64 nsecs = 0;
+    qint64 iterations = 0;
+
+    QElapsedTimer timer;
+    while (iterations == 0 || (nsecs < MIN_NSECS && iterations < MAX_ITERATIONS))
+    {
+        timer.start();
+        auto result = function();
+        nsecs += timer.nsecsElapsed();
+
+        Q_UNUSED(result);
+        ++iterations;
+    }
+
+    // Calculate average time & throughput
+    const int size = data.size();
+    const int lines = data.count('\n');
+    const double nsPerIteration = static_cast<double>(nsecs) / iterations;
+    const double mbPerSecond = (size / (1024.0 * 1024.0)) / (nsPerIteration * 1e-9);
+    const double linesPerSecond = lines / (nsPerIteration * 1e-9);
+
+    // Register results
+    QJsonObject result;
+    result.insert("function", name);
+    result.insert("channels", channels);
+    result.insert("bytes", size);
+    result.insert("lines", lines);
+    result.insert("iterations", iterations);
+    result.insert("nsPerIteration", nsPerIteration);
+    result.insert("mbPerSecond", mbPerSecond);
+    result.insert("linesPerSecond", linesPerSecond);
+    m_report.add(result);
+
+    // Log progress
+    qDebug() << qPrintable(name) << channels << "channels" << size << "bytes:"
+             << mbPerSecond << "MB/s" << linesPerSecond << "lines/s";
+}
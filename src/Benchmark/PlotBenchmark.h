@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef BENCHMARK_PLOT_BENCHMARK_H
+#define BENCHMARK_PLOT_BENCHMARK_H
+
+#include <QString>
+#include <Benchmark/Report.h>
+
+namespace Benchmark
+{
+/**
+ * Micro-benchmarks for the plot pipeline: numeric field extraction (compared with the
+ * naive @c QString::split() / @c QString::toDouble() approach) & the parse stage of
+ * @c Plot::Dataset, fed with CSV telemetry of 1, 10 & 50 channels.
+ *
+ * The min/max pyramid is measured separately: append throughput & the time needed to
+ * obtain the columns of a 1920 pixel wide frame when zoomed out to the whole history
+ * & when zoomed in, for histories of up to 100M samples.
+ *
+ * Before the benchmarks run, the windowed statistics of @c Plot::FieldStatistics are
+ * checked during the first seconds after startup (the run fails if they are wrong).
+ */
+class PlotBenchmark
+{
+public:
+    PlotBenchmark(const qint64 maxSize = 100 * 1024 * 1024);
+    int exec(const QString &output);
+
+private:
+    bool checkFieldStatistics();
+    void benchmarkParse(const QByteArray &data, const int channels);
+    void benchmarkPyramid(const qint64 samples);
+
+    template<typename Function>
+    void measure(const QString &name, const int channels, const QByteArray &data,
+                 Function function);
+
+private:
+    qint64 m_maxSize;
+    Report m_report;
+};
+}
+
+#endif
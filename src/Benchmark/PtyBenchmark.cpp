@@ -0,0 +1,375 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <termios.h>
+
+#include <chrono>
+#include <algorithm>
+
+#include <QTimer>
+#include <QDebug>
+#include <QEventLoop>
+#include <QCoreApplication>
+
+#include <Serial/Console.h>
+#include <Serial/Manager.h>
+#include <UI/TerminalWidget.h>
+#include <Benchmark/PtyBenchmark.h>
+
+using namespace Benchmark;
+
+/**
+ * Size of each record (including the trailing line break)
+ */
+static const int RECORD_SIZE = 64;
+
+/**
+ * Number of records generated with each write() call
+ */
+static const int RECORDS_PER_WRITE = 64;
+
+/**
+ * Length of the "<sequence> <timestamp> " header of each record
+ */
+static const int HEADER_SIZE = 34;
+
+/**
+ * Returns the given @a percentile (0-1) of the sorted list of @a values
+ */
+static qint64 Percentile(const QVector<qint64> &values, const double percentile)
+{
+    if (values.isEmpty())
+        return 0;
+
+    auto index = static_cast<int>(percentile * (values.count() - 1));
+    return values.at(qBound(0, index, values.count() - 1));
+}
+
+/**
+ * Constructor function, @a rate is the number of bytes per second to write to the
+ * pseudo-terminal (0 to write as fast as possible) & @a duration is the measurement
+ * time in seconds.
+ */
+PtyBenchmark::PtyBenchmark(const qint64 rate, const int duration, QObject *parent)
+    : QObject(parent)
+    , m_rate(qMax<qint64>(0, rate))
+    , m_duration(qMax(1, duration))
+    , m_master(-1)
+    , m_stop(false)
+    , m_writerFinished(false)
+    , m_bytesWritten(0)
+    , m_bytesRead(0)
+    , m_bytesDisplayed(0)
+    , m_nextSequence(0)
+    , m_droppedRecords(0)
+    , m_corruptRecords(0)
+    , m_report("pty")
+    , m_terminal(nullptr)
+{
+    m_clock.start();
+}
+
+/**
+ * Destructor function, stops the writer thread & closes the pseudo-terminal
+ */
+PtyBenchmark::~PtyBenchmark()
+{
+    m_stop = true;
+    if (m_writer.joinable())
+        m_writer.join();
+
+    if (m_master >= 0)
+        ::close(m_master);
+
+    delete m_terminal;
+}
+
+/**
+ * Runs the benchmark and writes the report to the given @a output file (or to the
+ * standard output if @a output is empty).
+ *
+ * @returns the exit code of the application
+ */
+int PtyBenchmark::exec(const QString &output)
+{
+    // Open pseudo-terminal pair
+    if (!openPty())
+    {
+        qWarning() << "Cannot open pseudo-terminal:" << strerror(errno);
+        return EXIT_FAILURE;
+    }
+
+    // Create terminal widget with the same configuration as the QML interface
+    m_terminal = new UI::TerminalWidget;
+    m_terminal->setSize(QSizeF(800, 600));
+    m_terminal->setMaximumBlockCount(12000);
+    m_terminal->setWordWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
+
+    // Connect probes, the console probe is connected after the terminal widget, so it
+    // is called once the text has been inserted in the text document.
+    auto manager = Serial::Manager::getInstance();
+    auto console = Serial::Console::getInstance();
+    connect(manager, &Serial::Manager::dataReceived, this, &PtyBenchmark::onDataReceived);
+    connect(console, &Serial::Console::stringReceived, this,
+            &PtyBenchmark::onStringReceived);
+
+    // Connect to slave side of the pseudo-terminal
+    manager->connectToPort(m_slaveName);
+    if (!manager->connected())
+    {
+        qWarning() << "Cannot open" << m_slaveName;
+        return EXIT_FAILURE;
+    }
+
+    // Start writing records & measure during the given time
+    QElapsedTimer timer;
+    QEventLoop loop;
+    timer.start();
+    m_writer = std::thread(&PtyBenchmark::writeRecords, this);
+    QTimer::singleShot(m_duration * 1000, &loop, &QEventLoop::quit);
+    loop.exec();
+
+    // Get measurement results
+    const double seconds = timer.nsecsElapsed() * 1e-9;
+    const qint64 bytesWritten = m_bytesWritten;
+    const qint64 bytesRead = m_bytesRead;
+    const qint64 bytesDisplayed = m_bytesDisplayed;
+
+    // Stop the writer, we must keep reading the pseudo-terminal until the writer
+    // thread exits, otherwise it could be blocked forever in a write() call
+    m_stop = true;
+    while (!m_writerFinished)
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    m_writer.join();
+    manager->disconnectDevice();
+
+    // Calculate latency percentiles
+    std::sort(m_latencies.begin(), m_latencies.end());
+    QJsonObject latency;
+    latency.insert("samples", m_latencies.count());
+    latency.insert("p50", Percentile(m_latencies, 0.5) / 1000.0);
+    latency.insert("p90", Percentile(m_latencies, 0.9) / 1000.0);
+    latency.insert("p99", Percentile(m_latencies, 0.99) / 1000.0);
+    latency.insert("p999", Percentile(m_latencies, 0.999) / 1000.0);
+    latency.insert("max", Percentile(m_latencies, 1) / 1000.0);
+
+    // Calculate throughput of each stage
+    const double mb = 1024.0 * 1024.0;
+    const double writeRate = bytesWritten / mb / seconds;
+    const double readRate = bytesRead / mb / seconds;
+    const double displayRate = bytesDisplayed / mb / seconds;
+
+    // Register results
+    QJsonObject result;
+    result.insert("targetBytesPerSecond", m_rate);
+    result.insert("seconds", seconds);
+    result.insert("bytesWritten", bytesWritten);
+    result.insert("bytesRead", bytesRead);
+    result.insert("bytesDisplayed", bytesDisplayed);
+    result.insert("backlogBytes", bytesWritten - bytesDisplayed);
+    result.insert("writeMBps", writeRate);
+    result.insert("readMBps", readRate);
+    result.insert("displayMBps", displayRate);
+    result.insert("recordsDisplayed", m_latencies.count());
+    result.insert("droppedRecords", m_droppedRecords);
+    result.insert("corruptRecords", m_corruptRecords);
+    result.insert("latencyUs", latency);
+    if (m_rate > 0)
+        result.insert("keepsUp", bytesWritten >= 0.95 * m_rate * seconds);
+    m_report.add(result);
+
+    // Log results
+    qDebug() << "Pipeline throughput:" << displayRate << "MB/s, p99 latency:"
+             << Percentile(m_latencies, 0.99) / 1000 << "us";
+
+    // Write report
+    return m_report.write(output) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * Counts the number of bytes read by the serial manager
+ */
+void PtyBenchmark::onDataReceived(const QByteArray &data)
+{
+    m_bytesRead += data.size();
+}
+
+/**
+ * Splits the @a text displayed by the terminal widget into records and measures the
+ * byte-to-screen latency of each record.
+ */
+void PtyBenchmark::onStringReceived(const QString &text)
+{
+    m_bytesDisplayed += text.length();
+
+    int start = 0;
+    int end = text.indexOf('\n');
+    while (end >= 0)
+    {
+        if (m_partialRecord.isEmpty())
+            processRecord(text.mid(start, end - start));
+        else
+        {
+            processRecord(m_partialRecord + text.mid(start, end - start));
+            m_partialRecord.clear();
+        }
+
+        start = end + 1;
+        end = text.indexOf('\n', start);
+    }
+
+    m_partialRecord.append(text.mid(start));
+}
+
+/**
+ * Opens the master side of a new pseudo-terminal pair and obtains the name of the slave
+ * side.
+ *
+ * @returns @c true on success
+ */
+bool PtyBenchmark::openPty()
+{
+    m_master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (m_master < 0)
+        return false;
+
+    if (grantpt(m_master) != 0 || unlockpt(m_master) != 0)
+        return false;
+
+    auto name = ptsname(m_master);
+    if (!name)
+        return false;
+
+    // Disable line discipline processing, so that data is transmitted as-is
+    struct termios tio;
+    if (tcgetattr(m_master, &tio) == 0)
+    {
+        cfmakeraw(&tio);
+        tcsetattr(m_master, TCSANOW, &tio);
+    }
+
+    m_slaveName = QString::fromLocal8Bit(name);
+    return true;
+}
+
+/**
+ * Writes records to the master side of the pseudo-terminal at the rate specified by the
+ * user until the benchmark is stopped. Each record contains its sequence number and the
+ * time at which it was written (in nanoseconds), followed by a fixed payload.
+ *
+ * @note This function runs in its own thread
+ */
+void PtyBenchmark::writeRecords()
+{
+    char record[RECORD_SIZE + 1];
+    char buffer[RECORD_SIZE * RECORDS_PER_WRITE];
+
+    qint64 sequence = 0;
+    const qint64 start = m_clock.nsecsElapsed();
+    while (!m_stop)
+    {
+        // Wait until we are allowed to write more data
+        if (m_rate > 0)
+        {
+            auto elapsed = m_clock.nsecsElapsed() - start;
+            auto allowed = static_cast<qint64>(elapsed * 1e-9 * m_rate);
+            if (m_bytesWritten >= allowed)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                continue;
+            }
+        }
+
+        // Generate records
+        const qint64 timestamp = m_clock.nsecsElapsed();
+        for (int i = 0; i < RECORDS_PER_WRITE; ++i)
+        {
+            snprintf(record, sizeof(record), "%016llx %016llx ",
+                     static_cast<unsigned long long>(sequence++),
+                     static_cast<unsigned long long>(timestamp));
+            memset(record + HEADER_SIZE, 'x', RECORD_SIZE - HEADER_SIZE - 1);
+            record[RECORD_SIZE - 1] = '\n';
+            memcpy(buffer + i * RECORD_SIZE, record, RECORD_SIZE);
+        }
+
+        // Write records to pseudo-terminal
+        const char *ptr = buffer;
+        size_t left = sizeof(buffer);
+        while (left > 0 && !m_stop)
+        {
+            auto ret = ::write(m_master, ptr, left);
+            if (ret < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                m_stop = true;
+                break;
+            }
+
+            ptr += ret;
+            left -= ret;
+            m_bytesWritten += ret;
+        }
+    }
+
+    m_writerFinished = true;
+}
+
+/**
+ * Decodes the given @a record and registers its latency. Gaps in the sequence numbers
+ * are counted as dropped records.
+ */
+void PtyBenchmark::processRecord(const QString &record)
+{
+    // Validate record length
+    const qint64 now = m_clock.nsecsElapsed();
+    if (record.length() != RECORD_SIZE - 1)
+    {
+        ++m_corruptRecords;
+        return;
+    }
+
+    // Decode sequence number & timestamp
+    bool seqOk, timeOk;
+    auto sequence = record.midRef(0, 16).toLongLong(&seqOk, 16);
+    auto timestamp = record.midRef(17, 16).toLongLong(&timeOk, 16);
+    if (!seqOk || !timeOk)
+    {
+        ++m_corruptRecords;
+        return;
+    }
+
+    // Count lost records
+    if (sequence > m_nextSequence)
+        m_droppedRecords += sequence - m_nextSequence;
+
+    // Register latency
+    m_nextSequence = sequence + 1;
+    m_latencies.append(now - timestamp);
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef BENCHMARK_PTY_BENCHMARK_H
+#define BENCHMARK_PTY_BENCHMARK_H
+
+#include <atomic>
+#include <thread>
+
+#include <QObject>
+#include <QVector>
+#include <QElapsedTimer>
+#include <Benchmark/Report.h>
+
+namespace UI
+{
+class TerminalWidget;
+}
+
+namespace Benchmark
+{
+/**
+ * End-to-end throughput & latency benchmark.
+ *
+ * Opens a pseudo-terminal pair, connects @c Serial::Manager to the slave side and writes
+ * timestamped, sequence-numbered records from the master side at a configurable rate.
+ * Records are decoded again after the text has been inserted in a @c UI::TerminalWidget,
+ * which allows us to measure the sustained throughput of each stage, the number of
+ * lost/corrupted records & the byte-to-screen latency of the whole pipeline.
+ */
+class PtyBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    PtyBenchmark(const qint64 rate, const int duration, QObject *parent = nullptr);
+    ~PtyBenchmark();
+
+    int exec(const QString &output);
+
+private slots:
+    void onDataReceived(const QByteArray &data);
+    void onStringReceived(const QString &text);
+
+private:
+    bool openPty();
+    void writeRecords();
+    void processRecord(const QString &record);
+
+private:
+    qint64 m_rate;
+    int m_duration;
+
+    int m_master;
+    QString m_slaveName;
+
+    std::thread m_writer;
+    std::atomic<bool> m_stop;
+    std::atomic<bool> m_writerFinished;
+    std::atomic<qint64> m_bytesWritten;
+
+    qint64 m_bytesRead;
+    qint64 m_bytesDisplayed;
+    qint64 m_nextSequence;
+    qint64 m_droppedRecords;
+    qint64 m_corruptRecords;
+
+    QString m_partialRecord;
+    QElapsedTimer m_clock;
+    QVector<qint64> m_latencies;
+
+    Report m_report;
+    UI::TerminalWidget *m_terminal;
+};
+}
+
+#endif
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QFile>
+#include <QDebug>
+#include <QDateTime>
+#include <QSysInfo>
+#include <QLibraryInfo>
+#include <QJsonDocument>
+
+#include <AppInfo.h>
+#include <Benchmark/Report.h>
+
+using namespace Benchmark;
+
+/**
+ * Constructor function, @a suite is the name of the benchmark suite that generated the
+ * results.
+ */
+Report::Report(const QString &suite)
+    : m_suite(suite)
+{
+}
+
+/**
+ * Registers the given benchmark @a result
+ */
+void Report::add(const QJsonObject &result)
+{
+    m_results.append(result);
+}
+
+/**
+ * Writes the JSON report to the given @a path, if @a path is empty, the report is
+ * written to the standard output.
+ *
+ * @returns @c true on success
+ */
+bool Report::write(const QString &path) const
+{
+    // Build information
+    QJsonObject build;
+    build.insert("application", APP_NAME);
+    build.insert("version", APP_VERSION);
+    build.insert("qt", qVersion());
+    build.insert("qtBuild", QLibraryInfo::build());
+    build.insert("abi", QSysInfo::buildAbi());
+#ifdef QT_NO_DEBUG
+    build.insert("type", "release");
+#else
+    build.insert("type", "debug");
+#endif
+
+    // Host information
+    QJsonObject host;
+    host.insert("name", QSysInfo::machineHostName());
+    host.insert("os", QSysInfo::prettyProductName());
+    host.insert("cpu", QSysInfo::currentCpuArchitecture());
+
+    // Create document
+    QJsonObject root;
+    root.insert("suite", m_suite);
+    root.insert("build", build);
+    root.insert("host", host);
+    root.insert("date", QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    root.insert("results", m_results);
+    auto json = QJsonDocument(root).toJson(QJsonDocument::Indented);
+
+    // Write to standard output
+    QFile file;
+    if (path.isEmpty())
+    {
+        if (!file.open(stdout, QFile::WriteOnly))
+            return false;
+    }
+
+    // Write to file
+    else
+    {
+        file.setFileName(path);
+        if (!file.open(QFile::WriteOnly | QFile::Truncate))
+        {
+            qWarning() << "Cannot write benchmark report" << file.errorString();
+            return false;
+        }
+    }
+
+    // Write data
+    file.write(json);
+    file.close();
+    return true;
+}
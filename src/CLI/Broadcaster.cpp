@@ -0,0 +1,470 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <limits>
+#include <algorithm>
+
+#include <QDebug>
+#include <QJsonArray>
+#include <QElapsedTimer>
+#include <QCoreApplication>
+
+#include <CLI/Broadcaster.h>
+#include <Serial/Backend.h>
+#include <Serial/Manager.h>
+#include <Benchmark/Report.h>
+#include <Misc/LatencyMonitor.h>
+
+using namespace CLI;
+
+/**
+ * Maximum number of devices that can be written at once
+ */
+static const int MAX_CHANNELS = 64;
+
+/**
+ * Maximum time to wait for the writer threads to reach the barrier or to finish a
+ * round (in milliseconds)
+ */
+static const int BARRIER_TIMEOUT = 1000;
+
+/**
+ * Converts the given nanosecond interval to microseconds
+ */
+static inline double Micros(const qint64 nanoseconds)
+{
+    return nanoseconds / 1000.0;
+}
+
+/**
+ * Replaces the escape sequences of the given @a text ("\r", "\n", "\t", "\\" and
+ * "\xNN") with the bytes that they represent
+ */
+static QByteArray Unescape(const QString &text)
+{
+    auto utf8 = text.toUtf8();
+
+    QByteArray data;
+    data.reserve(utf8.size());
+    for (int i = 0; i < utf8.size(); ++i)
+    {
+        if (utf8.at(i) != '\\' || i + 1 >= utf8.size())
+        {
+            data.append(utf8.at(i));
+            continue;
+        }
+
+        auto code = utf8.at(++i);
+        if (code == 'r')
+            data.append('\r');
+        else if (code == 'n')
+            data.append('\n');
+        else if (code == 't')
+            data.append('\t');
+        else if (code == 'x' && i + 2 < utf8.size())
+        {
+            data.append(QByteArray::fromHex(utf8.mid(i + 1, 2)));
+            i += 2;
+        }
+        else
+            data.append(code);
+    }
+
+    return data;
+}
+
+/**
+ * Waits until the given @a counter reaches @a value, or until the barrier timeout
+ * expires.
+ *
+ * @returns @c true if the counter reached the value
+ */
+static bool WaitFor(const std::atomic<int> &counter, const int value)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (counter.load(std::memory_order_acquire) < value)
+    {
+        if (timer.elapsed() > BARRIER_TIMEOUT)
+            return false;
+
+        QThread::yieldCurrentThread();
+    }
+
+    return true;
+}
+
+/**
+ * Constructor function
+ */
+Broadcaster::Broadcaster(QObject *parent)
+    : QObject(parent)
+    , m_round(-1)
+    , m_arrived(0)
+    , m_finished(0)
+    , m_release(-1)
+{
+}
+
+/**
+ * Closes all devices & stops the writer threads
+ */
+Broadcaster::~Broadcaster()
+{
+    foreach (auto channel, m_channels)
+    {
+        closeChannel(channel);
+        delete channel;
+    }
+}
+
+/**
+ * Registers the command line options of the broadcast mode in the given @a parser
+ */
+void Broadcaster::addOptions(QCommandLineParser &parser)
+{
+    // clang-format off
+    parser.addOption(QCommandLineOption("broadcast", "Send the same payload to the given comma-separated devices simultaneously & report the skew between them.", "devices"));
+    parser.addOption(QCommandLineOption("broadcast-data", "Payload to broadcast, supports the \\r, \\n, \\t & \\xNN escape sequences.", "text"));
+    parser.addOption(QCommandLineOption("broadcast-hex", "Payload to broadcast, as hexadecimal bytes.", "bytes"));
+    parser.addOption(QCommandLineOption("broadcast-count", "Number of times that the payload is sent.", "count", "1"));
+    parser.addOption(QCommandLineOption("broadcast-interval", "Time between two sends of the payload.", "ms", "1000"));
+    // clang-format on
+}
+
+/**
+ * Opens the devices given in the command line @a parser with the configuration of
+ * @c Serial::Manager, sends the payload the requested number of times & writes a JSON
+ * report with the skew of each round.
+ *
+ * @returns the exit code of the application
+ */
+int Broadcaster::exec(const QCommandLineParser &parser)
+{
+    // Get options
+    bool countOk, intervalOk;
+    auto count = parser.value("broadcast-count").toInt(&countOk);
+    auto interval = parser.value("broadcast-interval").toInt(&intervalOk);
+    auto names = parser.value("broadcast").split(',', QString::SkipEmptyParts);
+
+    // Encode payload (once for all the devices)
+    if (parser.isSet("broadcast-hex"))
+        m_payload = QByteArray::fromHex(parser.value("broadcast-hex").toLatin1());
+    else
+        m_payload = Unescape(parser.value("broadcast-data"));
+
+    // Validate options
+    if (names.isEmpty() || names.count() > MAX_CHANNELS)
+    {
+        qWarning() << "The broadcast mode requires 1 to" << MAX_CHANNELS << "devices";
+        return EXIT_FAILURE;
+    }
+    if (m_payload.isEmpty())
+    {
+        qWarning() << "No payload specified, use the --broadcast-data <text> or"
+                   << "--broadcast-hex <bytes> options";
+        return EXIT_FAILURE;
+    }
+    if (!countOk || count <= 0)
+    {
+        qWarning() << "Invalid broadcast count" << parser.value("broadcast-count");
+        return EXIT_FAILURE;
+    }
+    if (!intervalOk || interval < 0)
+    {
+        qWarning() << "Invalid broadcast interval" << parser.value("broadcast-interval");
+        return EXIT_FAILURE;
+    }
+
+    // Open devices
+    foreach (auto name, names)
+    {
+        auto channel = new Channel;
+        channel->name = name.trimmed();
+        channel->context = nullptr;
+        channel->device = nullptr;
+        channel->closed = false;
+        channel->released = 0;
+        channel->written = 0;
+        channel->bytes = 0;
+        channel->round = -1;
+        m_channels.append(channel);
+
+        if (!openChannel(channel))
+            return EXIT_FAILURE;
+    }
+
+    // Send the payload
+    bool ok = true;
+    QVector<double> skews;
+    Benchmark::Report report("broadcast");
+    for (int round = 0; round < count && ok; ++round)
+    {
+        if (round > 0)
+            QThread::msleep(static_cast<unsigned long>(interval));
+
+        QJsonObject result;
+        ok = runRound(round, result);
+        skews.append(result.value("skewUs").toDouble());
+        report.add(result);
+    }
+
+    // Add summary
+    std::sort(skews.begin(), skews.end());
+    double sum = 0;
+    foreach (auto skew, skews)
+        sum += skew;
+
+    QJsonObject summary;
+    summary.insert("name", "summary");
+    summary.insert("devices", m_channels.count());
+    summary.insert("payloadBytes", m_payload.size());
+    summary.insert("rounds", skews.count());
+    summary.insert("skewMinUs", skews.first());
+    summary.insert("skewMedianUs", skews.at(skews.count() / 2));
+    summary.insert("skewMaxUs", skews.last());
+    summary.insert("skewMeanUs", sum / skews.count());
+    summary.insert("passed", ok);
+    report.add(summary);
+
+    // Write report
+    if (!report.write(parser.value("output")))
+        return EXIT_FAILURE;
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * Creates the device of the given @a channel in its own writer thread & opens it with
+ * the configuration of @c Serial::Manager.
+ *
+ * @returns @c true if the device was opened
+ */
+bool Broadcaster::openChannel(Channel *channel)
+{
+    // Start writer thread
+    channel->context = new QObject;
+    channel->context->moveToThread(&channel->thread);
+    channel->thread.start(QThread::TimeCriticalPriority);
+
+    // Create & open the device in the writer thread
+    bool ok = false;
+    QMetaObject::invokeMethod(
+        channel->context,
+        [=, &ok]() {
+            auto manager = Serial::Manager::getInstance();
+            auto device = Serial::Backend::create(channel->name);
+            device->setParent(channel->context);
+            device->setParity(manager->parity());
+            device->setBaudRate(manager->baudRate());
+            device->setDataBits(manager->dataBits());
+            device->setStopBits(manager->stopBits());
+            device->setFlowControl(manager->flowControl());
+
+            // Discard received data
+            QObject::connect(device, &QIODevice::readyRead, channel->context,
+                             [=]() { device->readAll(); });
+
+            // Stop broadcasting if the device is closed
+            QObject::connect(device, &Serial::Backend::errorOccurred, channel->context,
+                             [=](const QString &error) {
+                                 qWarning().noquote() << channel->name << error;
+                                 channel->closed = true;
+                             });
+
+            // Open device
+            ok = device->open(QIODevice::ReadWrite);
+            if (ok)
+                channel->device = device;
+            else
+                qWarning() << "Cannot open" << channel->name << device->errorString();
+        },
+        Qt::BlockingQueuedConnection);
+
+    return ok;
+}
+
+/**
+ * Closes the device of the given @a channel (after writing pending data) & stops its
+ * writer thread
+ */
+void Broadcaster::closeChannel(Channel *channel)
+{
+    if (channel->context)
+    {
+        QMetaObject::invokeMethod(
+            channel->context,
+            [=]() {
+                if (channel->device)
+                {
+                    channel->device->flush();
+                    channel->device->close();
+                }
+
+                delete channel->context;
+            },
+            Qt::BlockingQueuedConnection);
+
+        channel->context = nullptr;
+        channel->device = nullptr;
+    }
+
+    channel->thread.quit();
+    channel->thread.wait();
+}
+
+/**
+ * Waits at the barrier until the given @a round is released & writes the payload to
+ * the device of the given @a channel (called from the writer thread of the channel).
+ * Nothing is written if the round was abandoned by the main thread (barrier timeout).
+ */
+void Broadcaster::send(Channel *channel, const int round)
+{
+    // The main thread gave up on this round
+    if (m_round.load(std::memory_order_acquire) != round)
+        return;
+
+    // Wait until all writer threads are ready
+    m_arrived.fetch_add(1, std::memory_order_acq_rel);
+    while (m_release.load(std::memory_order_acquire) < round)
+        QThread::yieldCurrentThread();
+
+    // Hand the payload to the operating system right away (unless the device was
+    // closed or the round was abandoned while waiting)
+    const qint64 released = Misc::LatencyMonitor::timestamp();
+    if (m_round.load(std::memory_order_acquire) != round)
+        return;
+
+    channel->released = released;
+    if (channel->closed || !channel->device)
+        channel->bytes = 0;
+    else
+    {
+        channel->bytes = channel->device->write(m_payload);
+        channel->device->flush();
+    }
+
+    channel->written = Misc::LatencyMonitor::timestamp();
+
+    // Publish the timing of this round & notify the main thread
+    channel->round.store(round, std::memory_order_release);
+    m_finished.fetch_add(1, std::memory_order_acq_rel);
+}
+
+/**
+ * Sends the payload to all open devices once & stores the timing of each device in the
+ * given @a result object. Only the timing recorded in this round is read, the writer
+ * threads that did not finish in time are reported as failed.
+ *
+ * @returns @c true if the payload was written to all devices
+ */
+bool Broadcaster::runRound(const int round, QJsonObject &result)
+{
+    // Schedule the write in the writer thread of every open device
+    bool ok = true;
+    int expected = 0;
+    m_arrived = 0;
+    m_finished = 0;
+    m_round.store(round, std::memory_order_release);
+    foreach (auto channel, m_channels)
+    {
+        if (channel->closed || !channel->device)
+        {
+            ok = false;
+            continue;
+        }
+
+        ++expected;
+        QMetaObject::invokeMethod(
+            channel->context, [=]() { send(channel, round); }, Qt::QueuedConnection);
+    }
+
+    // Release all threads at once (even if some threads did not reach the barrier in
+    // time, so that they do not block forever)
+    const bool arrived = WaitFor(m_arrived, expected);
+    m_release.store(round, std::memory_order_release);
+    const bool finished = WaitFor(m_finished, expected);
+
+    // Abandon the round if a thread is late (late threads do not write the payload)
+    if (!arrived || !finished)
+    {
+        m_round.store(-1, std::memory_order_release);
+        qWarning() << "Writer threads did not finish round" << round + 1 << "in time";
+        ok = false;
+    }
+
+    // Get the first & last release & write times of the devices written in this round
+    int written = 0;
+    qint64 firstRelease = std::numeric_limits<qint64>::max();
+    qint64 lastRelease = 0;
+    qint64 firstWrite = std::numeric_limits<qint64>::max();
+    qint64 lastWrite = 0;
+    foreach (auto channel, m_channels)
+    {
+        if (channel->round.load(std::memory_order_acquire) != round)
+            continue;
+
+        ++written;
+        firstRelease = qMin(firstRelease, channel->released);
+        lastRelease = qMax(lastRelease, channel->released);
+        firstWrite = qMin(firstWrite, channel->written);
+        lastWrite = qMax(lastWrite, channel->written);
+    }
+
+    // No device was written
+    if (written == 0)
+    {
+        firstRelease = lastRelease = 0;
+        firstWrite = lastWrite = 0;
+    }
+
+    // Report the timing of each device (relative to the first write)
+    QJsonArray devices;
+    foreach (auto channel, m_channels)
+    {
+        QJsonObject device;
+        device.insert("device", channel->name);
+        if (channel->round.load(std::memory_order_acquire) != round)
+        {
+            ok = false;
+            device.insert("closed", channel->closed.load());
+            device.insert("bytes", 0);
+            devices.append(device);
+            continue;
+        }
+
+        ok &= (channel->bytes == m_payload.size());
+        device.insert("bytes", channel->bytes);
+        device.insert("releaseOffsetUs", Micros(channel->released - firstRelease));
+        device.insert("writeOffsetUs", Micros(channel->written - firstWrite));
+        device.insert("writeDurationUs", Micros(channel->written - channel->released));
+        devices.append(device);
+    }
+
+    // Build result
+    result.insert("name", QString("round %1").arg(round + 1));
+    result.insert("releaseSkewUs", Micros(lastRelease - firstRelease));
+    result.insert("skewUs", Micros(lastWrite - firstWrite));
+    result.insert("devices", devices);
+    result.insert("passed", ok);
+    return ok;
+}
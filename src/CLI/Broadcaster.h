@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CLI_BROADCASTER_H
+#define CLI_BROADCASTER_H
+
+#include <atomic>
+
+#include <QThread>
+#include <QVector>
+#include <QObject>
+#include <QJsonObject>
+#include <QCommandLineParser>
+
+namespace Serial
+{
+class Backend;
+}
+
+namespace CLI
+{
+/**
+ * Broadcast mode: sends the same payload to several devices as simultaneously as
+ * possible (e.g. to trigger all the devices of a test bench at once).
+ *
+ * The payload is encoded once & each device is written by its own thread. Before each
+ * round, every thread waits at a shared barrier (spinning, so that it reacts within
+ * microseconds) & the barrier is released once all threads have reached it. The time
+ * at which each thread was released & the time at which the payload was handed to the
+ * operating system are recorded, and the skew between devices is reported as JSON.
+ *
+ * Closed devices are left out of the barrier. The timing of each device is tagged with
+ * the round in which it was recorded, threads that miss the barrier timeout do not
+ * write the payload & the broadcast stops after the round.
+ */
+class Broadcaster : public QObject
+{
+    Q_OBJECT
+
+public:
+    Broadcaster(QObject *parent = nullptr);
+    ~Broadcaster();
+
+    static void addOptions(QCommandLineParser &parser);
+    int exec(const QCommandLineParser &parser);
+
+private:
+    struct Channel
+    {
+        QString name;
+        QThread thread;
+        QObject *context;
+        Serial::Backend *device;
+        std::atomic<bool> closed;
+
+        qint64 released;
+        qint64 written;
+        qint64 bytes;
+        std::atomic<int> round;
+    };
+
+    bool openChannel(Channel *channel);
+    void closeChannel(Channel *channel);
+    void send(Channel *channel, const int round);
+    bool runRound(const int round, QJsonObject &result);
+
+private:
+    QByteArray m_payload;
+    QVector<Channel *> m_channels;
+
+    std::atomic<int> m_round;
+    std::atomic<int> m_arrived;
+    std::atomic<int> m_finished;
+    std::atomic<int> m_release;
+};
+}
+
+#endif
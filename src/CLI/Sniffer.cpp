@@ -0,0 +1,466 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <limits>
+
+#include <QDebug>
+#include <QDateTime>
+#include <QCoreApplication>
+
+#include <CLI/Sniffer.h>
+#include <Serial/Backend.h>
+#include <Serial/Manager.h>
+#include <Misc/LatencyMonitor.h>
+
+using namespace CLI;
+
+/**
+ * Maximum number of devices that can be merged (devices are labeled from A to H)
+ */
+static const int MAX_CHANNELS = 8;
+
+/**
+ * Interval at which the timelines of the devices are merged (in milliseconds)
+ */
+static const int MERGE_INTERVAL = 10;
+
+/**
+ * Interval at which idle readers report that they did not receive data (in
+ * milliseconds), this is the maximum delay added by the merge
+ */
+static const int WATERMARK_INTERVAL = 5;
+
+/**
+ * Frames without new data during this time are written even if the direction does
+ * not change, so that the output stays live (in nanoseconds)
+ */
+static const qint64 IDLE_TIMEOUT = 100 * 1000 * 1000;
+
+/**
+ * Frames longer than this size are split, even if the direction does not change
+ */
+static const int MAX_FRAME_SIZE = 4096;
+
+/**
+ * Returns a printable version of the given @a data, control characters & non-ASCII
+ * bytes are escaped (e.g. "\r", "\n" or "\xF3")
+ */
+static QByteArray Escape(const QByteArray &data)
+{
+    static const char DIGITS[] = "0123456789ABCDEF";
+
+    QByteArray text;
+    text.reserve(data.size() + data.size() / 4);
+    for (int i = 0; i < data.size(); ++i)
+    {
+        auto byte = static_cast<quint8>(data.at(i));
+        if (byte == '\\')
+            text.append("\\\\");
+        else if (byte >= 0x20 && byte < 0x7F)
+            text.append(static_cast<char>(byte));
+        else if (byte == '\r')
+            text.append("\\r");
+        else if (byte == '\n')
+            text.append("\\n");
+        else if (byte == '\t')
+            text.append("\\t");
+        else
+        {
+            text.append("\\x");
+            text.append(DIGITS[byte >> 4]);
+            text.append(DIGITS[byte & 0x0F]);
+        }
+    }
+
+    return text;
+}
+
+/**
+ * Constructor function
+ */
+Sniffer::Sniffer(QObject *parent)
+    : QObject(parent)
+    , m_hex(true)
+    , m_gap(0)
+    , m_idleTimeout(IDLE_TIMEOUT)
+    , m_frameChannel(-1)
+    , m_frameStart(0)
+    , m_frameEnd(0)
+{
+    // Offset between the monotonic clock & the wall clock (in nanoseconds)
+    m_clockOffset = QDateTime::currentMSecsSinceEpoch() * 1000000
+        - Misc::LatencyMonitor::timestamp();
+
+    // Merge the timelines periodically
+    m_timer.setInterval(MERGE_INTERVAL);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &Sniffer::merge);
+}
+
+/**
+ * Closes all devices & stops the reader threads
+ */
+Sniffer::~Sniffer()
+{
+    foreach (auto channel, m_channels)
+    {
+        closeChannel(channel);
+        delete channel;
+    }
+}
+
+/**
+ * Registers the command line options of the sniffer mode in the given @a parser
+ */
+void Sniffer::addOptions(QCommandLineParser &parser)
+{
+    // clang-format off
+    parser.addOption(QCommandLineOption("sniff", "Merge the data received by the given comma-separated devices (e.g. the TX & RX taps of a link) into a single timeline.", "devices"));
+    parser.addOption(QCommandLineOption("sniff-format", "Sniffer output format: hex or text.", "format", "hex"));
+    parser.addOption(QCommandLineOption("sniff-gap", "Also start a new sniffer frame after <ms> milliseconds without data (default: only when the direction changes).", "ms", "0"));
+    // clang-format on
+}
+
+/**
+ * Opens the devices given in the command line @a parser with the configuration of
+ * @c Serial::Manager & writes the merged timeline until all devices are closed.
+ *
+ * @returns the exit code of the application
+ */
+int Sniffer::exec(const QCommandLineParser &parser)
+{
+    // Get options
+    bool ok;
+    auto format = parser.value("sniff-format").toLower();
+    auto gap = parser.value("sniff-gap").toInt(&ok);
+    auto names = parser.value("sniff").split(',', QString::SkipEmptyParts);
+
+    // Validate options
+    if (names.count() < 2 || names.count() > MAX_CHANNELS)
+    {
+        qWarning() << "The sniffer mode requires 2 to" << MAX_CHANNELS << "devices";
+        return EXIT_FAILURE;
+    }
+    if (format != "hex" && format != "text")
+    {
+        qWarning() << "Invalid sniffer format" << parser.value("sniff-format");
+        return EXIT_FAILURE;
+    }
+    if (!ok || gap < 0)
+    {
+        qWarning() << "Invalid sniffer gap" << parser.value("sniff-gap");
+        return EXIT_FAILURE;
+    }
+
+    // Apply options
+    m_hex = (format == "hex");
+    m_gap = static_cast<qint64>(gap) * 1000 * 1000;
+    if (m_gap > 0)
+        m_idleTimeout = qMin(m_gap, IDLE_TIMEOUT);
+
+    // Open output file
+    if (parser.isSet("output"))
+    {
+        m_output.setFileName(parser.value("output"));
+        if (!m_output.open(QFile::WriteOnly | QFile::Truncate | QFile::Unbuffered))
+        {
+            qWarning() << "Cannot open output file:" << m_output.errorString();
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Write data to the standard output (without any additional buffering)
+    else if (!m_output.open(fileno(stdout), QFile::WriteOnly | QFile::Unbuffered))
+    {
+        qWarning() << "Cannot open standard output";
+        return EXIT_FAILURE;
+    }
+
+    // Open devices
+    foreach (auto name, names)
+    {
+        auto channel = new Channel;
+        channel->name = name.trimmed();
+        channel->context = nullptr;
+        channel->device = nullptr;
+        channel->watermark = 0;
+        channel->closed = false;
+        channel->pendingIndex = 0;
+        channel->bytes = 0;
+        m_channels.append(channel);
+
+        if (!openChannel(channel))
+            return EXIT_FAILURE;
+
+        qDebug().noquote() << QString("%1 = %2").arg(QChar('A' + m_channels.count() - 1),
+                                                     channel->name);
+    }
+
+    // Merge timelines until all devices are closed
+    m_timer.start();
+    return qApp->exec();
+}
+
+/**
+ * Merges the chunks received by all devices up to the last time at which every reader
+ * was known to be idle, chunks are sorted by read time (k-way merge of the per-device
+ * timelines, which are already sorted).
+ */
+void Sniffer::merge()
+{
+    // Get the time up to which the timeline of every device is complete (the watermark
+    // must be obtained before the chunks, since readers update it after each chunk)
+    bool closed = true;
+    qint64 limit = std::numeric_limits<qint64>::max();
+    foreach (auto channel, m_channels)
+    {
+        if (!channel->closed)
+        {
+            closed = false;
+            limit = qMin(limit, channel->watermark.load());
+        }
+    }
+
+    // Take the chunks read by each device
+    foreach (auto channel, m_channels)
+    {
+        QMutexLocker locker(&channel->mutex);
+        if (channel->pending.isEmpty())
+            channel->pending.swap(channel->chunks);
+        else
+            channel->pending += channel->chunks;
+
+        channel->chunks.clear();
+    }
+
+    // Append the oldest chunk to the timeline until the limit is reached
+    forever
+    {
+        int next = -1;
+        qint64 oldest = std::numeric_limits<qint64>::max();
+        for (int i = 0; i < m_channels.count(); ++i)
+        {
+            auto channel = m_channels.at(i);
+            if (channel->pendingIndex < channel->pending.count())
+            {
+                auto timestamp = channel->pending.at(channel->pendingIndex).timestamp;
+                if (timestamp < oldest)
+                {
+                    next = i;
+                    oldest = timestamp;
+                }
+            }
+        }
+
+        if (next < 0 || oldest > limit)
+            break;
+
+        auto channel = m_channels.at(next);
+        append(next, channel->pending.at(channel->pendingIndex));
+        channel->bytes += channel->pending.at(channel->pendingIndex).data.size();
+        ++channel->pendingIndex;
+    }
+
+    // Remove merged chunks
+    foreach (auto channel, m_channels)
+    {
+        channel->pending.remove(0, channel->pendingIndex);
+        channel->pendingIndex = 0;
+    }
+
+    // Write the current frame if no data was received for a while
+    if (!m_frame.isEmpty() && (closed || limit - m_frameEnd > m_idleTimeout))
+        flushFrame();
+
+    // Stop when all devices have been closed
+    if (closed)
+    {
+        m_timer.stop();
+        foreach (auto channel, m_channels)
+            qDebug().noquote() << channel->name << channel->bytes << "bytes";
+
+        qWarning() << "All sniffed devices closed";
+        m_output.close();
+        qApp->exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Creates the device of the given @a channel in its own reader thread & opens it with
+ * the configuration of @c Serial::Manager.
+ *
+ * @returns @c true if the device was opened
+ */
+bool Sniffer::openChannel(Channel *channel)
+{
+    // Start reader thread
+    channel->context = new QObject;
+    channel->context->moveToThread(&channel->thread);
+    channel->thread.start(QThread::TimeCriticalPriority);
+
+    // Create & open the device in the reader thread
+    bool ok = false;
+    QMetaObject::invokeMethod(
+        channel->context,
+        [=, &ok]() {
+            auto manager = Serial::Manager::getInstance();
+            auto device = Serial::Backend::create(channel->name);
+            device->setParent(channel->context);
+            device->setParity(manager->parity());
+            device->setBaudRate(manager->baudRate());
+            device->setDataBits(manager->dataBits());
+            device->setStopBits(manager->stopBits());
+            device->setFlowControl(manager->flowControl());
+
+            // Timestamp each chunk as soon as it is read, then move the watermark
+            QObject::connect(device, &QIODevice::readyRead, channel->context, [=]() {
+                Chunk chunk;
+                chunk.data = device->readAll();
+                chunk.timestamp = Misc::LatencyMonitor::timestamp();
+                if (chunk.data.isEmpty())
+                    return;
+
+                channel->mutex.lock();
+                channel->chunks.append(chunk);
+                channel->mutex.unlock();
+                channel->watermark = chunk.timestamp;
+            });
+
+            // Chunks read after this point will have a newer timestamp
+            auto timer = new QTimer(channel->context);
+            timer->setTimerType(Qt::PreciseTimer);
+            QObject::connect(timer, &QTimer::timeout, channel->context, [=]() {
+                channel->watermark = Misc::LatencyMonitor::timestamp();
+            });
+
+            // Stop merging the timeline of this device when it is closed (because of an
+            // error or because the device ended cleanly), the merge is woken up so that
+            // the other devices are not held back by the frozen watermark
+            auto close = [=]() {
+                if (channel->closed)
+                    return;
+
+                timer->stop();
+                channel->closed = true;
+                QMetaObject::invokeMethod(this, "merge", Qt::QueuedConnection);
+            };
+            QObject::connect(device, &Serial::Backend::errorOccurred, channel->context,
+                             [=](const QString &error) {
+                                 qWarning().noquote() << channel->name << error;
+                                 close();
+                             });
+            QObject::connect(device, &QIODevice::readChannelFinished, channel->context,
+                             close);
+            QObject::connect(device, &QIODevice::aboutToClose, channel->context, close);
+
+            // Open device
+            ok = device->open(QIODevice::ReadWrite);
+            if (ok)
+            {
+                channel->device = device;
+                channel->watermark = Misc::LatencyMonitor::timestamp();
+                timer->start(WATERMARK_INTERVAL);
+            }
+            else
+                qWarning() << "Cannot open" << channel->name << device->errorString();
+        },
+        Qt::BlockingQueuedConnection);
+
+    return ok;
+}
+
+/**
+ * Closes the device of the given @a channel & stops its reader thread
+ */
+void Sniffer::closeChannel(Channel *channel)
+{
+    if (channel->context)
+    {
+        QMetaObject::invokeMethod(
+            channel->context,
+            [=]() {
+                if (channel->device)
+                    channel->device->close();
+
+                delete channel->context;
+            },
+            Qt::BlockingQueuedConnection);
+
+        channel->context = nullptr;
+        channel->device = nullptr;
+    }
+
+    channel->thread.quit();
+    channel->thread.wait();
+}
+
+/**
+ * Appends the given @a chunk of the given @a channel to the current frame, the frame is
+ * written first if the direction changed (or if the idle gap was exceeded).
+ */
+void Sniffer::append(const int channel, const Chunk &chunk)
+{
+    if (!m_frame.isEmpty())
+    {
+        if (channel != m_frameChannel || m_frame.size() >= MAX_FRAME_SIZE
+            || (m_gap > 0 && chunk.timestamp - m_frameEnd > m_gap))
+            flushFrame();
+    }
+
+    if (m_frame.isEmpty())
+    {
+        m_frameChannel = channel;
+        m_frameStart = chunk.timestamp;
+    }
+
+    m_frame.append(chunk.data);
+    m_frameEnd = chunk.timestamp;
+}
+
+/**
+ * Writes the current frame with the wall-clock time at which its first chunk was read
+ * & the label of the device that received it
+ */
+void Sniffer::flushFrame()
+{
+    if (m_frame.isEmpty())
+        return;
+
+    // Get wall-clock time with microsecond resolution
+    auto time = m_clockOffset + m_frameStart;
+    auto dateTime = QDateTime::fromMSecsSinceEpoch(time / 1000000);
+    auto micros = (time / 1000) % 1000;
+
+    // Build the line
+    QByteArray line = dateTime.toString("yyyy-MM-dd HH:mm:ss.zzz").toUtf8();
+    line.append(QByteArray::number(micros).rightJustified(3, '0'));
+    line.append(' ');
+    line.append(static_cast<char>('A' + m_frameChannel));
+    line.append("> ");
+    line.append(m_hex ? m_frame.toHex(' ').toUpper() : Escape(m_frame));
+    line.append('\n');
+
+    // Write the line
+    m_output.write(line);
+    m_frame.clear();
+}
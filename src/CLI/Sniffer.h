@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CLI_SNIFFER_H
+#define CLI_SNIFFER_H
+
+#include <atomic>
+
+#include <QFile>
+#include <QMutex>
+#include <QTimer>
+#include <QThread>
+#include <QVector>
+#include <QObject>
+#include <QCommandLineParser>
+
+namespace Serial
+{
+class Backend;
+}
+
+namespace CLI
+{
+/**
+ * Sniffer mode: opens two (or more) devices that tap the TX & RX lines of a link,
+ * timestamps each chunk of data when it is read & merges the chunks of all devices
+ * into a single timeline, ordered by read time.
+ *
+ * Each device is read by its own thread, so that a busy device cannot delay the
+ * timestamps of the others. The main thread merges the chunks whose timestamp is
+ * older than the last time every reader was known to be idle, which guarantees that
+ * chunks are never written out of order.
+ *
+ * Consecutive chunks of the same device are written as a single frame, a new frame
+ * starts when the direction changes (or after an optional idle gap), e.g:
+ *
+ *     2021-03-01 10:00:00.123456 A> 01 03 00 00 00 02 C4 0B
+ *     2021-03-01 10:00:00.131982 B> 01 03 04 00 2A 00 2B 5A 3E
+ */
+class Sniffer : public QObject
+{
+    Q_OBJECT
+
+public:
+    Sniffer(QObject *parent = nullptr);
+    ~Sniffer();
+
+    static void addOptions(QCommandLineParser &parser);
+    int exec(const QCommandLineParser &parser);
+
+private slots:
+    void merge();
+
+private:
+    struct Chunk
+    {
+        qint64 timestamp;
+        QByteArray data;
+    };
+
+    struct Channel
+    {
+        QString name;
+        QThread thread;
+        QObject *context;
+        Serial::Backend *device;
+
+        QMutex mutex;
+        QVector<Chunk> chunks;
+        std::atomic<qint64> watermark;
+        std::atomic<bool> closed;
+
+        QVector<Chunk> pending;
+        int pendingIndex;
+        qint64 bytes;
+    };
+
+    bool openChannel(Channel *channel);
+    void closeChannel(Channel *channel);
+    void append(const int channel, const Chunk &chunk);
+    void flushFrame();
+
+private:
+    bool m_hex;
+    qint64 m_gap;
+    qint64 m_idleTimeout;
+    qint64 m_clockOffset;
+
+    QFile m_output;
+    QTimer m_timer;
+    QVector<Channel *> m_channels;
+
+    int m_frameChannel;
+    qint64 m_frameStart;
+    qint64 m_frameEnd;
+    QByteArray m_frame;
+};
+}
+
+#endif
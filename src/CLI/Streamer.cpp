@@ -0,0 +1,402 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+
+#include <QDebug>
+#include <QDateTime>
+#include <QSerialPortInfo>
+#include <QSocketNotifier>
+#include <QCoreApplication>
+
+#include <CLI/Sniffer.h>
+#include <CLI/Broadcaster.h>
+#include <CLI/Streamer.h>
+#include <Serial/Manager.h>
+#include <Benchmark/Report.h>
+#include <Serial/LoopbackTester.h>
+
+#ifdef Q_OS_UNIX
+#    include <unistd.h>
+#else
+#    include <thread>
+#endif
+
+using namespace CLI;
+
+/**
+ * Stop reading the standard input when the serial port write buffer exceeds this size
+ */
+static const qint64 MAX_PENDING_TX = 1024 * 1024;
+
+/**
+ * Size of the buffer used to read the standard input
+ */
+static const int STDIN_BUFFER_SIZE = 64 * 1024;
+
+/**
+ * Constructor function
+ */
+Streamer::Streamer(QObject *parent)
+    : QObject(parent)
+    , m_format(Format::Raw)
+    , m_lineStart(true)
+    , m_notifier(nullptr)
+    , m_rxBytes(0)
+    , m_txBytes(0)
+{
+}
+
+/**
+ * Registers the command line options of the headless mode in the given @a parser
+ */
+void Streamer::addOptions(QCommandLineParser &parser)
+{
+    // clang-format off
+    parser.addOption(QCommandLineOption("headless", "Stream data from/to a serial port without loading the user interface."));
+    parser.addOption(QCommandLineOption("list-ports", "List the available serial ports & exit."));
+    parser.addOption(QCommandLineOption("port", "Serial port to open in headless mode.", "name"));
+    parser.addOption(QCommandLineOption("baud", "Baud rate (headless mode).", "rate", "9600"));
+    parser.addOption(QCommandLineOption("data-bits", "Data bits: 5, 6, 7 or 8 (headless mode).", "bits", "8"));
+    parser.addOption(QCommandLineOption("parity", "Parity: none, even, odd, space or mark (headless mode).", "parity", "none"));
+    parser.addOption(QCommandLineOption("stop-bits", "Stop bits: 1, 1.5 or 2 (headless mode).", "bits", "1"));
+    parser.addOption(QCommandLineOption("flow-control", "Flow control: none, hardware or software (headless mode).", "mode", "none"));
+    parser.addOption(QCommandLineOption("format", "Output format: raw, hex or timestamp (headless mode).", "format", "raw"));
+    parser.addOption(QCommandLineOption("output", "Write received data (or the loopback test report) to <file> instead of the standard output (headless mode).", "file"));
+    parser.addOption(QCommandLineOption("loopback", "Run a loopback test with the given pattern: prbs7, prbs15, prbs31 or counter (headless mode).", "pattern"));
+    parser.addOption(QCommandLineOption("loopback-duration", "Duration of the loopback test.", "seconds", "10"));
+    // clang-format on
+
+    Sniffer::addOptions(parser);
+    Broadcaster::addOptions(parser);
+}
+
+/**
+ * Opens the serial port & the output file with the options given in the command line
+ * @a parser and streams data until the serial port is closed.
+ *
+ * @returns the exit code of the application
+ */
+int Streamer::exec(const QCommandLineParser &parser)
+{
+    // List serial ports & exit
+    if (parser.isSet("list-ports"))
+    {
+        foreach (auto info, QSerialPortInfo::availablePorts())
+            printf("%s\t%s\n", qPrintable(info.systemLocation()),
+                   qPrintable(info.description()));
+
+        return EXIT_SUCCESS;
+    }
+
+    // Only serve the control socket, ports are opened by its clients
+    if (!parser.isSet("port") && parser.isSet("control-socket"))
+        return qApp->exec();
+
+    // Merge the data of several devices into a single timeline
+    if (parser.isSet("sniff"))
+    {
+        if (!configure(parser))
+            return EXIT_FAILURE;
+
+        return Sniffer().exec(parser);
+    }
+
+    // Send the same data to several devices at once
+    if (parser.isSet("broadcast"))
+    {
+        if (!configure(parser))
+            return EXIT_FAILURE;
+
+        return Broadcaster().exec(parser);
+    }
+
+    // Check that the user specified the serial port
+    if (!parser.isSet("port"))
+    {
+        qWarning() << "No serial port specified, use the --port <name> option";
+        return EXIT_FAILURE;
+    }
+
+    // Configure serial port
+    if (!configure(parser))
+        return EXIT_FAILURE;
+
+    // Open serial port
+    auto manager = Serial::Manager::getInstance();
+    manager->connectToPort(parser.value("port"));
+    if (!manager->connected())
+    {
+        qWarning() << "Cannot open" << parser.value("port")
+                   << (manager->port() ? manager->port()->errorString() : QString());
+        return EXIT_FAILURE;
+    }
+
+    // Run loopback test instead of streaming data
+    if (parser.isSet("loopback"))
+        return runLoopbackTest(parser);
+
+    // Open output file
+    if (parser.isSet("output"))
+    {
+        m_output.setFileName(parser.value("output"));
+        if (!m_output.open(QFile::WriteOnly | QFile::Truncate | QFile::Unbuffered))
+        {
+            qWarning() << "Cannot open output file:" << m_output.errorString();
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Write data to the standard output (without any additional buffering)
+    else if (!m_output.open(fileno(stdout), QFile::WriteOnly | QFile::Unbuffered))
+    {
+        qWarning() << "Cannot open standard output";
+        return EXIT_FAILURE;
+    }
+
+    // Write received data & stop when the serial port is closed
+    connect(manager, &Serial::Manager::closed, this, &Streamer::onClosed);
+    connect(manager, &Serial::Manager::dataReceived, this, &Streamer::onDataReceived);
+
+    // Resume reading the standard input when pending data has been written
+    connect(manager->port(), &QIODevice::bytesWritten, this, [=]() {
+        auto port = Serial::Manager::getInstance()->port();
+        if (m_notifier && port && port->bytesToWrite() < MAX_PENDING_TX)
+            m_notifier->setEnabled(true);
+    });
+
+    // Read the standard input when data is available
+#ifdef Q_OS_UNIX
+    m_notifier = new QSocketNotifier(STDIN_FILENO, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &Streamer::readStdin);
+
+    // Read the standard input in a separate thread (Windows does not support socket
+    // notifiers for console handles)
+#else
+    std::thread([=]() {
+        QByteArray buffer(STDIN_BUFFER_SIZE, 0);
+        size_t bytes;
+        while ((bytes = fread(buffer.data(), 1, buffer.size(), stdin)) > 0)
+        {
+            auto data = buffer.left(static_cast<int>(bytes));
+            QMetaObject::invokeMethod(
+                this,
+                [=]() {
+                    auto written = Serial::Manager::getInstance()->writeData(data);
+                    if (written > 0)
+                        m_txBytes += written;
+                },
+                Qt::QueuedConnection);
+        }
+    }).detach();
+#endif
+
+    // Enter event loop
+    const auto code = qApp->exec();
+
+    // Log statistics
+    qDebug() << "Received" << m_rxBytes << "bytes, sent" << m_txBytes << "bytes";
+    return code;
+}
+
+/**
+ * Transmits a test pattern through the serial port, verifies the data received back
+ * & writes the test report to the output file (or to the standard output).
+ *
+ * @returns @c EXIT_SUCCESS if no errors were detected
+ */
+int Streamer::runLoopbackTest(const QCommandLineParser &parser)
+{
+    // Get test pattern
+    Serial::PatternGenerator::Pattern pattern;
+    if (!Serial::PatternGenerator::patternFromName(parser.value("loopback"), pattern))
+    {
+        qWarning() << "Invalid loopback pattern" << parser.value("loopback");
+        return EXIT_FAILURE;
+    }
+
+    // Run test until it finishes or the serial port is closed
+    Serial::LoopbackTester tester(pattern);
+    auto manager = Serial::Manager::getInstance();
+    connect(&tester, &Serial::LoopbackTester::finished, qApp, &QCoreApplication::quit);
+    connect(manager, &Serial::Manager::closed, &tester, &Serial::LoopbackTester::stop);
+    tester.start(qMax(1, parser.value("loopback-duration").toInt()));
+    qApp->exec();
+
+    // Write report
+    Benchmark::Report report("loopback");
+    report.add(tester.toJson());
+    if (!report.write(parser.value("output")))
+        return EXIT_FAILURE;
+
+    return tester.passed() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * Exits the application when the serial port is closed
+ */
+void Streamer::onClosed()
+{
+    qWarning() << "Serial port closed";
+    m_output.close();
+    qApp->exit(EXIT_FAILURE);
+}
+
+/**
+ * Reads the data available in the standard input & writes it to the serial port. If the
+ * serial port write buffer is full, we stop reading the standard input until pending
+ * data has been written to the serial port.
+ */
+void Streamer::readStdin()
+{
+#ifdef Q_OS_UNIX
+    // Read available data
+    char buffer[STDIN_BUFFER_SIZE];
+    auto bytes = ::read(STDIN_FILENO, buffer, sizeof(buffer));
+
+    // End of file or read error, stop reading the standard input
+    if (bytes <= 0)
+    {
+        m_notifier->setEnabled(false);
+        m_notifier->deleteLater();
+        m_notifier = nullptr;
+        return;
+    }
+
+    // Write data to serial port
+    auto manager = Serial::Manager::getInstance();
+    auto written = manager->writeData(QByteArray(buffer, static_cast<int>(bytes)));
+    if (written > 0)
+        m_txBytes += written;
+
+    // Apply back-pressure to the standard input
+    if (manager->port() && manager->port()->bytesToWrite() >= MAX_PENDING_TX)
+        m_notifier->setEnabled(false);
+#endif
+}
+
+/**
+ * Writes the received @a data to the output file in the format selected by the user
+ */
+void Streamer::onDataReceived(const QByteArray &data)
+{
+    m_rxBytes += data.size();
+
+    switch (m_format)
+    {
+        case Format::Raw:
+            m_output.write(data);
+            break;
+        case Format::Hexadecimal:
+            m_output.write(data.toHex(' ').toUpper() + '\n');
+            break;
+        case Format::Timestamp:
+            writeTimestamped(data);
+            break;
+    }
+}
+
+/**
+ * Configures the serial port parameters & the output format with the options given
+ * in the command line @a parser.
+ *
+ * @returns @c false if any of the options is invalid
+ */
+bool Streamer::configure(const QCommandLineParser &parser)
+{
+    // Parity & flow control names (same order as the lists of @c Serial::Manager)
+    static const QStringList PARITIES = { "none", "even", "odd", "space", "mark" };
+    static const QStringList FLOW_CONTROLS = { "none", "hardware", "software" };
+    static const QStringList FORMATS = { "raw", "hex", "timestamp" };
+
+    // Get options
+    bool ok;
+    auto manager = Serial::Manager::getInstance();
+    auto baudRate = parser.value("baud").toInt(&ok);
+    auto dataBits = manager->dataBitsList().indexOf(parser.value("data-bits"));
+    auto stopBits = manager->stopBitsList().indexOf(parser.value("stop-bits"));
+    auto parity = PARITIES.indexOf(parser.value("parity").toLower());
+    auto flowControl = FLOW_CONTROLS.indexOf(parser.value("flow-control").toLower());
+    auto format = FORMATS.indexOf(parser.value("format").toLower());
+
+    // Validate options
+    if (!ok || baudRate <= 10)
+        qWarning() << "Invalid baud rate" << parser.value("baud");
+    else if (dataBits < 0)
+        qWarning() << "Invalid data bits" << parser.value("data-bits");
+    else if (stopBits < 0)
+        qWarning() << "Invalid stop bits" << parser.value("stop-bits");
+    else if (parity < 0)
+        qWarning() << "Invalid parity" << parser.value("parity");
+    else if (flowControl < 0)
+        qWarning() << "Invalid flow control" << parser.value("flow-control");
+    else if (format < 0)
+        qWarning() << "Invalid output format" << parser.value("format");
+
+    // Apply configuration
+    else
+    {
+        manager->setBaudRate(baudRate);
+        manager->setDataBits(dataBits);
+        manager->setStopBits(stopBits);
+        manager->setParity(parity);
+        manager->setFlowControl(flowControl);
+        m_format = static_cast<Format>(format);
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * Writes the given @a data, adding the reception time at the start of each line
+ */
+void Streamer::writeTimestamped(const QByteArray &data)
+{
+    // Get reception time
+    auto time = QDateTime::currentDateTime();
+    auto timestamp = time.toString("[yyyy-MM-dd HH:mm:ss.zzz] ").toUtf8();
+
+    // Add timestamp after each line break
+    QByteArray output;
+    output.reserve(data.size() + timestamp.size() * 2);
+    int start = 0;
+    while (start < data.size())
+    {
+        if (m_lineStart)
+            output.append(timestamp);
+
+        auto end = data.indexOf('\n', start);
+        if (end < 0)
+        {
+            output.append(data.constData() + start, data.size() - start);
+            m_lineStart = false;
+            break;
+        }
+
+        output.append(data.constData() + start, end - start + 1);
+        m_lineStart = true;
+        start = end + 1;
+    }
+
+    m_output.write(output);
+}
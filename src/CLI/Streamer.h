@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CLI_STREAMER_H
+#define CLI_STREAMER_H
+
+#include <QFile>
+#include <QObject>
+#include <QCommandLineParser>
+
+class QSocketNotifier;
+
+namespace CLI
+{
+/**
+ * Headless streaming mode: opens a serial port with the options given through the
+ * command line, writes received data to the standard output (or to a file) & sends
+ * data read from the standard input to the serial port.
+ *
+ * This mode does not load the QML interface, it only uses @c Serial::Manager, which
+ * makes it suitable for capturing data on headless machines.
+ */
+class Streamer : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Format
+    {
+        Raw,
+        Hexadecimal,
+        Timestamp
+    };
+
+    Streamer(QObject *parent = nullptr);
+
+    static void addOptions(QCommandLineParser &parser);
+    int exec(const QCommandLineParser &parser);
+
+private slots:
+    void onClosed();
+    void readStdin();
+    void onDataReceived(const QByteArray &data);
+
+private:
+    bool configure(const QCommandLineParser &parser);
+    int runLoopbackTest(const QCommandLineParser &parser);
+    void writeTimestamped(const QByteArray &data);
+
+private:
+    Format m_format;
+    bool m_lineStart;
+
+    QFile m_output;
+    QSocketNotifier *m_notifier;
+
+    qint64 m_rxBytes;
+    qint64 m_txBytes;
+};
+}
+
+#endif
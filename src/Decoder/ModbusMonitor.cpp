@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Misc/Tracer.h>
+#include <Serial/Manager.h>
+#include <Misc/LatencyMonitor.h>
+#include <Decoder/ModbusMonitor.h>
+
+using namespace Decoder;
+
+/**
+ * Only instance of the class
+ */
+static ModbusMonitor *INSTANCE = nullptr;
+
+/**
+ * Constructor function
+ */
+ModbusMonitor::ModbusMonitor()
+    : m_enabled(false)
+    , m_origin(-1)
+    , m_frameCount(0)
+    , m_crcErrors(0)
+    , m_exceptions(0)
+{
+    // Update the model at most once per frame
+    m_timer.setInterval(16);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &ModbusMonitor::flushFrames);
+
+    // Decode received data
+    auto manager = Serial::Manager::getInstance();
+    connect(manager, &Serial::Manager::dataReceived, this,
+            &ModbusMonitor::onDataReceived);
+
+    // Update the character time when the line configuration changes
+    connect(manager, &Serial::Manager::parityChanged, this,
+            &ModbusMonitor::updateLineConfiguration);
+    connect(manager, &Serial::Manager::baudRateChanged, this,
+            &ModbusMonitor::updateLineConfiguration);
+    connect(manager, &Serial::Manager::dataBitsChanged, this,
+            &ModbusMonitor::updateLineConfiguration);
+    connect(manager, &Serial::Manager::stopBitsChanged, this,
+            &ModbusMonitor::updateLineConfiguration);
+    updateLineConfiguration();
+}
+
+/**
+ * Returns the only instance of the class
+ */
+ModbusMonitor *ModbusMonitor::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new ModbusMonitor;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns @c true if received data is decoded
+ */
+bool ModbusMonitor::enabled() const
+{
+    return m_enabled;
+}
+
+/**
+ * Returns the number of frames decoded since the monitor was cleared
+ */
+qint64 ModbusMonitor::frameCount() const
+{
+    return m_frameCount;
+}
+
+/**
+ * Returns the number of frames with an invalid CRC
+ */
+qint64 ModbusMonitor::crcErrors() const
+{
+    return m_crcErrors;
+}
+
+/**
+ * Returns the number of exception responses
+ */
+qint64 ModbusMonitor::exceptions() const
+{
+    return m_exceptions;
+}
+
+/**
+ * Returns the number of frames in the model
+ */
+int ModbusMonitor::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+
+    return m_frames.count();
+}
+
+/**
+ * Returns the given @a role of the frame at the given @a index, descriptions are only
+ * generated for the rows that are displayed
+ */
+QVariant ModbusMonitor::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_frames.count())
+        return QVariant();
+
+    const int row = index.row();
+    const auto &frame = m_frames.at(row);
+    const quint8 address = frame.data.size() > 0 ? frame.data.at(0) : 0;
+    const quint8 function = frame.data.size() > 1 ? frame.data.at(1) : 0;
+    switch (role)
+    {
+        case TimeRole:
+            return (frame.timestamp - m_origin) / 1e9;
+        case DeltaRole:
+            if (row > 0)
+                return (frame.timestamp - m_frames.at(row - 1).timestamp) / 1e6;
+            return QVariant();
+        case AddressRole:
+            return address;
+        case FunctionRole:
+            return ModbusRtu::functionName(function);
+        case TypeRole:
+            switch (frame.type)
+            {
+                case ModbusRtu::Type::Request:
+                    return tr("Request");
+                case ModbusRtu::Type::Response:
+                    return tr("Response");
+                case ModbusRtu::Type::Echo:
+                    return tr("Request/echo");
+                case ModbusRtu::Type::Exception:
+                    return tr("Exception");
+                default:
+                    return tr("Unknown");
+            }
+        case DetailsRole:
+            return ModbusRtu::details(frame);
+        case CrcValidRole:
+            return frame.crcValid;
+        case DataRole:
+            return QString(frame.data.toHex(' ').toUpper());
+        default:
+            return QVariant();
+    }
+}
+
+/**
+ * Returns the names of the roles used by the QML delegates
+ */
+QHash<int, QByteArray> ModbusMonitor::roleNames() const
+{
+    QHash<int, QByteArray> names;
+    names.insert(TimeRole, "time");
+    names.insert(DeltaRole, "delta");
+    names.insert(AddressRole, "address");
+    names.insert(FunctionRole, "functionName");
+    names.insert(TypeRole, "type");
+    names.insert(DetailsRole, "details");
+    names.insert(CrcValidRole, "crcValid");
+    names.insert(DataRole, "frameData");
+    return names;
+}
+
+/**
+ * Removes all frames & resets the counters
+ */
+void ModbusMonitor::clear()
+{
+    beginResetModel();
+    m_frames.clear();
+    m_pending.clear();
+    m_decoder.reset();
+    m_origin = -1;
+    m_frameCount = 0;
+    m_crcErrors = 0;
+    m_exceptions = 0;
+    endResetModel();
+
+    emit countersChanged();
+}
+
+/**
+ * Enables or disables decoding received data
+ */
+void ModbusMonitor::setEnabled(const bool enabled)
+{
+    if (m_enabled == enabled)
+        return;
+
+    m_enabled = enabled;
+    m_decoder.reset();
+
+    if (enabled)
+        m_timer.start();
+    else
+        m_timer.stop();
+
+    emit enabledChanged();
+}
+
+/**
+ * Closes the last frame if the line is silent & adds the decoded frames to the model
+ */
+void ModbusMonitor::flushFrames()
+{
+    // Close the last frame of a burst
+    m_decoder.flush(Misc::LatencyMonitor::timestamp(), m_pending);
+    if (m_pending.isEmpty())
+        return;
+
+    TRACE_SCOPE("ModbusMonitor::flushFrames", "decoder");
+
+    // Update counters
+    if (m_origin < 0)
+        m_origin = m_pending.first().timestamp;
+
+    foreach (auto frame, m_pending)
+    {
+        ++m_frameCount;
+        if (!frame.crcValid)
+            ++m_crcErrors;
+        else if (frame.type == ModbusRtu::Type::Exception)
+            ++m_exceptions;
+    }
+
+    // Append frames
+    const int count = m_frames.count();
+    beginInsertRows(QModelIndex(), count, count + m_pending.count() - 1);
+    m_frames.append(m_pending);
+    m_pending.clear();
+    endInsertRows();
+
+    // Remove old frames
+    const int excess = m_frames.count() - MaxFrames;
+    if (excess > 0)
+    {
+        beginRemoveRows(QModelIndex(), 0, excess - 1);
+        m_frames.remove(0, excess);
+        endRemoveRows();
+    }
+
+    emit countersChanged();
+}
+
+/**
+ * Calculates the character time from the configuration of the serial port
+ */
+void ModbusMonitor::updateLineConfiguration()
+{
+    auto manager = Serial::Manager::getInstance();
+
+    // Start bit, data bits, parity bit & stop bits (1.5 stop bits are rounded up)
+    int bits = 1 + static_cast<int>(manager->dataBits());
+    if (manager->parity() != QSerialPort::NoParity)
+        ++bits;
+    if (manager->stopBits() == QSerialPort::OneStop)
+        ++bits;
+    else
+        bits += 2;
+
+    m_decoder.setLineConfiguration(manager->baudRate(), bits);
+}
+
+/**
+ * Decodes the given @a data with the time at which it was read from the device
+ */
+void ModbusMonitor::onDataReceived(const QByteArray &data)
+{
+    if (!m_enabled)
+        return;
+
+    TRACE_SCOPE("ModbusMonitor::decode", "decoder");
+
+    auto timestamp = Serial::Manager::getInstance()->readTimestamp();
+    m_decoder.process(data.constData(), data.size(), timestamp, m_pending);
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef DECODER_MODBUS_MONITOR_H
+#define DECODER_MODBUS_MONITOR_H
+
+#include <QTimer>
+#include <QVector>
+#include <QAbstractListModel>
+
+#include <Decoder/ModbusRtu.h>
+
+namespace Decoder
+{
+/**
+ * Decodes the data received by @c Serial::Manager as Modbus RTU frames & exposes the
+ * last @c MaxFrames frames as a list model for the decoder window.
+ *
+ * Each chunk is passed to @c ModbusRtu with the time at which it was read from the
+ * device (see @c Serial::Manager::readTimestamp()), so frames are delimited with the
+ * timing of the serial line instead of the timing of the user interface. The character
+ * time is obtained from the baud rate, data bits, parity & stop bits of the port.
+ * Decoded frames are added to the model at most once per frame.
+ *
+ * Decoding is disabled by default, it is enabled while the decoder window is visible.
+ */
+class ModbusMonitor : public QAbstractListModel
+{
+    // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool enabled
+               READ enabled
+               WRITE setEnabled
+               NOTIFY enabledChanged)
+    Q_PROPERTY(qint64 frameCount
+               READ frameCount
+               NOTIFY countersChanged)
+    Q_PROPERTY(qint64 crcErrors
+               READ crcErrors
+               NOTIFY countersChanged)
+    Q_PROPERTY(qint64 exceptions
+               READ exceptions
+               NOTIFY countersChanged)
+    // clang-format on
+
+signals:
+    void enabledChanged();
+    void countersChanged();
+
+public:
+    static const int MaxFrames = 10000;
+
+    enum Roles
+    {
+        TimeRole = Qt::UserRole + 1,
+        DeltaRole,
+        AddressRole,
+        FunctionRole,
+        TypeRole,
+        DetailsRole,
+        CrcValidRole,
+        DataRole
+    };
+
+    static ModbusMonitor *getInstance();
+
+    bool enabled() const;
+    qint64 frameCount() const;
+    qint64 crcErrors() const;
+    qint64 exceptions() const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+public slots:
+    void clear();
+    void setEnabled(const bool enabled);
+
+private slots:
+    void flushFrames();
+    void updateLineConfiguration();
+    void onDataReceived(const QByteArray &data);
+
+private:
+    ModbusMonitor();
+
+private:
+    bool m_enabled;
+    QTimer m_timer;
+    ModbusRtu m_decoder;
+
+    qint64 m_origin;
+    qint64 m_frameCount;
+    qint64 m_crcErrors;
+    qint64 m_exceptions;
+
+    QVector<ModbusRtu::Frame> m_frames;
+    QVector<ModbusRtu::Frame> m_pending;
+};
+}
+
+#endif
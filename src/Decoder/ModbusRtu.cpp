@@ -0,0 +1,558 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QStringList>
+
+#include <Decoder/ModbusRtu.h>
+
+using namespace Decoder;
+
+/**
+ * Lookup table of the CRC-16/MODBUS algorithm (reflected polynomial 0xA001)
+ */
+static const quint16 CRC_TABLE[256] = {
+    0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+    0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+    0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+    0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+    0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+    0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+    0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+    0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+    0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+    0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+    0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+    0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+    0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+    0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+    0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+    0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+    0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+    0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+    0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+    0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+    0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+    0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+    0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+    0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+    0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+    0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+    0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+    0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+    0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+    0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+    0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+    0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040
+};
+
+/**
+ * Silent interval used to delimit frames above 19200 baud (Modbus over serial line
+ * specification, section 2.5.1.1)
+ */
+static const qint64 FIXED_FRAME_GAP = 1750 * 1000;
+
+/**
+ * Maximum number of registers listed by @c ModbusRtu::details()
+ */
+static const int MAX_LISTED_VALUES = 32;
+
+/**
+ * Constructor function, the line is configured for 9600 baud & 10 bits per character
+ */
+ModbusRtu::ModbusRtu()
+    : m_offset(0)
+    , m_scanned(0)
+    , m_lastByte(0)
+    , m_frameStart(0)
+    , m_frameGap(0)
+    , m_characterTime(0)
+{
+    setLineConfiguration(9600, 10);
+}
+
+/**
+ * Returns the silent interval (in nanoseconds) that delimits two frames
+ */
+qint64 ModbusRtu::frameGap() const
+{
+    return m_frameGap;
+}
+
+/**
+ * Returns the time (in nanoseconds) needed to transmit a character
+ */
+qint64 ModbusRtu::characterTime() const
+{
+    return m_characterTime;
+}
+
+/**
+ * Calculates the character time & the frame gap for the given @a baudRate, where
+ * @a bitsPerCharacter includes the start, parity & stop bits
+ */
+void ModbusRtu::setLineConfiguration(const qint32 baudRate, const int bitsPerCharacter)
+{
+    const qint32 baud = qMax(1, baudRate);
+    m_characterTime = Q_INT64_C(1000000000) * bitsPerCharacter / baud;
+    if (baud > 19200)
+        m_frameGap = FIXED_FRAME_GAP;
+    else
+        m_frameGap = m_characterTime * 7 / 2;
+}
+
+/**
+ * Discards buffered data
+ */
+void ModbusRtu::reset()
+{
+    m_offset = 0;
+    m_scanned = 0;
+    m_pending.clear();
+    m_buffer.clear();
+    m_lastByte = 0;
+    m_frameStart = 0;
+}
+
+/**
+ * Appends the given @a data, read from the device at the given @a timestamp (in
+ * nanoseconds), & writes the completed frames to @a frames.
+ */
+void ModbusRtu::process(const char *data, const int size, const qint64 timestamp,
+                        QVector<Frame> &frames)
+{
+    if (size <= 0)
+        return;
+
+    // Close the current frame if the line was silent before the first byte of the chunk
+    const qint64 start = timestamp - size * m_characterTime;
+    flush(start, frames);
+
+    // Register data
+    if (m_buffer.isEmpty())
+        m_frameStart = qMax(start, m_lastByte);
+
+    m_buffer.append(data, size);
+    m_lastByte = timestamp;
+
+    // Split frames that were read together
+    splitFrames(frames);
+}
+
+/**
+ * Closes the current frame if the line has been silent since its last byte until the
+ * given @a timestamp, should be called periodically so that the last frame of a burst
+ * is not kept until new data is received.
+ */
+void ModbusRtu::flush(const qint64 timestamp, QVector<Frame> &frames)
+{
+    if (m_buffer.isEmpty())
+        return;
+
+    int length;
+    Type type;
+    bool incomplete;
+    frameLength(0, length, type, incomplete);
+
+    const qint64 gap = timestamp - m_lastByte;
+    if (gap > m_frameGap && (!incomplete || gap > IdleTimeout))
+    {
+        appendFrame(m_buffer.size(), Type::Unknown, frames);
+        m_buffer.clear();
+        m_pending.clear();
+        m_scanned = 0;
+        m_offset = 0;
+    }
+}
+
+/**
+ * Calculates the CRC-16 of the given @a data (as transmitted, low byte first)
+ */
+quint16 ModbusRtu::crc16(const char *data, const int size)
+{
+    quint16 crc = 0xFFFF;
+    const auto bytes = reinterpret_cast<const quint8 *>(data);
+    for (int i = 0; i < size; ++i)
+        crc = (crc >> 8) ^ CRC_TABLE[(crc ^ bytes[i]) & 0xFF];
+
+    return crc;
+}
+
+/**
+ * Returns the name of the given public @a function code
+ */
+QString ModbusRtu::functionName(const quint8 function)
+{
+    switch (function & 0x7F)
+    {
+        case 1:
+            return QStringLiteral("Read Coils");
+        case 2:
+            return QStringLiteral("Read Discrete Inputs");
+        case 3:
+            return QStringLiteral("Read Holding Registers");
+        case 4:
+            return QStringLiteral("Read Input Registers");
+        case 5:
+            return QStringLiteral("Write Single Coil");
+        case 6:
+            return QStringLiteral("Write Single Register");
+        case 7:
+            return QStringLiteral("Read Exception Status");
+        case 8:
+            return QStringLiteral("Diagnostics");
+        case 11:
+            return QStringLiteral("Get Comm Event Counter");
+        case 12:
+            return QStringLiteral("Get Comm Event Log");
+        case 15:
+            return QStringLiteral("Write Multiple Coils");
+        case 16:
+            return QStringLiteral("Write Multiple Registers");
+        case 17:
+            return QStringLiteral("Report Server ID");
+        case 22:
+            return QStringLiteral("Mask Write Register");
+        case 23:
+            return QStringLiteral("Read/Write Multiple Registers");
+        default:
+            return QStringLiteral("Function %1").arg(function & 0x7F);
+    }
+}
+
+/**
+ * Returns a description of the fields of the given @a frame (without the address &
+ * the function code), such as the start address & quantity of a request or the values
+ * of the registers of a response.
+ */
+QString ModbusRtu::details(const Frame &frame)
+{
+    // Get payload (without address, function code & CRC)
+    const int size = frame.data.size() - 4;
+    const auto pdu = reinterpret_cast<const quint8 *>(frame.data.constData()) + 2;
+    if (size < 0)
+        return frame.data.toHex(' ');
+
+    auto word = [=](const int i) { return (pdu[i] << 8) | pdu[i + 1]; };
+    auto words = [=](const int first, const int count) {
+        QStringList list;
+        for (int i = 0; i < count && i < MAX_LISTED_VALUES; ++i)
+            list.append(QString::number(word(first + i * 2)));
+
+        if (count > MAX_LISTED_VALUES)
+            list.append(QStringLiteral("..."));
+
+        return list.join(' ');
+    };
+
+    // Exception responses
+    const quint8 function = static_cast<quint8>(frame.data.at(1));
+    if (frame.type == Type::Exception && size >= 1)
+    {
+        static const char *EXCEPTIONS[] = { "",
+                                            "Illegal Function",
+                                            "Illegal Data Address",
+                                            "Illegal Data Value",
+                                            "Server Device Failure",
+                                            "Acknowledge",
+                                            "Server Device Busy",
+                                            "",
+                                            "Memory Parity Error",
+                                            "",
+                                            "Gateway Path Unavailable",
+                                            "Gateway Target Device Failed to Respond" };
+
+        const quint8 code = pdu[0];
+        const char *name = code < 12 ? EXCEPTIONS[code] : "";
+        return QStringLiteral("Exception %1 %2").arg(code).arg(QLatin1String(name));
+    }
+
+    // Read requests & write responses (start address & quantity)
+    const bool request = frame.type == Type::Request;
+    const bool response = frame.type == Type::Response;
+    if ((request && function >= 1 && function <= 4 && size == 4)
+        || (response && (function == 15 || function == 16) && size == 4))
+    {
+        return QStringLiteral("start=%1 quantity=%2").arg(word(0)).arg(word(2));
+    }
+
+    // Register values of read responses
+    if (response && (function == 3 || function == 4 || function == 23) && size >= 1)
+        return QStringLiteral("registers=%1").arg(words(1, pdu[0] / 2));
+
+    // Coil & discrete input states of read responses
+    if (response && (function == 1 || function == 2) && size >= 1)
+    {
+        const auto bits = frame.data.mid(3, pdu[0]).toHex(' ');
+        return QStringLiteral("bits=%1").arg(QString(bits));
+    }
+
+    // Single writes (request & echoed response)
+    if (frame.type == Type::Echo && function == 5 && size == 4)
+        return QStringLiteral("coil=%1 value=%2")
+            .arg(word(0))
+            .arg(word(2) == 0xFF00 ? QStringLiteral("ON") : QStringLiteral("OFF"));
+    if (frame.type == Type::Echo && function == 6 && size == 4)
+        return QStringLiteral("register=%1 value=%2").arg(word(0)).arg(word(2));
+
+    // Multiple writes
+    if (request && function == 15 && size >= 5)
+        return QStringLiteral("start=%1 quantity=%2 bits=%3")
+            .arg(word(0))
+            .arg(word(2))
+            .arg(QString(frame.data.mid(7, pdu[4]).toHex(' ')));
+    if (request && function == 16 && size >= 5)
+        return QStringLiteral("start=%1 quantity=%2 registers=%3")
+            .arg(word(0))
+            .arg(word(2))
+            .arg(words(5, pdu[4] / 2));
+
+    // Other functions, show the raw payload
+    return QString(frame.data.mid(2, size).toHex(' '));
+}
+
+/**
+ * Returns @c true if the CRC of the @a length bytes that start at @a offset matches
+ * the CRC transmitted in their last two bytes
+ */
+bool ModbusRtu::crcMatches(const int offset, const int length) const
+{
+    if (length < 4 || offset + length > m_buffer.size())
+        return false;
+
+    const auto data = m_buffer.constData() + offset;
+    const quint16 crc = static_cast<quint8>(data[length - 2])
+        | (static_cast<quint8>(data[length - 1]) << 8);
+    return crc16(data, length - 2) == crc;
+}
+
+/**
+ * Looks for a valid frame at the given @a offset of the buffer, using the lengths of
+ * the requests & responses of the function code & the CRC-16.
+ *
+ * @returns @c true if a frame was found (its @a length & @a type are written), if no
+ *          frame was found, @a incomplete is set when more data is needed to reach the
+ *          expected length of the frame
+ */
+bool ModbusRtu::frameLength(const int offset, int &length, Type &type,
+                            bool &incomplete) const
+{
+    // Address & function code are needed
+    const int available = m_buffer.size() - offset;
+    incomplete = available < 2;
+    if (incomplete)
+        return false;
+
+    // Register the lengths that are valid for the function code
+    int count = 0;
+    int lengths[2];
+    Type types[2];
+    auto add = [&](const int l, const Type t) {
+        lengths[count] = l;
+        types[count] = t;
+        ++count;
+    };
+
+    // Lengths that depend on a byte count that was not received yet
+    bool pending = false;
+    const auto data = reinterpret_cast<const quint8 *>(m_buffer.constData()) + offset;
+    auto byteCount = [&](const int index, const int fixed, const Type t) {
+        if (available > index)
+            add(fixed + data[index], t);
+        else
+            pending = true;
+    };
+
+    const quint8 function = data[1];
+    if (function & 0x80)
+        add(5, Type::Exception);
+    else
+    {
+        switch (function)
+        {
+            case 1:
+            case 2:
+            case 3:
+            case 4:
+                add(8, Type::Request);
+                byteCount(2, 5, Type::Response);
+                break;
+            case 5:
+            case 6:
+            case 8:
+                add(8, Type::Echo);
+                break;
+            case 7:
+                add(4, Type::Request);
+                add(5, Type::Response);
+                break;
+            case 11:
+                add(4, Type::Request);
+                add(8, Type::Response);
+                break;
+            case 12:
+            case 17:
+                add(4, Type::Request);
+                byteCount(2, 5, Type::Response);
+                break;
+            case 15:
+            case 16:
+                add(8, Type::Response);
+                byteCount(6, 9, Type::Request);
+                break;
+            case 22:
+                add(10, Type::Echo);
+                break;
+            case 23:
+                byteCount(2, 5, Type::Response);
+                byteCount(10, 13, Type::Request);
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Use the shortest length with a valid CRC
+    bool found = false;
+    for (int i = 0; i < count; ++i)
+    {
+        if (crcMatches(offset, lengths[i]) && (!found || lengths[i] < length))
+        {
+            found = true;
+            length = lengths[i];
+            type = types[i];
+        }
+    }
+
+    // Wait for more data if the frame may be longer than the received data
+    if (!found)
+    {
+        incomplete = pending;
+        for (int i = 0; i < count; ++i)
+            incomplete |= lengths[i] > available;
+    }
+
+    return found;
+}
+
+/**
+ * Registers the @a length bytes at the current buffer offset as a frame
+ */
+void ModbusRtu::appendFrame(const int length, const Type type, QVector<Frame> &frames)
+{
+    Frame frame;
+    frame.type = type;
+    frame.timestamp = m_frameStart;
+    frame.data = m_buffer.mid(m_offset, length);
+    frame.crcValid = crcMatches(m_offset, length);
+    frames.append(frame);
+
+    m_offset += length;
+    m_frameStart += length * m_characterTime;
+}
+
+/**
+ * Extracts the frames that can be identified by their length & CRC from the buffer
+ */
+void ModbusRtu::splitFrames(QVector<Frame> &frames)
+{
+    int length;
+    Type type;
+    bool incomplete;
+    while (true)
+    {
+        // Extract valid frames
+        while (frameLength(m_offset, length, type, incomplete))
+            appendFrame(length, type, frames);
+
+        // Wait for the rest of the frame or for the frame gap
+        const int available = m_buffer.size() - m_offset;
+        if (incomplete && available < MaxFrameSize)
+            break;
+
+        // The data at the current offset is not a valid frame (e.g. corrupted data or
+        // an unknown function code), resynchronize with the next valid frame
+        const int next = resync(m_offset + qMin(available, MaxFrameSize));
+        if (next >= 0)
+            appendFrame(next - m_offset, Type::Unknown, frames);
+        else if (available >= MaxFrameSize)
+            appendFrame(MaxFrameSize, Type::Unknown, frames);
+        else
+            break;
+    }
+
+    // Remove processed data
+    if (m_offset > 0)
+    {
+        m_buffer.remove(0, m_offset);
+        m_scanned = qMax(0, m_scanned - m_offset);
+        for (int i = 0; i < m_pending.count(); ++i)
+            m_pending[i] -= m_offset;
+
+        m_offset = 0;
+    }
+}
+
+/**
+ * Looks for the first valid frame after the current offset & before @a limit. The
+ * result of the search is kept between calls: positions that cannot start a frame are
+ * never checked again & positions that need more data are checked again when data is
+ * received, so that corrupted data is scanned once instead of once per read.
+ *
+ * @returns the offset of the frame, or -1 if no frame was found
+ */
+int ModbusRtu::resync(const int limit)
+{
+    int length;
+    Type type;
+    bool incomplete;
+
+    // Forget the positions that were already extracted
+    while (!m_pending.isEmpty() && m_pending.first() <= m_offset)
+        m_pending.removeFirst();
+
+    // Check again the positions that needed more data (they precede the new positions)
+    for (int i = 0; i < m_pending.count() && m_pending.at(i) < limit;)
+    {
+        const int position = m_pending.at(i);
+        if (frameLength(position, length, type, incomplete))
+            return position;
+
+        if (incomplete)
+            ++i;
+        else
+            m_pending.remove(i);
+    }
+
+    // Check the positions that were not scanned yet
+    m_scanned = qMax(m_scanned, m_offset + 1);
+    while (m_scanned < limit)
+    {
+        const int position = m_scanned++;
+        if (frameLength(position, length, type, incomplete))
+            return position;
+
+        if (incomplete)
+            m_pending.append(position);
+    }
+
+    return -1;
+}
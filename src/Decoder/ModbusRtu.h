@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef DECODER_MODBUS_RTU_H
+#define DECODER_MODBUS_RTU_H
+
+#include <QString>
+#include <QVector>
+#include <QByteArray>
+
+namespace Decoder
+{
+/**
+ * Splits a Modbus RTU byte stream into frames & decodes them.
+ *
+ * Modbus RTU frames are delimited by a silent interval of 3.5 character times (fixed
+ * to 1.75 ms above 19200 baud). Data is processed with the time at which it was read
+ * from the device: the time at which the first byte of each chunk was received is
+ * estimated from the character time, & a frame is closed when the line was silent for
+ * longer than the frame gap.
+ *
+ * Since the operating system may deliver several frames in a single read, buffered
+ * data is also split at the lengths that are valid for the function code of the frame
+ * (e.g. 8 bytes for a "read holding registers" request) when the CRC-16 matches. A
+ * frame whose length cannot be determined is closed after the frame gap, or after
+ * @c IdleTimeout if its expected length was not reached yet (USB adapters may deliver
+ * the bytes of a frame in several reads). Corrupted data is reported as an invalid
+ * frame that ends where the next valid frame starts, each byte of corrupted data is
+ * checked as the start of a frame only once (or until enough data is received).
+ */
+class ModbusRtu
+{
+public:
+    static const int MaxFrameSize = 256;
+    static const qint64 IdleTimeout = 50 * 1000 * 1000;
+
+    enum class Type
+    {
+        Request,
+        Response,
+        Echo,
+        Exception,
+        Unknown
+    };
+
+    /**
+     * Decoded frame, @c timestamp is the estimated time of its first byte
+     */
+    struct Frame
+    {
+        qint64 timestamp;
+        QByteArray data;
+        bool crcValid;
+        Type type;
+    };
+
+    ModbusRtu();
+
+    qint64 frameGap() const;
+    qint64 characterTime() const;
+    void setLineConfiguration(const qint32 baudRate, const int bitsPerCharacter);
+
+    void reset();
+    void process(const char *data, const int size, const qint64 timestamp,
+                 QVector<Frame> &frames);
+    void flush(const qint64 timestamp, QVector<Frame> &frames);
+
+    static quint16 crc16(const char *data, const int size);
+    static QString functionName(const quint8 function);
+    static QString details(const Frame &frame);
+
+private:
+    bool crcMatches(const int offset, const int length) const;
+    bool frameLength(const int offset, int &length, Type &type, bool &incomplete) const;
+    void appendFrame(const int length, const Type type, QVector<Frame> &frames);
+    void splitFrames(QVector<Frame> &frames);
+    int resync(const int limit);
+
+private:
+    int m_offset;
+    int m_scanned;
+    QVector<int> m_pending;
+    QByteArray m_buffer;
+    qint64 m_lastByte;
+    qint64 m_frameStart;
+    qint64 m_frameGap;
+    qint64 m_characterTime;
+};
+}
+
+#endif
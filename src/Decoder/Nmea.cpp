@@ -0,0 +1,558 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cmath>
+#include <limits>
+#include <string.h>
+
+#include <Decoder/Nmea.h>
+#include <Plot/FieldParser.h>
+
+using namespace Decoder;
+
+/**
+ * Returns the value of the given hexadecimal digit, or -1 if @a c is not a digit
+ */
+static inline int HexValue(const char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+
+    return -1;
+}
+
+/**
+ * Constructor function
+ */
+Nmea::Nmea()
+{
+    reset();
+}
+
+/**
+ * Discards buffered data, counters, the position & the satellite table
+ */
+void Nmea::reset()
+{
+    m_length = 0;
+    m_overflow = false;
+    m_fieldCount = 0;
+    m_typeCount = 0;
+    m_satelliteCount = 0;
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    m_position.timestamp = 0;
+    m_position.time = nan;
+    m_position.date = -1;
+    m_position.latitude = nan;
+    m_position.longitude = nan;
+    m_position.altitude = nan;
+    m_position.geoidSeparation = nan;
+    m_position.speed = nan;
+    m_position.course = nan;
+    m_position.pdop = nan;
+    m_position.hdop = nan;
+    m_position.vdop = nan;
+    m_position.quality = -1;
+    m_position.fixType = -1;
+    m_position.satellites = -1;
+    m_position.valid = false;
+
+    m_counters.sentences = 0;
+    m_counters.checksumErrors = 0;
+    m_counters.malformed = 0;
+}
+
+/**
+ * Appends the given @a data, read from the device at the given @a timestamp, &
+ * decodes the sentences that are completed by it
+ */
+void Nmea::process(const char *data, const int size, const qint64 timestamp)
+{
+    for (int i = 0; i < size; ++i)
+    {
+        const char c = data[i];
+
+        // Start of a new sentence (the previous one was not terminated)
+        if (c == '$' || c == '!')
+        {
+            if (m_length > 0)
+                ++m_counters.malformed;
+
+            m_length = 0;
+            m_overflow = false;
+            m_line[m_length++] = c;
+        }
+
+        // Ignore data between sentences
+        else if (m_length == 0)
+            continue;
+
+        // End of the sentence
+        else if (c == '\r' || c == '\n')
+        {
+            if (m_overflow)
+                ++m_counters.malformed;
+            else
+                processSentence(timestamp);
+
+            m_length = 0;
+            m_overflow = false;
+        }
+
+        // Sentence data
+        else if (m_length < MaxSentenceSize)
+            m_line[m_length++] = c;
+        else
+            m_overflow = true;
+    }
+}
+
+/**
+ * Returns the last position, time & motion reported by the receiver
+ */
+const Nmea::Position &Nmea::position() const
+{
+    return m_position;
+}
+
+/**
+ * Returns the sentence counters
+ */
+const Nmea::Counters &Nmea::counters() const
+{
+    return m_counters;
+}
+
+/**
+ * Returns the number of sentence types received
+ */
+int Nmea::typeCount() const
+{
+    return m_typeCount;
+}
+
+/**
+ * Returns the sentence type with the given @a index
+ */
+const Nmea::Type &Nmea::type(const int index) const
+{
+    Q_ASSERT(index >= 0 && index < m_typeCount);
+    return m_types[index];
+}
+
+/**
+ * Returns the number of satellites in view
+ */
+int Nmea::satelliteCount() const
+{
+    return m_satelliteCount;
+}
+
+/**
+ * Returns the satellite with the given @a index
+ */
+const Nmea::Satellite &Nmea::satellite(const int index) const
+{
+    Q_ASSERT(index >= 0 && index < m_satelliteCount);
+    return m_satellites[index];
+}
+
+/**
+ * Calculates the XOR checksum of the characters between @a begin & @a end (the
+ * characters between the '$' & the '*' of a sentence)
+ */
+quint8 Nmea::checksum(const char *begin, const char *end)
+{
+    quint8 value = 0;
+    for (const char *p = begin; p < end; ++p)
+        value ^= static_cast<quint8>(*p);
+
+    return value;
+}
+
+/**
+ * Validates the buffered sentence, locates its fields & updates the counters, the
+ * position or the satellite table
+ */
+void Nmea::processSentence(const qint64 timestamp)
+{
+    // Locate checksum
+    const char *begin = m_line + 1;
+    const char *end = m_line + m_length;
+    auto star = static_cast<const char *>(memchr(begin, '*', end - begin));
+    if (!star || end - star < 3)
+    {
+        ++m_counters.malformed;
+        return;
+    }
+
+    // Read transmitted checksum
+    const int high = HexValue(star[1]);
+    const int low = HexValue(star[2]);
+    if (high < 0 || low < 0)
+    {
+        ++m_counters.malformed;
+        return;
+    }
+
+    // Locate fields (in place)
+    m_fieldCount = 0;
+    const char *field = begin;
+    for (const char *p = begin; p <= star; ++p)
+    {
+        if (p == star || *p == ',')
+        {
+            if (m_fieldCount < MaxFields)
+            {
+                m_fields[m_fieldCount] = field;
+                m_fieldLengths[m_fieldCount] = static_cast<int>(p - field);
+                ++m_fieldCount;
+            }
+
+            field = p + 1;
+        }
+    }
+
+    // Register the sentence type (e.g. "GPGGA")
+    const int nameLength = m_fieldLengths[0];
+    Type *type = findType(m_fields[0], nameLength);
+    if (!type)
+    {
+        ++m_counters.malformed;
+        return;
+    }
+
+    // Validate checksum
+    ++m_counters.sentences;
+    if (checksum(begin, star) != ((high << 4) | low))
+    {
+        ++m_counters.checksumErrors;
+        ++type->errors;
+        return;
+    }
+
+    // Update sentence type counters
+    if (type->count == 0)
+        type->firstTimestamp = timestamp;
+
+    ++type->count;
+    type->lastTimestamp = timestamp;
+
+    // Decode standard sentences (two-character talker & three-character formatter)
+    const char *name = m_fields[0];
+    if (nameLength != 5 || name[0] == 'P')
+        return;
+
+    const char *formatter = name + 2;
+    if (memcmp(formatter, "GGA", 3) == 0)
+        parseGga(timestamp);
+    else if (memcmp(formatter, "RMC", 3) == 0)
+        parseRmc(timestamp);
+    else if (memcmp(formatter, "GLL", 3) == 0)
+        parseGll(timestamp);
+    else if (memcmp(formatter, "VTG", 3) == 0)
+        parseVtg(timestamp);
+    else if (memcmp(formatter, "GSA", 3) == 0)
+        parseGsa(timestamp);
+    else if (memcmp(formatter, "GSV", 3) == 0)
+        parseGsv(name, timestamp);
+}
+
+/**
+ * Returns the counters of the sentence type with the given @a name, which are
+ * registered if needed (returns @c nullptr if the name is invalid or if the table is
+ * full)
+ */
+Nmea::Type *Nmea::findType(const char *name, const int length)
+{
+    if (length < 2 || length >= static_cast<int>(sizeof(Type::name)))
+        return nullptr;
+
+    // Look for an existing type
+    for (int i = 0; i < m_typeCount; ++i)
+    {
+        Type &type = m_types[i];
+        if (strncmp(type.name, name, length) == 0 && type.name[length] == '\0')
+            return &type;
+    }
+
+    // Register a new type
+    if (m_typeCount >= MaxTypes)
+        return nullptr;
+
+    Type &type = m_types[m_typeCount++];
+    memcpy(type.name, name, length);
+    type.name[length] = '\0';
+    type.count = 0;
+    type.errors = 0;
+    type.firstTimestamp = 0;
+    type.lastTimestamp = 0;
+    return &type;
+}
+
+/**
+ * Parses the given decimal @a field, returns @c false if the field is empty or
+ * invalid
+ */
+bool Nmea::parseNumber(const int field, double &value) const
+{
+    if (field >= m_fieldCount || m_fieldLengths[field] == 0)
+        return false;
+
+    const char *cursor = m_fields[field];
+    const char *end = cursor + m_fieldLengths[field];
+    return Plot::FieldParser::parseNumber(cursor, end, value) && cursor == end;
+}
+
+/**
+ * Parses the given integer @a field, returns @c false if the field is empty or
+ * invalid
+ */
+bool Nmea::parseInteger(const int field, int &value) const
+{
+    double number;
+    if (!parseNumber(field, number))
+        return false;
+
+    value = static_cast<int>(number);
+    return true;
+}
+
+/**
+ * Parses the coordinate in the given @a field (ddmm.mmmm or dddmm.mmmm) & the
+ * hemisphere in the next field, @a value is written in degrees (negative for the
+ * southern & western hemispheres)
+ */
+bool Nmea::parseCoordinate(const int field, double &value) const
+{
+    double raw;
+    if (!parseNumber(field, raw) || field + 1 >= m_fieldCount)
+        return false;
+
+    if (m_fieldLengths[field + 1] != 1)
+        return false;
+
+    const double degrees = std::floor(raw / 100);
+    value = degrees + (raw - degrees * 100) / 60;
+
+    const char hemisphere = m_fields[field + 1][0];
+    if (hemisphere == 'S' || hemisphere == 'W')
+        value = -value;
+
+    return true;
+}
+
+/**
+ * Decodes a GGA sentence (time, position, fix quality, satellites, HDOP & altitude)
+ */
+void Nmea::parseGga(const qint64 timestamp)
+{
+    if (m_fieldCount < 12)
+    {
+        ++m_counters.malformed;
+        return;
+    }
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    Position &p = m_position;
+    p.timestamp = timestamp;
+    if (!parseNumber(1, p.time))
+        p.time = nan;
+    if (!parseCoordinate(2, p.latitude))
+        p.latitude = nan;
+    if (!parseCoordinate(4, p.longitude))
+        p.longitude = nan;
+    if (!parseInteger(6, p.quality))
+        p.quality = -1;
+    if (!parseInteger(7, p.satellites))
+        p.satellites = -1;
+    if (!parseNumber(8, p.hdop))
+        p.hdop = nan;
+    if (!parseNumber(9, p.altitude))
+        p.altitude = nan;
+    if (!parseNumber(11, p.geoidSeparation))
+        p.geoidSeparation = nan;
+}
+
+/**
+ * Decodes a RMC sentence (time, date, status, position, speed & course)
+ */
+void Nmea::parseRmc(const qint64 timestamp)
+{
+    if (m_fieldCount < 10)
+    {
+        ++m_counters.malformed;
+        return;
+    }
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    Position &p = m_position;
+    p.timestamp = timestamp;
+    p.valid = m_fieldLengths[2] == 1 && m_fields[2][0] == 'A';
+    if (!parseNumber(1, p.time))
+        p.time = nan;
+    if (!parseCoordinate(3, p.latitude))
+        p.latitude = nan;
+    if (!parseCoordinate(5, p.longitude))
+        p.longitude = nan;
+    if (!parseNumber(7, p.speed))
+        p.speed = nan;
+    if (!parseNumber(8, p.course))
+        p.course = nan;
+    if (!parseInteger(9, p.date))
+        p.date = -1;
+}
+
+/**
+ * Decodes a GLL sentence (position, time & status)
+ */
+void Nmea::parseGll(const qint64 timestamp)
+{
+    if (m_fieldCount < 7)
+    {
+        ++m_counters.malformed;
+        return;
+    }
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    Position &p = m_position;
+    p.timestamp = timestamp;
+    p.valid = m_fieldLengths[6] == 1 && m_fields[6][0] == 'A';
+    if (!parseCoordinate(1, p.latitude))
+        p.latitude = nan;
+    if (!parseCoordinate(3, p.longitude))
+        p.longitude = nan;
+    if (!parseNumber(5, p.time))
+        p.time = nan;
+}
+
+/**
+ * Decodes a VTG sentence (course over ground & speed in knots)
+ */
+void Nmea::parseVtg(const qint64 timestamp)
+{
+    if (m_fieldCount < 8)
+    {
+        ++m_counters.malformed;
+        return;
+    }
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    Position &p = m_position;
+    p.timestamp = timestamp;
+    if (!parseNumber(1, p.course))
+        p.course = nan;
+    if (!parseNumber(5, p.speed))
+        p.speed = nan;
+}
+
+/**
+ * Decodes a GSA sentence (fix type & dilution of precision)
+ */
+void Nmea::parseGsa(const qint64 timestamp)
+{
+    if (m_fieldCount < 18)
+    {
+        ++m_counters.malformed;
+        return;
+    }
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    Position &p = m_position;
+    p.timestamp = timestamp;
+    if (!parseInteger(2, p.fixType))
+        p.fixType = -1;
+    if (!parseNumber(15, p.pdop))
+        p.pdop = nan;
+    if (!parseNumber(16, p.hdop))
+        p.hdop = nan;
+    if (!parseNumber(17, p.vdop))
+        p.vdop = nan;
+}
+
+/**
+ * Decodes a GSV sentence (up to four satellites in view of the given @a talker, with
+ * their elevation, azimuth & signal-to-noise ratio) & removes the satellites that
+ * were not reported for @c SatelliteTimeout nanoseconds
+ */
+void Nmea::parseGsv(const char *talker, const qint64 timestamp)
+{
+    if (m_fieldCount < 4)
+    {
+        ++m_counters.malformed;
+        return;
+    }
+
+    // Remove satellites that are no longer in view
+    int count = 0;
+    for (int i = 0; i < m_satelliteCount; ++i)
+    {
+        if (timestamp - m_satellites[i].timestamp <= SatelliteTimeout)
+            m_satellites[count++] = m_satellites[i];
+    }
+
+    m_satelliteCount = count;
+
+    // Update satellites (groups of PRN, elevation, azimuth & SNR)
+    for (int field = 4; field + 3 < m_fieldCount; field += 4)
+    {
+        int prn;
+        if (!parseInteger(field, prn))
+            continue;
+
+        // Find satellite
+        Satellite *satellite = nullptr;
+        for (int i = 0; i < m_satelliteCount && !satellite; ++i)
+        {
+            Satellite &s = m_satellites[i];
+            if (s.prn == prn && s.talker[0] == talker[0] && s.talker[1] == talker[1])
+                satellite = &s;
+        }
+
+        // Register satellite
+        if (!satellite)
+        {
+            if (m_satelliteCount >= MaxSatellites)
+                continue;
+
+            satellite = &m_satellites[m_satelliteCount++];
+            satellite->talker[0] = talker[0];
+            satellite->talker[1] = talker[1];
+            satellite->talker[2] = '\0';
+            satellite->prn = prn;
+        }
+
+        // Update values
+        satellite->timestamp = timestamp;
+        if (!parseInteger(field + 1, satellite->elevation))
+            satellite->elevation = -1;
+        if (!parseInteger(field + 2, satellite->azimuth))
+            satellite->azimuth = -1;
+        if (!parseInteger(field + 3, satellite->snr))
+            satellite->snr = -1;
+    }
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef DECODER_NMEA_H
+#define DECODER_NMEA_H
+
+#include <QtGlobal>
+
+namespace Decoder
+{
+/**
+ * Decoder for NMEA-0183 sentences, as transmitted by GNSS receivers.
+ *
+ * Received data is assembled into sentences in a fixed buffer, the XOR checksum of each
+ * sentence is validated & its fields are located in place (no copies), so decoding a
+ * sentence does not allocate memory. GGA, RMC, GLL, VTG, GSA & GSV sentences of any
+ * talker (GP, GN, GL, GA, GB...) update the current position & the satellite table,
+ * all sentence types are counted.
+ *
+ * Sentences with an invalid checksum are counted as checksum errors (& ignored),
+ * sentences without checksum, longer than @c MaxSentenceSize or with missing fields are
+ * counted as malformed.
+ */
+class Nmea
+{
+public:
+    static const int MaxFields = 32;
+    static const int MaxTypes = 32;
+    static const int MaxSatellites = 64;
+    static const int MaxSentenceSize = 128;
+    static const qint64 SatelliteTimeout = Q_INT64_C(10000000000);
+
+    /**
+     * Last position, time & motion reported by the receiver (NaN/-1 if unknown)
+     */
+    struct Position
+    {
+        qint64 timestamp;
+        double time;
+        int date;
+        double latitude;
+        double longitude;
+        double altitude;
+        double geoidSeparation;
+        double speed;
+        double course;
+        double pdop;
+        double hdop;
+        double vdop;
+        int quality;
+        int fixType;
+        int satellites;
+        bool valid;
+    };
+
+    /**
+     * Satellite in view reported by a GSV sentence (-1 if unknown)
+     */
+    struct Satellite
+    {
+        char talker[3];
+        int prn;
+        int elevation;
+        int azimuth;
+        int snr;
+        qint64 timestamp;
+    };
+
+    /**
+     * Number of sentences received for a sentence type (talker & formatter, e.g.
+     * "GPGGA")
+     */
+    struct Type
+    {
+        char name[8];
+        qint64 count;
+        qint64 errors;
+        qint64 firstTimestamp;
+        qint64 lastTimestamp;
+    };
+
+    /**
+     * Sentence counters
+     */
+    struct Counters
+    {
+        qint64 sentences;
+        qint64 checksumErrors;
+        qint64 malformed;
+    };
+
+    Nmea();
+
+    void reset();
+    void process(const char *data, const int size, const qint64 timestamp);
+
+    const Position &position() const;
+    const Counters &counters() const;
+    int typeCount() const;
+    const Type &type(const int index) const;
+    int satelliteCount() const;
+    const Satellite &satellite(const int index) const;
+
+    static quint8 checksum(const char *begin, const char *end);
+
+private:
+    void processSentence(const qint64 timestamp);
+    Type *findType(const char *name, const int length);
+
+    bool parseNumber(const int field, double &value) const;
+    bool parseInteger(const int field, int &value) const;
+    bool parseCoordinate(const int field, double &value) const;
+
+    void parseGga(const qint64 timestamp);
+    void parseRmc(const qint64 timestamp);
+    void parseGll(const qint64 timestamp);
+    void parseVtg(const qint64 timestamp);
+    void parseGsa(const qint64 timestamp);
+    void parseGsv(const char *talker, const qint64 timestamp);
+
+private:
+    int m_length;
+    bool m_overflow;
+    char m_line[MaxSentenceSize];
+
+    int m_fieldCount;
+    const char *m_fields[MaxFields];
+    int m_fieldLengths[MaxFields];
+
+    int m_typeCount;
+    Type m_types[MaxTypes];
+
+    int m_satelliteCount;
+    Satellite m_satellites[MaxSatellites];
+
+    Position m_position;
+    Counters m_counters;
+};
+}
+
+#endif
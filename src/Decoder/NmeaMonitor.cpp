@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cmath>
+
+#include <Misc/Tracer.h>
+#include <Serial/Manager.h>
+#include <Misc/LatencyMonitor.h>
+#include <Decoder/NmeaMonitor.h>
+
+using namespace Decoder;
+
+/**
+ * Only instance of the class
+ */
+static NmeaMonitor *INSTANCE = nullptr;
+
+/**
+ * Returns the given @a value, or an invalid variant (shown as an empty cell) if the
+ * value was not reported by the receiver
+ */
+static QVariant OptionalValue(const double value)
+{
+    if (std::isnan(value))
+        return QVariant();
+
+    return value;
+}
+
+/**
+ * Returns the given @a value, or an invalid variant if the value is negative (not
+ * reported by the receiver)
+ */
+static QVariant OptionalValue(const int value)
+{
+    if (value < 0)
+        return QVariant();
+
+    return value;
+}
+
+/**
+ * Constructor function
+ */
+NmeaMonitor::NmeaMonitor()
+    : m_enabled(false)
+    , m_changed(false)
+{
+    // Update the tables at most once per frame
+    m_timer.setInterval(16);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &NmeaMonitor::updateTables);
+
+    // Decode received data
+    auto manager = Serial::Manager::getInstance();
+    connect(manager, &Serial::Manager::dataReceived, this,
+            &NmeaMonitor::onDataReceived);
+}
+
+/**
+ * Returns the only instance of the class
+ */
+NmeaMonitor *NmeaMonitor::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new NmeaMonitor;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns @c true if received data is decoded
+ */
+bool NmeaMonitor::enabled() const
+{
+    return m_enabled;
+}
+
+/**
+ * Returns the number of sentences received since the monitor was cleared
+ */
+qint64 NmeaMonitor::sentenceCount() const
+{
+    return m_decoder.counters().sentences;
+}
+
+/**
+ * Returns the number of sentences with an invalid checksum
+ */
+qint64 NmeaMonitor::checksumErrors() const
+{
+    return m_decoder.counters().checksumErrors;
+}
+
+/**
+ * Returns the number of sentences without checksum, too long or with missing fields
+ */
+qint64 NmeaMonitor::malformedSentences() const
+{
+    return m_decoder.counters().malformed;
+}
+
+/**
+ * Returns the current fix (time, date, position, altitude, speed, course, quality &
+ * dilution of precision), values that were not reported are invalid
+ */
+QVariantMap NmeaMonitor::position() const
+{
+    return m_position;
+}
+
+/**
+ * Returns the received sentence types, with their count, checksum errors & rate
+ */
+QVariantList NmeaMonitor::types() const
+{
+    return m_types;
+}
+
+/**
+ * Returns the satellites in view, with their elevation, azimuth & SNR
+ */
+QVariantList NmeaMonitor::satellites() const
+{
+    return m_satellites;
+}
+
+/**
+ * Resets the counters, the current fix & the satellite table
+ */
+void NmeaMonitor::clear()
+{
+    m_decoder.reset();
+    m_changed = false;
+    m_position.clear();
+    m_types.clear();
+    m_satellites.clear();
+
+    emit updated();
+}
+
+/**
+ * Enables or disables decoding received data
+ */
+void NmeaMonitor::setEnabled(const bool enabled)
+{
+    if (m_enabled == enabled)
+        return;
+
+    m_enabled = enabled;
+
+    if (enabled)
+        m_timer.start();
+    else
+        m_timer.stop();
+
+    emit enabledChanged();
+}
+
+/**
+ * Rebuilds the tables used by the user interface if new sentences were decoded
+ */
+void NmeaMonitor::updateTables()
+{
+    if (!m_changed)
+        return;
+
+    TRACE_SCOPE("NmeaMonitor::updateTables", "decoder");
+
+    m_changed = false;
+    const qint64 now = Misc::LatencyMonitor::timestamp();
+
+    // Update current fix
+    const auto &p = m_decoder.position();
+    m_position.clear();
+    m_position.insert("time", OptionalValue(p.time));
+    m_position.insert("date", OptionalValue(p.date));
+    m_position.insert("latitude", OptionalValue(p.latitude));
+    m_position.insert("longitude", OptionalValue(p.longitude));
+    m_position.insert("altitude", OptionalValue(p.altitude));
+    m_position.insert("speed", OptionalValue(p.speed));
+    m_position.insert("course", OptionalValue(p.course));
+    m_position.insert("quality", OptionalValue(p.quality));
+    m_position.insert("fixType", OptionalValue(p.fixType));
+    m_position.insert("satellites", OptionalValue(p.satellites));
+    m_position.insert("pdop", OptionalValue(p.pdop));
+    m_position.insert("hdop", OptionalValue(p.hdop));
+    m_position.insert("vdop", OptionalValue(p.vdop));
+    m_position.insert("valid", p.valid);
+
+    // Update sentence types
+    m_types.clear();
+    for (int i = 0; i < m_decoder.typeCount(); ++i)
+    {
+        const auto &type = m_decoder.type(i);
+
+        QVariantMap map;
+        map.insert("name", QString::fromLatin1(type.name));
+        map.insert("count", type.count);
+        map.insert("errors", type.errors);
+        if (type.count > 1)
+        {
+            const double elapsed = (type.lastTimestamp - type.firstTimestamp) / 1e9;
+            map.insert("rate", elapsed > 0 ? (type.count - 1) / elapsed : 0.0);
+            map.insert("age", (now - type.lastTimestamp) / 1e9);
+        }
+
+        m_types.append(map);
+    }
+
+    // Update satellites
+    m_satellites.clear();
+    for (int i = 0; i < m_decoder.satelliteCount(); ++i)
+    {
+        const auto &satellite = m_decoder.satellite(i);
+
+        QVariantMap map;
+        map.insert("talker", QString::fromLatin1(satellite.talker));
+        map.insert("prn", satellite.prn);
+        map.insert("elevation", OptionalValue(satellite.elevation));
+        map.insert("azimuth", OptionalValue(satellite.azimuth));
+        map.insert("snr", OptionalValue(satellite.snr));
+        m_satellites.append(map);
+    }
+
+    emit updated();
+}
+
+/**
+ * Decodes the given @a data with the time at which it was read from the device
+ */
+void NmeaMonitor::onDataReceived(const QByteArray &data)
+{
+    if (!m_enabled)
+        return;
+
+    TRACE_SCOPE("NmeaMonitor::decode", "decoder");
+
+    auto timestamp = Serial::Manager::getInstance()->readTimestamp();
+    m_decoder.process(data.constData(), data.size(), timestamp);
+    m_changed = true;
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef DECODER_NMEA_MONITOR_H
+#define DECODER_NMEA_MONITOR_H
+
+#include <QTimer>
+#include <QObject>
+#include <QVariantMap>
+#include <QVariantList>
+
+#include <Decoder/Nmea.h>
+
+namespace Decoder
+{
+/**
+ * Decodes the data received by @c Serial::Manager as NMEA-0183 sentences & exposes
+ * the sentence counters, the current fix & the satellites in view to the decoder
+ * window.
+ *
+ * Sentences are decoded as they are received (without allocating memory), the
+ * tables used by the user interface are only rebuilt once per frame if new sentences
+ * were decoded.
+ *
+ * Decoding is disabled by default, it is enabled while the decoder window is visible.
+ */
+class NmeaMonitor : public QObject
+{
+    // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool enabled
+               READ enabled
+               WRITE setEnabled
+               NOTIFY enabledChanged)
+    Q_PROPERTY(qint64 sentenceCount
+               READ sentenceCount
+               NOTIFY updated)
+    Q_PROPERTY(qint64 checksumErrors
+               READ checksumErrors
+               NOTIFY updated)
+    Q_PROPERTY(qint64 malformedSentences
+               READ malformedSentences
+               NOTIFY updated)
+    Q_PROPERTY(QVariantMap position
+               READ position
+               NOTIFY updated)
+    Q_PROPERTY(QVariantList types
+               READ types
+               NOTIFY updated)
+    Q_PROPERTY(QVariantList satellites
+               READ satellites
+               NOTIFY updated)
+    // clang-format on
+
+signals:
+    void updated();
+    void enabledChanged();
+
+public:
+    static NmeaMonitor *getInstance();
+
+    bool enabled() const;
+    qint64 sentenceCount() const;
+    qint64 checksumErrors() const;
+    qint64 malformedSentences() const;
+
+    QVariantMap position() const;
+    QVariantList types() const;
+    QVariantList satellites() const;
+
+public slots:
+    void clear();
+    void setEnabled(const bool enabled);
+
+private slots:
+    void updateTables();
+    void onDataReceived(const QByteArray &data);
+
+private:
+    NmeaMonitor();
+
+private:
+    bool m_enabled;
+    bool m_changed;
+    QTimer m_timer;
+    Nmea m_decoder;
+
+    QVariantMap m_position;
+    QVariantList m_types;
+    QVariantList m_satellites;
+};
+}
+
+#endif
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QtMath>
+#include <QtAlgorithms>
+
+#include <Misc/Histogram.h>
+
+using namespace Misc;
+
+/**
+ * Number of sub-buckets for each power of two
+ */
+static const int SUB_BUCKETS = 32;
+
+/**
+ * Largest value that can be recorded
+ */
+static const qint64 MAX_VALUE = (Q_INT64_C(1) << 40) - 1;
+
+/**
+ * Constructor function
+ */
+Histogram::Histogram()
+{
+    reset();
+}
+
+/**
+ * Removes all the recorded values
+ */
+void Histogram::reset()
+{
+    for (int i = 0; i < BucketCount; ++i)
+        m_buckets[i].store(0, std::memory_order_relaxed);
+
+    m_sum = 0;
+    m_max = 0;
+    m_count = 0;
+    m_min = MAX_VALUE;
+}
+
+/**
+ * Registers the given @a value, negative values are registered as 0.
+ */
+void Histogram::record(const qint64 value)
+{
+    const qint64 v = qBound<qint64>(0, value, MAX_VALUE);
+
+    // Update bucket & totals
+    m_buckets[bucketIndex(v)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(static_cast<quint64>(v), std::memory_order_relaxed);
+
+    // Update minimum value
+    qint64 current = m_min.load(std::memory_order_relaxed);
+    while (v < current && !m_min.compare_exchange_weak(current, v))
+        ;
+
+    // Update maximum value
+    current = m_max.load(std::memory_order_relaxed);
+    while (v > current && !m_max.compare_exchange_weak(current, v))
+        ;
+}
+
+/**
+ * Returns the smallest recorded value
+ */
+qint64 Histogram::min() const
+{
+    return count() > 0 ? m_min.load() : 0;
+}
+
+/**
+ * Returns the largest recorded value
+ */
+qint64 Histogram::max() const
+{
+    return m_max.load();
+}
+
+/**
+ * Returns the average of the recorded values
+ */
+double Histogram::mean() const
+{
+    const auto n = count();
+    if (n == 0)
+        return 0;
+
+    return static_cast<double>(m_sum.load()) / n;
+}
+
+/**
+ * Returns the number of recorded values
+ */
+quint64 Histogram::count() const
+{
+    return m_count.load();
+}
+
+/**
+ * Returns the value below which the given @a percentile (0 to 1) of the recorded values
+ * fall, with the precision of the bucket that contains it.
+ */
+qint64 Histogram::percentile(const double percentile) const
+{
+    // Get number of values below the percentile
+    const auto total = count();
+    if (total == 0)
+        return 0;
+
+    const double p = qBound(0.0, percentile, 1.0);
+    const auto target = qMax<quint64>(1, static_cast<quint64>(qCeil(p * total)));
+
+    // Find the bucket that contains the percentile
+    quint64 cumulative = 0;
+    for (int i = 0; i < BucketCount; ++i)
+    {
+        cumulative += bucketCount(i);
+        if (cumulative >= target)
+            return qMin(bucketUpperValue(i), max());
+    }
+
+    return max();
+}
+
+/**
+ * Returns the largest value that is stored in the bucket with the given @a index
+ */
+qint64 Histogram::bucketUpperValue(const int index)
+{
+    if (index < 2 * SUB_BUCKETS)
+        return index;
+
+    const int shift = index / SUB_BUCKETS - 1;
+    const qint64 mantissa = index % SUB_BUCKETS + SUB_BUCKETS;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+/**
+ * Returns the number of values stored in the bucket with the given @a index
+ */
+quint64 Histogram::bucketCount(const int index) const
+{
+    Q_ASSERT(index >= 0 && index < BucketCount);
+    return m_buckets[index].load(std::memory_order_relaxed);
+}
+
+/**
+ * Returns the index of the bucket in which the given @a value is stored
+ */
+int Histogram::bucketIndex(const qint64 value)
+{
+    if (value < 2 * SUB_BUCKETS)
+        return static_cast<int>(value);
+
+    const int msb = 63 - qCountLeadingZeroBits(static_cast<quint64>(value));
+    const int shift = msb - 5;
+    return shift * SUB_BUCKETS + static_cast<int>(value >> shift);
+}
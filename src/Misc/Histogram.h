@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MISC_HISTOGRAM_H
+#define MISC_HISTOGRAM_H
+
+#include <atomic>
+#include <QtGlobal>
+
+namespace Misc
+{
+/**
+ * Lock-free, HDR-style histogram for positive integer values (such as latencies in
+ * nanoseconds).
+ *
+ * Values are stored in log-linear buckets: values below 64 have their own bucket and
+ * larger values are grouped in 32 sub-buckets for each power of two, which gives a
+ * maximum relative error of ~3% for any recorded value. Values larger than ~18 minutes
+ * (2^40 ns) are clamped.
+ *
+ * @c record() can be called from any thread.
+ */
+class Histogram
+{
+public:
+    Histogram();
+
+    void reset();
+    void record(const qint64 value);
+
+    qint64 min() const;
+    qint64 max() const;
+    double mean() const;
+    quint64 count() const;
+    qint64 percentile(const double percentile) const;
+
+    static const int BucketCount = 1152;
+    static qint64 bucketUpperValue(const int index);
+    quint64 bucketCount(const int index) const;
+
+private:
+    static int bucketIndex(const qint64 value);
+
+private:
+    std::atomic<quint64> m_count;
+    std::atomic<quint64> m_sum;
+    std::atomic<qint64> m_min;
+    std::atomic<qint64> m_max;
+    std::atomic<quint64> m_buckets[BucketCount];
+};
+}
+
+#endif
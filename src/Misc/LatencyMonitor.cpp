@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QFile>
+#include <QDebug>
+#include <QDateTime>
+#include <QTextStream>
+#include <QElapsedTimer>
+
+#include <AppInfo.h>
+#include <Misc/LatencyMonitor.h>
+
+using namespace Misc;
+
+/**
+ * Pointer to the only instance of the class
+ */
+static LatencyMonitor *INSTANCE = nullptr;
+
+/**
+ * Number of pipeline stages
+ */
+static const int STAGE_COUNT = 4;
+
+/**
+ * Constructor function
+ */
+LatencyMonitor::LatencyMonitor()
+    : m_lastCount(0)
+{
+    // Update percentiles @ 1 Hz
+    connect(&m_timer, &QTimer::timeout, this, &LatencyMonitor::updatePercentiles);
+    m_timer.start(1000);
+}
+
+/**
+ * Returns the only instance of the class
+ */
+LatencyMonitor *LatencyMonitor::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new LatencyMonitor;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns the number of nanoseconds elapsed since the application started, using a
+ * monotonic clock. This function is thread-safe.
+ */
+qint64 LatencyMonitor::timestamp()
+{
+    static const QElapsedTimer CLOCK = []() {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }();
+
+    return CLOCK.nsecsElapsed();
+}
+
+/**
+ * Returns a map with the latency percentiles of each stage (in microseconds), e.g:
+ *
+ * { "read": { "count": 120, "p50": 12.1, "p99": 40.3, "p999": 80.2, "max": 91.1 }, ... }
+ */
+QVariantMap LatencyMonitor::percentiles() const
+{
+    QVariantMap map;
+    for (int i = 0; i < STAGE_COUNT; ++i)
+    {
+        const auto stage = static_cast<Stage>(i);
+        const auto &h = histogram(stage);
+
+        QVariantMap values;
+        values.insert("count", h.count());
+        values.insert("mean", h.mean() / 1000);
+        values.insert("p50", h.percentile(0.5) / 1000.0);
+        values.insert("p99", h.percentile(0.99) / 1000.0);
+        values.insert("p999", h.percentile(0.999) / 1000.0);
+        values.insert("max", h.max() / 1000.0);
+        map.insert(stageName(stage), values);
+    }
+
+    return map;
+}
+
+/**
+ * Returns the histogram used to register the latencies of the given @a stage
+ */
+const Histogram &LatencyMonitor::histogram(const Stage stage) const
+{
+    return m_histograms[static_cast<int>(stage)];
+}
+
+/**
+ * Writes the latency distribution of each stage to the file at the given @a path.
+ * The output format is similar to the one used by HdrHistogram: for each stage, a
+ * summary is written, followed by one line for each non-empty bucket with the bucket
+ * value (in microseconds), the cumulative percentile & the cumulative count.
+ *
+ * @returns @c true on success
+ */
+bool LatencyMonitor::dump(const QString &path) const
+{
+    // Open file
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate | QFile::Text))
+    {
+        qWarning() << "Cannot write latency report" << file.errorString();
+        return false;
+    }
+
+    // Write header
+    QTextStream out(&file);
+    out << "# " << APP_NAME << " " << APP_VERSION << " latency report, "
+        << QDateTime::currentDateTime().toString(Qt::ISODate) << "\n";
+
+    // Write distribution of each stage
+    for (int i = 0; i < STAGE_COUNT; ++i)
+    {
+        const auto stage = static_cast<Stage>(i);
+        const auto &h = histogram(stage);
+        const auto total = h.count();
+
+        // Write summary
+        out << "\n# Stage: " << stageName(stage) << "\n";
+        out << "# Count: " << total << ", Mean: " << h.mean() / 1000
+            << " us, p50: " << h.percentile(0.5) / 1000.0
+            << " us, p99: " << h.percentile(0.99) / 1000.0
+            << " us, p999: " << h.percentile(0.999) / 1000.0
+            << " us, Max: " << h.max() / 1000.0 << " us\n";
+        out << "#       Value (us)     Percentile     TotalCount\n";
+
+        // Write non-empty buckets
+        quint64 cumulative = 0;
+        for (int j = 0; j < Histogram::BucketCount && total > 0; ++j)
+        {
+            const auto count = h.bucketCount(j);
+            if (count == 0)
+                continue;
+
+            cumulative += count;
+            out << QString("%1 %2 %3\n")
+                       .arg(Histogram::bucketUpperValue(j) / 1000.0, 18, 'f', 3)
+                       .arg(static_cast<double>(cumulative) / total, 14, 'f', 6)
+                       .arg(cumulative, 14);
+        }
+    }
+
+    // Close file
+    file.close();
+    return true;
+}
+
+/**
+ * Removes all the recorded latencies
+ */
+void LatencyMonitor::reset()
+{
+    for (int i = 0; i < STAGE_COUNT; ++i)
+        m_histograms[i].reset();
+
+    m_lastCount = 0;
+    emit percentilesChanged();
+}
+
+/**
+ * Registers the given latency (in @a nsecs) for the given pipeline @a stage. This
+ * function is thread-safe.
+ */
+void LatencyMonitor::record(const Stage stage, const qint64 nsecs)
+{
+    m_histograms[static_cast<int>(stage)].record(nsecs);
+}
+
+/**
+ * Notifies the QML interface if new latencies have been registered
+ */
+void LatencyMonitor::updatePercentiles()
+{
+    quint64 count = 0;
+    for (int i = 0; i < STAGE_COUNT; ++i)
+        count += m_histograms[i].count();
+
+    if (count != m_lastCount)
+    {
+        m_lastCount = count;
+        emit percentilesChanged();
+    }
+}
+
+/**
+ * Returns the name of the given pipeline @a stage
+ */
+QString LatencyMonitor::stageName(const Stage stage)
+{
+    switch (stage)
+    {
+        case Stage::Read:
+            return "read";
+        case Stage::Drain:
+            return "drain";
+        case Stage::Insert:
+            return "insert";
+        case Stage::Commit:
+            return "commit";
+    }
+
+    return "";
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MISC_LATENCY_MONITOR_H
+#define MISC_LATENCY_MONITOR_H
+
+#include <QTimer>
+#include <QObject>
+#include <QVariantMap>
+
+#include <Misc/Histogram.h>
+
+namespace Misc
+{
+/**
+ * Keeps track of the latency of each stage of the data pipeline, from the moment in
+ * which data is read from the device up to the moment in which it is rendered on the
+ * screen:
+ *
+ * - @c Stage::Read   time spent reading data in @c Serial::Manager::onDataReceived()
+ * - @c Stage::Drain  time between the read & @c Serial::Console::displayData()
+ * - @c Stage::Insert time between the read & the end of the text document insertion
+ * - @c Stage::Commit time between the read & the paint call that renders the data
+ *
+ * Percentiles are exposed to the QML interface through the @c percentiles property &
+ * the full distribution can be written to a file with @c dump().
+ */
+class LatencyMonitor : public QObject
+{
+    // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(QVariantMap percentiles
+               READ percentiles
+               NOTIFY percentilesChanged)
+    // clang-format on
+
+signals:
+    void percentilesChanged();
+
+public:
+    enum class Stage
+    {
+        Read,
+        Drain,
+        Insert,
+        Commit
+    };
+    Q_ENUM(Stage)
+
+    static LatencyMonitor *getInstance();
+    static qint64 timestamp();
+
+    QVariantMap percentiles() const;
+    const Histogram &histogram(const Stage stage) const;
+
+    Q_INVOKABLE bool dump(const QString &path) const;
+
+public slots:
+    void reset();
+    void record(const Stage stage, const qint64 nsecs);
+
+private slots:
+    void updatePercentiles();
+
+private:
+    LatencyMonitor();
+    static QString stageName(const Stage stage);
+
+private:
+    QTimer m_timer;
+    quint64 m_lastCount;
+    Histogram m_histograms[4];
+};
+}
+
+#endif
@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QFile>
+#include <QDebug>
+
+#include <Plot/Dataset.h>
+#include <Serial/Console.h>
+#include <Serial/Manager.h>
+#include <Serial/FileTransmission.h>
+#include <Misc/MemoryMonitor.h>
+
+#ifdef Q_OS_LINUX
+#    include <unistd.h>
+#endif
+
+using namespace Misc;
+
+/**
+ * Pointer to the only instance of the class
+ */
+static MemoryMonitor *INSTANCE = nullptr;
+
+/**
+ * Approximate size of the fragment, block & layout data of each text block stored in a
+ * @c QTextDocument (used to estimate the size of the documents).
+ */
+static const qint64 BLOCK_OVERHEAD = 256;
+
+/**
+ * Returns the given number of @a bytes as a human-readable string
+ */
+static QString FormatBytes(const qint64 bytes)
+{
+    if (bytes >= 1024 * 1024)
+        return QString("%1 MB").arg(bytes / (1024.0 * 1024.0), 0, 'f', 2);
+    if (bytes >= 1024)
+        return QString("%1 KB").arg(bytes / 1024.0, 0, 'f', 1);
+
+    return QString("%1 bytes").arg(bytes);
+}
+
+/**
+ * Constructor function
+ */
+MemoryMonitor::MemoryMonitor()
+{
+    // Update values @ 1 Hz
+    connect(&m_timer, &QTimer::timeout, this, &MemoryMonitor::updated);
+    m_timer.start(1000);
+
+    // Configure summary log timer
+    connect(&m_logTimer, &QTimer::timeout, this, &MemoryMonitor::logSummary);
+}
+
+/**
+ * Returns the only instance of the class
+ */
+MemoryMonitor *MemoryMonitor::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new MemoryMonitor;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns the memory reserved by the console's incoming data buffer
+ */
+qint64 MemoryMonitor::consoleDataBuffer() const
+{
+    return Serial::Console::getInstance()->dataBufferSize();
+}
+
+/**
+ * Returns the memory reserved by the console's text buffer
+ */
+qint64 MemoryMonitor::consoleTextBuffer() const
+{
+    return Serial::Console::getInstance()->textBufferSize();
+}
+
+/**
+ * Returns the memory used by the console's command history
+ */
+qint64 MemoryMonitor::consoleHistory() const
+{
+    return Serial::Console::getInstance()->historySize();
+}
+
+/**
+ * Returns the estimated memory used by the text documents of all the terminal widgets
+ */
+qint64 MemoryMonitor::textDocuments() const
+{
+    qint64 bytes = 0;
+    foreach (auto document, m_documents)
+    {
+        if (document)
+        {
+            bytes += document->characterCount() * static_cast<qint64>(sizeof(QChar));
+            bytes += document->blockCount() * BLOCK_OVERHEAD;
+        }
+    }
+
+    return bytes;
+}
+
+/**
+ * Returns the number of bytes stored in the read buffer of the serial port
+ */
+qint64 MemoryMonitor::serialReadBuffer() const
+{
+    auto port = Serial::Manager::getInstance()->port();
+    if (port)
+        return port->bytesAvailable();
+
+    return 0;
+}
+
+/**
+ * Returns the number of bytes waiting to be written to the serial port
+ */
+qint64 MemoryMonitor::serialWriteBuffer() const
+{
+    auto port = Serial::Manager::getInstance()->port();
+    if (port)
+        return port->bytesToWrite();
+
+    return 0;
+}
+
+/**
+ * Returns the memory used by the file transmission stream buffers
+ */
+qint64 MemoryMonitor::fileTransmissionBuffer() const
+{
+    return Serial::FileTransmission::getInstance()->bufferSize();
+}
+
+/**
+ * Returns the memory used by the samples & summaries of the plot history
+ */
+qint64 MemoryMonitor::plotHistory() const
+{
+    if (Plot::Dataset::hasInstance())
+        return Plot::Dataset::getInstance()->memoryUsage();
+
+    return 0;
+}
+
+/**
+ * Returns the sum of all the monitored buffers
+ */
+qint64 MemoryMonitor::total() const
+{
+    return consoleDataBuffer() + consoleTextBuffer() + consoleHistory() + textDocuments()
+        + serialReadBuffer() + serialWriteBuffer() + fileTransmissionBuffer()
+        + plotHistory();
+}
+
+/**
+ * Returns the resident set size of the application process (only available on
+ * GNU/Linux, returns 0 on other operating systems).
+ */
+qint64 MemoryMonitor::residentSetSize() const
+{
+#ifdef Q_OS_LINUX
+    QFile file("/proc/self/statm");
+    if (file.open(QFile::ReadOnly))
+    {
+        auto fields = file.readAll().split(' ');
+        if (fields.count() > 1)
+            return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+    }
+#endif
+
+    return 0;
+}
+
+/**
+ * Returns the number of seconds between each summary log message (0 if disabled)
+ */
+int MemoryMonitor::logInterval() const
+{
+    if (m_logTimer.isActive())
+        return m_logTimer.interval() / 1000;
+
+    return 0;
+}
+
+/**
+ * Returns a human-readable summary of the memory used by each buffer
+ */
+QString MemoryMonitor::summary() const
+{
+    QStringList list;
+    list.append("Console data: " + FormatBytes(consoleDataBuffer()));
+    list.append("Console text: " + FormatBytes(consoleTextBuffer()));
+    list.append("History: " + FormatBytes(consoleHistory()));
+    list.append("Documents: " + FormatBytes(textDocuments()));
+    list.append("Serial RX: " + FormatBytes(serialReadBuffer()));
+    list.append("Serial TX: " + FormatBytes(serialWriteBuffer()));
+    list.append("File stream: " + FormatBytes(fileTransmissionBuffer()));
+    list.append("Plot history: " + FormatBytes(plotHistory()));
+    list.append("Total: " + FormatBytes(total()));
+
+    auto rss = residentSetSize();
+    if (rss > 0)
+        list.append("RSS: " + FormatBytes(rss));
+
+    return list.join(", ");
+}
+
+/**
+ * Writes the memory summary to the application log
+ */
+void MemoryMonitor::logSummary()
+{
+    qDebug().noquote() << "Memory usage:" << summary();
+}
+
+/**
+ * Writes a memory summary to the application log every given number of @a seconds,
+ * a value of 0 disables the summary log.
+ */
+void MemoryMonitor::setLogInterval(const int seconds)
+{
+    if (seconds > 0)
+        m_logTimer.start(seconds * 1000);
+    else
+        m_logTimer.stop();
+
+    emit logIntervalChanged();
+}
+
+/**
+ * Registers the given text @a document, so that its size is included in the memory
+ * accounting. Documents are automatically unregistered when deleted.
+ */
+void MemoryMonitor::registerDocument(QTextDocument *document)
+{
+    // Remove deleted documents
+    for (int i = m_documents.count() - 1; i >= 0; --i)
+    {
+        if (m_documents.at(i).isNull())
+            m_documents.removeAt(i);
+    }
+
+    // Register document
+    if (document)
+        m_documents.append(QPointer<QTextDocument>(document));
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MISC_MEMORY_MONITOR_H
+#define MISC_MEMORY_MONITOR_H
+
+#include <QTimer>
+#include <QObject>
+#include <QPointer>
+#include <QTextDocument>
+
+namespace Misc
+{
+/**
+ * Keeps track of the memory used by each buffer of the application:
+ *
+ * - The console's incoming data buffer (including its reserved capacity)
+ * - The console's text buffer (used to export data)
+ * - The console's command history
+ * - The text documents of the terminal widgets (estimated)
+ * - The read & write buffers of the serial port
+ * - The buffers used by the file transmission stream
+ * - The samples & min/max summaries of the plot history
+ *
+ * Values (in bytes) are updated every second & exposed as properties. Optionally, a
+ * summary can be written to the log periodically (see @c setLogInterval()).
+ */
+class MemoryMonitor : public QObject
+{
+    // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(qint64 consoleDataBuffer
+               READ consoleDataBuffer
+               NOTIFY updated)
+    Q_PROPERTY(qint64 consoleTextBuffer
+               READ consoleTextBuffer
+               NOTIFY updated)
+    Q_PROPERTY(qint64 consoleHistory
+               READ consoleHistory
+               NOTIFY updated)
+    Q_PROPERTY(qint64 textDocuments
+               READ textDocuments
+               NOTIFY updated)
+    Q_PROPERTY(qint64 serialReadBuffer
+               READ serialReadBuffer
+               NOTIFY updated)
+    Q_PROPERTY(qint64 serialWriteBuffer
+               READ serialWriteBuffer
+               NOTIFY updated)
+    Q_PROPERTY(qint64 fileTransmissionBuffer
+               READ fileTransmissionBuffer
+               NOTIFY updated)
+    Q_PROPERTY(qint64 plotHistory
+               READ plotHistory
+               NOTIFY updated)
+    Q_PROPERTY(qint64 total
+               READ total
+               NOTIFY updated)
+    Q_PROPERTY(qint64 residentSetSize
+               READ residentSetSize
+               NOTIFY updated)
+    Q_PROPERTY(int logInterval
+               READ logInterval
+               WRITE setLogInterval
+               NOTIFY logIntervalChanged)
+    // clang-format on
+
+signals:
+    void updated();
+    void logIntervalChanged();
+
+public:
+    static MemoryMonitor *getInstance();
+
+    qint64 consoleDataBuffer() const;
+    qint64 consoleTextBuffer() const;
+    qint64 consoleHistory() const;
+    qint64 textDocuments() const;
+    qint64 serialReadBuffer() const;
+    qint64 serialWriteBuffer() const;
+    qint64 fileTransmissionBuffer() const;
+    qint64 plotHistory() const;
+    qint64 total() const;
+    qint64 residentSetSize() const;
+    int logInterval() const;
+
+    Q_INVOKABLE QString summary() const;
+
+public slots:
+    void logSummary();
+    void setLogInterval(const int seconds);
+    void registerDocument(QTextDocument *document);
+
+private:
+    MemoryMonitor();
+
+private:
+    QTimer m_timer;
+    QTimer m_logTimer;
+    QList<QPointer<QTextDocument>> m_documents;
+};
+}
+
+#endif
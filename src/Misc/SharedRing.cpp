@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <time.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <QDebug>
+
+#include <Misc/Tracer.h>
+#include <Misc/SharedRing.h>
+#include <Serial/Manager.h>
+
+using namespace Misc;
+
+/**
+ * Pointer to the only instance of the class
+ */
+static SharedRing *INSTANCE = nullptr;
+
+/**
+ * Magic number ("QSTR") & version of the memory layout
+ */
+static const quint32 MAGIC = 0x52545351;
+static const quint32 VERSION = 1;
+
+/**
+ * Record types
+ */
+static const quint16 PADDING = 0;
+static const quint16 RX = 1;
+static const quint16 TX = 2;
+
+/**
+ * Size of the record header & alignment of the records
+ */
+static const quint64 RECORD_HEADER_SIZE = 24;
+static const quint64 RECORD_ALIGNMENT = 8;
+
+/**
+ * Header of each record in the data area
+ */
+struct Record
+{
+    quint32 size;
+    quint16 type;
+    quint16 reserved;
+    quint64 sequence;
+    quint64 timestamp;
+};
+
+static_assert(sizeof(Record) == RECORD_HEADER_SIZE, "Unexpected record header size");
+
+/**
+ * Returns the wall-clock time in nanoseconds since the Unix epoch
+ */
+static quint64 WallClock()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<quint64>(ts.tv_sec) * 1000000000ull
+        + static_cast<quint64>(ts.tv_nsec);
+}
+
+/**
+ * Constructor function
+ */
+SharedRing::SharedRing()
+    : m_header(nullptr)
+    , m_data(nullptr)
+    , m_mappedSize(0)
+{
+    static_assert(sizeof(Header) == 64, "Unexpected shared ring header size");
+
+    auto manager = Serial::Manager::getInstance();
+    connect(manager, &Serial::Manager::dataSent, this, &SharedRing::onDataSent);
+    connect(manager, &Serial::Manager::dataReceived, this, &SharedRing::onDataReceived);
+}
+
+/**
+ * Destructor function, removes the shared memory object
+ */
+SharedRing::~SharedRing()
+{
+    close();
+}
+
+/**
+ * Returns the only instance of the class
+ */
+SharedRing *SharedRing::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new SharedRing;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns @c true if the shared memory object is open
+ */
+bool SharedRing::isOpen() const
+{
+    return m_header != nullptr;
+}
+
+/**
+ * Returns the name of the shared memory object (e.g. "/qserialterminal")
+ */
+QString SharedRing::name() const
+{
+    return m_name;
+}
+
+/**
+ * Returns the size of the data area in bytes
+ */
+qint64 SharedRing::capacity() const
+{
+    if (m_header)
+        return static_cast<qint64>(m_header->capacity);
+
+    return 0;
+}
+
+/**
+ * Creates the shared memory object with the given @a name & a data area of at least
+ * @a capacity bytes (rounded up to the next power of two)
+ */
+bool SharedRing::open(const QString &name, const qint64 capacity)
+{
+    close();
+
+    // Shared memory object names must start with a slash
+    m_name = name.startsWith('/') ? name : "/" + name;
+
+    // Round capacity up to a power of two
+    quint64 size = 4096;
+    while (size < static_cast<quint64>(capacity))
+        size <<= 1;
+
+    // Create shared memory object
+    const auto path = m_name.toLocal8Bit();
+    auto fd = shm_open(path.constData(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+    if (fd < 0)
+    {
+        qWarning() << "Cannot create shared memory ring" << m_name << strerror(errno);
+        return false;
+    }
+
+    // Resize & map shared memory object
+    m_mappedSize = sizeof(Header) + size;
+    void *memory = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(m_mappedSize)) == 0)
+        memory = mmap(nullptr, m_mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    ::close(fd);
+    if (memory == MAP_FAILED)
+    {
+        qWarning() << "Cannot map shared memory ring" << m_name << strerror(errno);
+        shm_unlink(path.constData());
+        return false;
+    }
+
+    // Initialize header (the magic number is written last, so that readers that
+    // attach during the initialization see an invalid ring)
+    m_header = static_cast<Header *>(memory);
+    m_data = static_cast<char *>(memory) + sizeof(Header);
+    m_header->magic = 0;
+    m_header->version = VERSION;
+    m_header->headerSize = sizeof(Header);
+    m_header->reserved = 0;
+    m_header->capacity = size;
+    m_header->sequence = 0;
+    m_header->writePosition.store(0, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_header->magic = MAGIC;
+
+    qDebug() << "Publishing data in shared memory ring" << m_name << "(" << size
+             << "bytes )";
+    return true;
+}
+
+/**
+ * Unmaps & removes the shared memory object, readers that already mapped it can still
+ * read the last records
+ */
+void SharedRing::close()
+{
+    if (!m_header)
+        return;
+
+    munmap(m_header, m_mappedSize);
+    shm_unlink(m_name.toLocal8Bit().constData());
+
+    m_header = nullptr;
+    m_data = nullptr;
+    m_mappedSize = 0;
+}
+
+/**
+ * Publishes the @a data written to the device
+ */
+void SharedRing::onDataSent(const QByteArray &data)
+{
+    publish(TX, data);
+}
+
+/**
+ * Publishes the @a data received from the device
+ */
+void SharedRing::onDataReceived(const QByteArray &data)
+{
+    publish(RX, data);
+}
+
+/**
+ * Writes the given @a data as one or more records of the given @a type (blocks larger
+ * than a quarter of the ring are split, so that readers can keep up)
+ */
+void SharedRing::publish(const quint16 type, const QByteArray &data)
+{
+    TRACE_SCOPE("SharedRing::publish", "ipc");
+
+    if (!m_header || data.isEmpty())
+        return;
+
+    const auto timestamp = WallClock();
+    const auto maxSize = m_header->capacity / 4;
+    quint64 offset = 0;
+    const auto total = static_cast<quint64>(data.size());
+    while (offset < total)
+    {
+        const auto size = qMin(maxSize, total - offset);
+        writeRecord(type, timestamp, data.constData() + offset, static_cast<quint32>(size));
+        offset += size;
+    }
+}
+
+/**
+ * Writes a single record & publishes the new write position
+ */
+void SharedRing::writeRecord(const quint16 type, const quint64 timestamp,
+                             const char *data, const quint32 size)
+{
+    const auto capacity = m_header->capacity;
+    auto position = m_header->writePosition.load(std::memory_order_relaxed);
+    auto recordSize = (RECORD_HEADER_SIZE + size + RECORD_ALIGNMENT - 1)
+        & ~(RECORD_ALIGNMENT - 1);
+
+    // Records never wrap around the end of the data area
+    auto offset = position & (capacity - 1);
+    auto remaining = capacity - offset;
+    if (remaining < recordSize)
+    {
+        // Fill the remaining space with a padding record
+        if (remaining >= RECORD_HEADER_SIZE)
+        {
+            auto padding = reinterpret_cast<Record *>(m_data + offset);
+            padding->size = static_cast<quint32>(remaining - RECORD_HEADER_SIZE);
+            padding->type = PADDING;
+            padding->reserved = 0;
+            padding->sequence = m_header->sequence;
+            padding->timestamp = timestamp;
+        }
+
+        position += remaining;
+        offset = 0;
+    }
+
+    // Write record
+    auto record = reinterpret_cast<Record *>(m_data + offset);
+    record->size = size;
+    record->type = type;
+    record->reserved = 0;
+    record->sequence = m_header->sequence++;
+    record->timestamp = timestamp;
+    memcpy(m_data + offset + RECORD_HEADER_SIZE, data, size);
+
+    // Publish record
+    m_header->writePosition.store(position + recordSize, std::memory_order_release);
+}
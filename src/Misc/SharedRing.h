@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MISC_SHARED_RING_H
+#define MISC_SHARED_RING_H
+
+#include <atomic>
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+
+namespace Misc
+{
+/**
+ * Publishes the data received from & sent to the current device in a POSIX shared
+ * memory ring (created with @c shm_open), so that any number of local processes can
+ * follow the live byte stream without sockets or copies through the kernel.
+ *
+ * Memory layout (all integers are little-endian on the supported platforms, i.e.
+ * native byte order):
+ *
+ * @code
+ * offset  size  field
+ * 0       4     magic ("QSTR", 0x52545351)
+ * 4       4     layout version (1)
+ * 8       4     header size (64, the data area starts at this offset)
+ * 12      4     reserved
+ * 16      8     capacity of the data area in bytes (power of two)
+ * 24      8     write position: total number of bytes written to the data area
+ * 32      8     sequence number of the next record
+ * 40      24    reserved
+ * @endcode
+ *
+ * The data area contains records aligned to 8 bytes. Each record starts with a 24-byte
+ * header (payload size as @c uint32, type as @c uint16: 0 = padding, 1 = RX, 2 = TX,
+ * reserved @c uint16, sequence number as @c uint64 & wall-clock timestamp in
+ * nanoseconds since the Unix epoch as @c uint64), followed by the payload & padding
+ * bytes up to the next multiple of 8.
+ *
+ * Records never wrap around the end of the data area: if fewer than 24 bytes remain
+ * before the end, readers continue at offset 0; otherwise a padding record fills the
+ * remaining space.
+ *
+ * Readers keep their own position (starting at the current write position) & consume
+ * records while it is lower than the write position, which is updated with release
+ * semantics after each record is written. The writer never waits for readers: after
+ * copying a record, a reader must check that the write position is at most
+ * @c capacity / 2 bytes ahead of the start of the record (payloads are limited to a
+ * quarter of the capacity), otherwise the record may have been overwritten & the
+ * reader must resynchronize at the current write position. Gaps in the sequence
+ * numbers reveal lost records.
+ */
+class SharedRing : public QObject
+{
+    Q_OBJECT
+
+public:
+    static SharedRing *getInstance();
+
+    bool isOpen() const;
+    QString name() const;
+    qint64 capacity() const;
+
+public slots:
+    bool open(const QString &name, const qint64 capacity);
+    void close();
+
+private slots:
+    void onDataSent(const QByteArray &data);
+    void onDataReceived(const QByteArray &data);
+
+private:
+    struct Header
+    {
+        quint32 magic;
+        quint32 version;
+        quint32 headerSize;
+        quint32 reserved;
+        quint64 capacity;
+        std::atomic<quint64> writePosition;
+        quint64 sequence;
+        quint64 padding[3];
+    };
+
+    SharedRing();
+    ~SharedRing();
+
+    void publish(const quint16 type, const QByteArray &data);
+    void writeRecord(const quint16 type, const quint64 timestamp, const char *data,
+                     const quint32 size);
+
+private:
+    QString m_name;
+    Header *m_header;
+    char *m_data;
+    size_t m_mappedSize;
+};
+}
+
+#endif
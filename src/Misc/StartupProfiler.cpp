@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDebug>
+
+#include <Misc/Tracer.h>
+#include <Misc/LatencyMonitor.h>
+#include <Misc/StartupProfiler.h>
+
+using namespace Misc;
+
+/**
+ * Pointer to the only instance of the class
+ */
+static StartupProfiler *INSTANCE = nullptr;
+
+/**
+ * Constructor function, the startup time is measured from the first call to
+ * @c getInstance() (which should be done at the beginning of @c main())
+ */
+StartupProfiler::StartupProfiler()
+    : m_finished(false)
+    , m_lastMark(LatencyMonitor::timestamp())
+    , m_startupTime(0)
+{
+}
+
+/**
+ * Returns the only instance of the class
+ */
+StartupProfiler *StartupProfiler::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new StartupProfiler;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns @c true if the first frame has been rendered
+ */
+bool StartupProfiler::isFinished() const
+{
+    return m_finished;
+}
+
+/**
+ * Returns the time (in nanoseconds) needed to render the first frame
+ */
+qint64 StartupProfiler::startupTime() const
+{
+    return m_startupTime;
+}
+
+/**
+ * Registers the end of the given sequential @a phase (which must be a string literal),
+ * the phase started at the previous mark.
+ */
+void StartupProfiler::mark(const char *phase)
+{
+    if (m_finished)
+        return;
+
+    const auto now = LatencyMonitor::timestamp();
+    record(phase, m_lastMark, now);
+    m_lastMark = now;
+}
+
+/**
+ * Registers a @a phase (which must be a string literal) that ran between the given
+ * @a start & @a end timestamps (see @c LatencyMonitor::timestamp()).
+ */
+void StartupProfiler::record(const char *phase, const qint64 start, const qint64 end)
+{
+    if (m_finished)
+        return;
+
+    Phase p;
+    p.name = phase;
+    p.start = start;
+    p.end = end;
+    m_phases.append(p);
+}
+
+/**
+ * Registers the first frame, writes the startup summary to the log & adds the startup
+ * phases to the trace. Subsequent calls are ignored.
+ */
+void StartupProfiler::finish()
+{
+    // Stop receiving signals (e.g. frame swaps)
+    if (sender())
+        disconnect(sender(), nullptr, this, nullptr);
+
+    // Startup already finished
+    if (m_finished)
+        return;
+
+    // Register first frame
+    mark("First frame");
+    m_finished = true;
+    m_startupTime = m_lastMark;
+
+    // Write summary to log & trace
+    qDebug() << "Startup time:" << m_startupTime / 1e6 << "ms";
+    foreach (auto phase, m_phases)
+    {
+        qDebug() << " " << phase.name << (phase.end - phase.start) / 1e6 << "ms";
+        if (Tracer::active())
+            Tracer::addEvent(phase.name, "startup", phase.start, phase.end - phase.start);
+    }
+
+    emit finished();
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MISC_STARTUP_PROFILER_H
+#define MISC_STARTUP_PROFILER_H
+
+#include <QList>
+#include <QObject>
+
+namespace Misc
+{
+/**
+ * Measures the time spent in each phase of the application startup (application
+ * object creation, command line parsing, singleton init, QML engine creation, QML
+ * loading, first serial port scan & first frame).
+ *
+ * Sequential phases are registered with @c mark(), which measures the time elapsed
+ * since the previous mark. Phases that run in parallel with the main thread (such as
+ * the first port scan) are registered with @c record().
+ *
+ * Once the first frame is rendered, @c finish() writes a summary to the log & adds the
+ * phases to the trace (if tracing is enabled).
+ */
+class StartupProfiler : public QObject
+{
+    Q_OBJECT
+
+signals:
+    void finished();
+
+public:
+    static StartupProfiler *getInstance();
+
+    bool isFinished() const;
+    qint64 startupTime() const;
+
+    void mark(const char *phase);
+    void record(const char *phase, const qint64 start, const qint64 end);
+
+public slots:
+    void finish();
+
+private:
+    StartupProfiler();
+
+private:
+    struct Phase
+    {
+        const char *name;
+        qint64 start;
+        qint64 end;
+    };
+
+    bool m_finished;
+    qint64 m_lastMark;
+    qint64 m_startupTime;
+    QList<Phase> m_phases;
+};
+}
+
+#endif
@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDebug>
+#include <QJsonDocument>
+
+#include <AppInfo.h>
+#include <Serial/Dispatcher.h>
+#include <Serial/Statistics.h>
+#include <Serial/Subscription.h>
+#include <Misc/StatsServer.h>
+
+using namespace Misc;
+
+/**
+ * Pointer to the only instance of the class
+ */
+static StatsServer *INSTANCE = nullptr;
+
+/**
+ * Maximum size of an HTTP request header, larger requests are rejected
+ */
+static const int MAX_REQUEST_SIZE = 8 * 1024;
+
+/**
+ * Prometheus metric that exposes a value of the serial port statistics
+ */
+struct Metric
+{
+    const char *key;
+    const char *name;
+    const char *type;
+    const char *help;
+};
+
+/**
+ * Metrics exposed by the @c /metrics endpoint (counters end with @c _total)
+ */
+static const Metric METRICS[] = {
+    { "connected", "qserialterminal_connected", "gauge",
+      "Whether the serial port is open (1) or not (0)" },
+    { "rxBytes", "qserialterminal_rx_bytes_total", "counter", "Bytes received" },
+    { "txBytes", "qserialterminal_tx_bytes_total", "counter", "Bytes transmitted" },
+    { "readCalls", "qserialterminal_read_calls_total", "counter",
+      "Reads from the serial port" },
+    { "writeCalls", "qserialterminal_write_calls_total", "counter",
+      "Writes queued for transmission" },
+    { "parityErrors", "qserialterminal_parity_errors_total", "counter",
+      "Parity errors reported by the driver" },
+    { "framingErrors", "qserialterminal_framing_errors_total", "counter",
+      "Framing errors reported by the driver" },
+    { "overrunErrors", "qserialterminal_overrun_errors_total", "counter",
+      "Hardware overruns reported by the driver" },
+    { "bufferOverruns", "qserialterminal_buffer_overruns_total", "counter",
+      "Driver buffer overruns" },
+    { "breakEvents", "qserialterminal_break_events_total", "counter",
+      "Break conditions detected on the line" },
+    { "portErrors", "qserialterminal_port_errors_total", "counter",
+      "Errors reported by QSerialPort" },
+    { "readHighWaterMark", "qserialterminal_read_high_water_mark_bytes", "gauge",
+      "Largest chunk of data read from the device" },
+    { "writeHighWaterMark", "qserialterminal_write_high_water_mark_bytes", "gauge",
+      "Largest number of bytes waiting to be written to the device" },
+    { "rxRate1s", "qserialterminal_rx_rate_1s_bytes_per_second", "gauge",
+      "Receive rate during the last second" },
+    { "rxRate10s", "qserialterminal_rx_rate_10s_bytes_per_second", "gauge",
+      "Receive rate during the last 10 seconds" },
+    { "rxRate60s", "qserialterminal_rx_rate_60s_bytes_per_second", "gauge",
+      "Receive rate during the last 60 seconds" },
+    { "txRate1s", "qserialterminal_tx_rate_1s_bytes_per_second", "gauge",
+      "Transmit rate during the last second" },
+    { "txRate10s", "qserialterminal_tx_rate_10s_bytes_per_second", "gauge",
+      "Transmit rate during the last 10 seconds" },
+    { "txRate60s", "qserialterminal_tx_rate_60s_bytes_per_second", "gauge",
+      "Transmit rate during the last 60 seconds" },
+};
+
+/**
+ * Constructor function
+ */
+StatsServer::StatsServer()
+{
+    connect(&m_server, &QTcpServer::newConnection, this, &StatsServer::onNewConnection);
+}
+
+/**
+ * Returns the only instance of the class
+ */
+StatsServer *StatsServer::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new StatsServer;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns @c true if the server is accepting connections
+ */
+bool StatsServer::isListening() const
+{
+    return m_server.isListening();
+}
+
+/**
+ * Returns the TCP port used by the server
+ */
+quint16 StatsServer::serverPort() const
+{
+    return m_server.serverPort();
+}
+
+/**
+ * Starts accepting connections on the given TCP @a port of the loopback interface
+ */
+bool StatsServer::listen(const quint16 port)
+{
+    close();
+    if (!m_server.listen(QHostAddress::LocalHost, port))
+    {
+        qWarning() << "Cannot start statistics server:" << m_server.errorString();
+        return false;
+    }
+
+    qDebug() << "Statistics available at http://localhost:" << serverPort() << "/stats";
+    return true;
+}
+
+/**
+ * Stops accepting connections
+ */
+void StatsServer::close()
+{
+    if (m_server.isListening())
+        m_server.close();
+}
+
+/**
+ * Configures the sockets of incoming connections
+ */
+void StatsServer::onNewConnection()
+{
+    while (m_server.hasPendingConnections())
+    {
+        auto socket = m_server.nextPendingConnection();
+        connect(socket, &QTcpSocket::readyRead, this, &StatsServer::onReadyRead);
+        connect(socket, &QTcpSocket::disconnected, socket, &QTcpSocket::deleteLater);
+    }
+}
+
+/**
+ * Waits for a complete HTTP request header & sends the corresponding response
+ */
+void StatsServer::onReadyRead()
+{
+    auto socket = qobject_cast<QTcpSocket *>(sender());
+    if (!socket)
+        return;
+
+    // Wait until we receive the complete request header
+    auto request = socket->peek(MAX_REQUEST_SIZE);
+    if (!request.contains("\r\n\r\n"))
+    {
+        if (request.size() >= MAX_REQUEST_SIZE)
+            reply(socket, "431 Request Header Fields Too Large", "text/plain", "");
+
+        return;
+    }
+
+    // Get method & path from request line
+    socket->readAll();
+    auto line = request.left(request.indexOf("\r\n")).split(' ');
+    auto method = line.value(0);
+    auto path = line.value(1);
+
+    // Only GET requests are supported
+    if (method != "GET")
+        reply(socket, "405 Method Not Allowed", "text/plain", "Method not allowed\n");
+
+    // Statistics in JSON format
+    else if (path == "/stats" || path == "/")
+    {
+        auto json = Serial::Statistics::getInstance()->toJson();
+        json.insert("consumers", Serial::Dispatcher::getInstance()->toJson());
+        auto body = QJsonDocument(json).toJson(QJsonDocument::Indented);
+        reply(socket, "200 OK", "application/json", body);
+    }
+
+    // Statistics in Prometheus format
+    else if (path == "/metrics")
+        reply(socket, "200 OK", "text/plain; version=0.0.4", metrics());
+
+    // Unknown path
+    else
+        reply(socket, "404 Not Found", "text/plain", "Not found\n");
+}
+
+/**
+ * Appends the @c HELP & @c TYPE lines of a metric family to the given @a body
+ */
+static void appendHeader(QByteArray &body, const char *name, const char *type,
+                         const char *help)
+{
+    body.append(QByteArray("# HELP ") + name + " " + help + "\n");
+    body.append(QByteArray("# TYPE ") + name + " " + type + "\n");
+}
+
+/**
+ * Escapes the given label @a value for the Prometheus text format
+ */
+static QByteArray escapeLabel(const QString &value)
+{
+    auto escaped = value.toUtf8();
+    escaped.replace('\\', "\\\\").replace('"', "\\\"").replace('\n', "\\n");
+    return escaped;
+}
+
+/**
+ * Returns the serial port statistics in the Prometheus text exposition format
+ */
+QByteArray StatsServer::metrics() const
+{
+    auto json = Serial::Statistics::getInstance()->toJson();
+    auto labels = "{port=\"" + escapeLabel(json.value("port").toString()) + "\"} ";
+
+    QByteArray body;
+    for (const auto &metric : METRICS)
+    {
+        auto value = json.value(metric.key);
+        auto number = value.isBool() ? (value.toBool() ? 1.0 : 0.0) : value.toDouble();
+
+        appendHeader(body, metric.name, metric.type, metric.help);
+        body.append(metric.name + labels + QByteArray::number(number, 'g', 15) + "\n");
+    }
+
+    // Per-consumer queue counters
+    const auto subscriptions = Serial::Dispatcher::getInstance()->subscriptions();
+    appendHeader(body, "qserialterminal_consumer_queued_bytes", "gauge",
+                 "Bytes waiting to be processed by the consumer");
+    foreach (auto subscription, subscriptions)
+    {
+        body.append("qserialterminal_consumer_queued_bytes{consumer=\""
+                    + escapeLabel(subscription->name()) + "\"} "
+                    + QByteArray::number(subscription->queuedBytes()) + "\n");
+    }
+
+    appendHeader(body, "qserialterminal_consumer_dropped_bytes_total", "counter",
+                 "Bytes dropped because the consumer queue was full");
+    foreach (auto subscription, subscriptions)
+    {
+        body.append("qserialterminal_consumer_dropped_bytes_total{consumer=\""
+                    + escapeLabel(subscription->name()) + "\"} "
+                    + QByteArray::number(subscription->droppedBytes()) + "\n");
+    }
+
+    appendHeader(body, "qserialterminal_consumer_dropped_chunks_total", "counter",
+                 "Chunks dropped because the consumer queue was full");
+    foreach (auto subscription, subscriptions)
+    {
+        body.append("qserialterminal_consumer_dropped_chunks_total{consumer=\""
+                    + escapeLabel(subscription->name()) + "\"} "
+                    + QByteArray::number(subscription->droppedChunks()) + "\n");
+    }
+
+    return body;
+}
+
+/**
+ * Writes an HTTP response with the given @a status, @a contentType & @a body to the
+ * @a socket and closes the connection.
+ */
+void StatsServer::reply(QTcpSocket *socket, const QByteArray &status,
+                        const QByteArray &contentType, const QByteArray &body)
+{
+    QByteArray response;
+    response.append("HTTP/1.1 " + status + "\r\n");
+    response.append("Server: " + QByteArray(APP_NAME) + "\r\n");
+    response.append("Content-Type: " + contentType + "\r\n");
+    response.append("Content-Length: " + QByteArray::number(body.size()) + "\r\n");
+    response.append("Connection: close\r\n\r\n");
+    response.append(body);
+
+    socket->write(response);
+    socket->disconnectFromHost();
+}
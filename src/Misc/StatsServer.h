@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MISC_STATS_SERVER_H
+#define MISC_STATS_SERVER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+namespace Misc
+{
+/**
+ * Minimal HTTP server that exposes the serial port statistics (see
+ * @c Serial::Statistics) on localhost, so that monitoring tools can scrape long-running
+ * stations:
+ *
+ * - @c GET /stats returns the statistics as a JSON document
+ * - @c GET /metrics returns the statistics in the Prometheus text format
+ *
+ * The server only accepts connections from the loopback interface and closes each
+ * connection after sending the response.
+ */
+class StatsServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static StatsServer *getInstance();
+
+    bool isListening() const;
+    quint16 serverPort() const;
+
+public slots:
+    bool listen(const quint16 port);
+    void close();
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+
+private:
+    StatsServer();
+    QByteArray metrics() const;
+    void reply(QTcpSocket *socket, const QByteArray &status,
+               const QByteArray &contentType, const QByteArray &body);
+
+private:
+    QTcpServer m_server;
+};
+}
+
+#endif
@@ -0,0 +1,332 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <atomic>
+#include <vector>
+
+#include <QFile>
+#include <QDebug>
+#include <QMutex>
+#include <QThread>
+#include <QCoreApplication>
+
+#include <Misc/Tracer.h>
+#include <Misc/LatencyMonitor.h>
+
+using namespace Misc;
+
+/**
+ * Number of events stored by each thread
+ */
+static const quint64 CAPACITY = 64 * 1024;
+
+/**
+ * Sequence number of an event that is being written
+ */
+static const quint64 WRITING = ~Q_UINT64_C(0);
+
+/**
+ * Trace event, names & categories are string literals, so we only store pointers.
+ *
+ * Events may be overwritten by the recording thread while they are written to a file,
+ * so each event is tagged with a sequence number (its index in the ring plus one),
+ * which is published after the event is written. Readers only keep an event if its
+ * sequence number is the expected one both before & after copying it.
+ */
+struct TraceEvent
+{
+    std::atomic<quint64> sequence;
+    std::atomic<const char *> name;
+    std::atomic<const char *> category;
+    std::atomic<qint64> start;
+    std::atomic<qint64> duration;
+};
+
+/**
+ * Ring buffer of a thread, only the owner thread writes events into it
+ */
+struct ThreadBuffer
+{
+    int tid;
+    QString name;
+    std::atomic<quint64> head;
+    std::atomic<quint64> tail;
+    TraceEvent events[CAPACITY];
+};
+
+/**
+ * Pointer to the only instance of the class
+ */
+static Tracer *INSTANCE = nullptr;
+
+/**
+ * Set to @c true while events are being recorded
+ */
+static std::atomic<bool> ENABLED(false);
+
+/**
+ * Buffers of all the threads that have recorded events (buffers are never deleted)
+ */
+static QMutex BUFFERS_MUTEX;
+static std::vector<ThreadBuffer *> BUFFERS;
+
+/**
+ * Buffer of the current thread
+ */
+static thread_local ThreadBuffer *THREAD_BUFFER = nullptr;
+
+/**
+ * Returns the buffer of the current thread, the buffer is created & registered the
+ * first time that the thread records an event.
+ */
+static ThreadBuffer *CurrentBuffer()
+{
+    if (!THREAD_BUFFER)
+    {
+        // Create buffer
+        auto buffer = new ThreadBuffer;
+        buffer->head = 0;
+        buffer->tail = 0;
+        for (auto &event : buffer->events)
+            event.sequence.store(0, std::memory_order_relaxed);
+
+        // Get thread name
+        auto thread = QThread::currentThread();
+        buffer->name = thread->objectName();
+        if (buffer->name.isEmpty() && qApp && thread == qApp->thread())
+            buffer->name = "Main thread";
+
+        // Register buffer
+        QMutexLocker locker(&BUFFERS_MUTEX);
+        buffer->tid = static_cast<int>(BUFFERS.size()) + 1;
+        if (buffer->name.isEmpty())
+            buffer->name = QString("Thread %1").arg(buffer->tid);
+
+        BUFFERS.push_back(buffer);
+        THREAD_BUFFER = buffer;
+    }
+
+    return THREAD_BUFFER;
+}
+
+/**
+ * Escapes the given @a string so that it can be written in a JSON file
+ */
+static QByteArray JsonString(const QByteArray &string)
+{
+    QByteArray escaped = string;
+    escaped.replace('\\', "\\\\");
+    escaped.replace('"', "\\\"");
+    return '"' + escaped + '"';
+}
+
+/**
+ * Constructor function
+ */
+Tracer::Tracer() { }
+
+/**
+ * Returns the only instance of the class
+ */
+Tracer *Tracer::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new Tracer;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns @c true if events are being recorded. This function is thread-safe.
+ */
+bool Tracer::active()
+{
+    return ENABLED.load(std::memory_order_relaxed);
+}
+
+/**
+ * Registers a complete event for the current thread with the given @a name, @a category,
+ * @a start time & @a duration (both in nanoseconds). This function is thread-safe & does
+ * not block.
+ */
+void Tracer::addEvent(const char *name, const char *category, const qint64 start,
+                      const qint64 duration)
+{
+    auto buffer = CurrentBuffer();
+    auto head = buffer->head.load(std::memory_order_relaxed);
+
+    // Invalidate the slot before overwriting the event
+    auto &event = buffer->events[head % CAPACITY];
+    event.sequence.store(WRITING, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // Write the event
+    event.name.store(name, std::memory_order_relaxed);
+    event.category.store(category, std::memory_order_relaxed);
+    event.start.store(start, std::memory_order_relaxed);
+    event.duration.store(duration, std::memory_order_relaxed);
+
+    // Publish the event
+    event.sequence.store(head + 1, std::memory_order_release);
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+/**
+ * Returns @c true if events are being recorded
+ */
+bool Tracer::enabled() const
+{
+    return active();
+}
+
+/**
+ * Writes the recorded events to the file at the given @a path in the Chrome trace-event
+ * JSON format. Recording can continue while the file is written.
+ *
+ * @returns @c true on success
+ */
+bool Tracer::write(const QString &path) const
+{
+    // Open file
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        qWarning() << "Cannot write trace file" << file.errorString();
+        return false;
+    }
+
+    // Get list of buffers
+    std::vector<ThreadBuffer *> buffers;
+    {
+        QMutexLocker locker(&BUFFERS_MUTEX);
+        buffers = BUFFERS;
+    }
+
+    // Write events of each thread
+    bool first = true;
+    const auto pid = QByteArray::number(QCoreApplication::applicationPid());
+    file.write("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    for (auto buffer : buffers)
+    {
+        const auto tid = QByteArray::number(buffer->tid);
+
+        // Write thread name
+        if (!first)
+            file.write(",\n");
+        file.write("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid
+                   + ",\"tid\":" + tid + ",\"args\":{\"name\":"
+                   + JsonString(buffer->name.toUtf8()) + "}}");
+        first = false;
+
+        // Get range of events stored in the ring
+        const auto head = buffer->head.load(std::memory_order_acquire);
+        auto tail = buffer->tail.load(std::memory_order_relaxed);
+        if (head > CAPACITY)
+            tail = qMax(tail, head - CAPACITY);
+
+        // Write events
+        QByteArray data;
+        for (auto i = tail; i < head; ++i)
+        {
+            // Copy the event, skip it if it was overwritten while copying it
+            const auto &slot = buffer->events[i % CAPACITY];
+            if (slot.sequence.load(std::memory_order_acquire) != i + 1)
+                continue;
+
+            const auto name = slot.name.load(std::memory_order_relaxed);
+            const auto category = slot.category.load(std::memory_order_relaxed);
+            const auto start = slot.start.load(std::memory_order_relaxed);
+            const auto duration = slot.duration.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != i + 1)
+                continue;
+
+            data.append(",\n{\"name\":");
+            data.append(JsonString(name));
+            data.append(",\"cat\":");
+            data.append(JsonString(category));
+            data.append(",\"ph\":\"X\",\"ts\":");
+            data.append(QByteArray::number(start / 1000.0, 'f', 3));
+            data.append(",\"dur\":");
+            data.append(QByteArray::number(duration / 1000.0, 'f', 3));
+            data.append(",\"pid\":" + pid + ",\"tid\":" + tid + "}");
+
+            if (data.size() > 1024 * 1024)
+            {
+                file.write(data);
+                data.clear();
+            }
+        }
+
+        file.write(data);
+    }
+
+    // Close file
+    file.write("\n]}\n");
+    file.close();
+    return true;
+}
+
+/**
+ * Deletes all the recorded events
+ */
+void Tracer::clear()
+{
+    QMutexLocker locker(&BUFFERS_MUTEX);
+    for (auto buffer : BUFFERS)
+        buffer->tail.store(buffer->head.load());
+}
+
+/**
+ * Starts/stops recording events
+ */
+void Tracer::setEnabled(const bool enabled)
+{
+    if (active() != enabled)
+    {
+        ENABLED.store(enabled);
+        emit enabledChanged();
+    }
+}
+
+/**
+ * Constructor function, registers the start time of the scope if the tracer is enabled
+ */
+TraceScope::TraceScope(const char *name, const char *category)
+    : m_name(name)
+    , m_category(category)
+    , m_start(Tracer::active() ? LatencyMonitor::timestamp() : -1)
+{
+}
+
+/**
+ * Destructor function, registers the trace event if the tracer was enabled when the
+ * scope started
+ */
+TraceScope::~TraceScope()
+{
+    if (m_start >= 0)
+    {
+        auto duration = LatencyMonitor::timestamp() - m_start;
+        Tracer::addEvent(m_name, m_category, m_start, duration);
+    }
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MISC_TRACER_H
+#define MISC_TRACER_H
+
+#include <QObject>
+#include <QString>
+
+namespace Misc
+{
+/**
+ * Opt-in tracer that records scoped events in Chrome's trace-event format, so that
+ * stalls in the data pipeline can be inspected with Perfetto or chrome://tracing
+ * without attaching a profiler.
+ *
+ * Each thread writes its events into its own fixed-size ring buffer, no locks are
+ * taken while recording events (the oldest events are overwritten when the buffer is
+ * full, events overwritten while the trace file is written are skipped). Recording has
+ * almost no cost while the tracer is disabled.
+ *
+ * Use the @c TRACE_SCOPE() macro to record the duration of a scope.
+ */
+class Tracer : public QObject
+{
+    // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool enabled
+               READ enabled
+               WRITE setEnabled
+               NOTIFY enabledChanged)
+    // clang-format on
+
+signals:
+    void enabledChanged();
+
+public:
+    static Tracer *getInstance();
+
+    static bool active();
+    static void addEvent(const char *name, const char *category, const qint64 start,
+                         const qint64 duration);
+
+    bool enabled() const;
+    Q_INVOKABLE bool write(const QString &path) const;
+
+public slots:
+    void clear();
+    void setEnabled(const bool enabled);
+
+private:
+    Tracer();
+};
+
+/**
+ * Records the time spent between its construction & its destruction as a trace event
+ * with the given name & category (both must be string literals).
+ */
+class TraceScope
+{
+public:
+    TraceScope(const char *name, const char *category);
+    ~TraceScope();
+
+private:
+    const char *m_name;
+    const char *m_category;
+    qint64 m_start;
+};
+}
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+#define TRACE_SCOPE(name, category)                                                     \
+    Misc::TraceScope TRACE_CONCAT(traceScope, __LINE__)(name, category)
+
+#endif
@@ -23,6 +23,7 @@
 #include "Utilities.h"
 
 #include <QDir>
+#include <QDebug>
 #include <QUrl>
 #include <QPalette>
 #include <QProcess>
@@ -55,6 +56,13 @@ Utilities *Utilities::getInstance()
 int Utilities::showMessageBox(QString text, QString informativeText, QString windowTitle,
                               QMessageBox::StandardButtons bt)
 {
+    // No GUI available (e.g. headless mode), write message to the log
+    if (!qobject_cast<QApplication *>(QCoreApplication::instance()))
+    {
+        qWarning() << qPrintable(text) << qPrintable(informativeText);
+        return QMessageBox::NoButton;
+    }
+
     // Get app icon
     auto icon = QPixmap(APP_ICON).scaled(64, 64, Qt::IgnoreAspectRatio,
                                          Qt::SmoothTransformation);
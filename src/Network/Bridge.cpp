@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QTimer>
+#include <QDebug>
+
+#include <Misc/Tracer.h>
+#include <Network/Bridge.h>
+#include <Serial/Manager.h>
+
+using namespace Network;
+
+/**
+ * Pointer to the only instance of the class
+ */
+static Bridge *INSTANCE = nullptr;
+
+/**
+ * Default size of the queue of each client
+ */
+static const qint64 DEFAULT_QUEUE_CAPACITY = 8 * 1024 * 1024;
+
+/**
+ * Queued data is written to the socket while its write buffer is below this size
+ */
+static const qint64 SOCKET_BUFFER_SIZE = 256 * 1024;
+
+/**
+ * Constructor function
+ */
+Bridge::Bridge()
+    : m_flushScheduled(false)
+    , m_bytesSent(0)
+    , m_bytesReceived(0)
+    , m_slowClients(0)
+    , m_queueCapacity(DEFAULT_QUEUE_CAPACITY)
+    , m_queuePolicy(Serial::Subscription::Policy::Disconnect)
+{
+    connect(&m_server, &QTcpServer::newConnection, this, &Bridge::onNewConnection);
+}
+
+/**
+ * Returns the only instance of the class
+ */
+Bridge *Bridge::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new Bridge;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns @c true if the bridge is accepting connections
+ */
+bool Bridge::isListening() const
+{
+    return m_server.isListening();
+}
+
+/**
+ * Returns the TCP port used by the bridge
+ */
+quint16 Bridge::port() const
+{
+    return m_server.serverPort();
+}
+
+/**
+ * Returns the number of connected clients
+ */
+int Bridge::clientCount() const
+{
+    return m_clients.count();
+}
+
+/**
+ * Returns the number of bytes sent to the clients
+ */
+qint64 Bridge::bytesSent() const
+{
+    return m_bytesSent;
+}
+
+/**
+ * Returns the number of bytes received from the clients
+ */
+qint64 Bridge::bytesReceived() const
+{
+    return m_bytesReceived;
+}
+
+/**
+ * Returns the number of clients disconnected because they did not keep up with the
+ * serial port data rate
+ */
+qint64 Bridge::slowClients() const
+{
+    return m_slowClients;
+}
+
+/**
+ * Changes the @a policy & the @a capacity (in bytes) of the queues of the clients
+ * that connect afterwards
+ */
+void Bridge::setQueuePolicy(const Serial::Subscription::Policy policy,
+                            const qint64 capacity)
+{
+    m_queuePolicy = policy;
+    m_queueCapacity = capacity;
+}
+
+/**
+ * Starts accepting connections on the given TCP @a port & @a address (localhost by
+ * default)
+ */
+bool Bridge::listen(const quint16 port, const QHostAddress &address)
+{
+    close();
+    if (!m_server.listen(address, port))
+    {
+        qWarning() << "Cannot start TCP bridge:" << m_server.errorString();
+        return false;
+    }
+
+    qDebug() << "TCP bridge listening on" << address.toString() << port;
+    emit listeningChanged();
+    return true;
+}
+
+/**
+ * Stops accepting connections & disconnects all the clients
+ */
+void Bridge::close()
+{
+    foreach (auto client, m_clients.keys())
+        client->abort();
+
+    m_server.close();
+    emit listeningChanged();
+}
+
+/**
+ * Writes the data received from all the clients to the serial port
+ */
+void Bridge::flush()
+{
+    TRACE_SCOPE("Bridge::flush", "network");
+
+    m_flushScheduled = false;
+    if (m_txBuffer.isEmpty())
+        return;
+
+    Serial::Manager::getInstance()->writeData(m_txBuffer);
+    m_txBuffer.clear();
+}
+
+/**
+ * Appends the data received from a client to the transmission buffer, the buffer is
+ * written to the serial port in the next event loop iteration
+ */
+void Bridge::onReadyRead()
+{
+    auto client = qobject_cast<QTcpSocket *>(sender());
+    if (!client)
+        return;
+
+    // Read data
+    auto data = client->readAll();
+    m_bytesReceived += data.size();
+    m_txBuffer.append(data);
+
+    // Schedule write
+    if (!m_flushScheduled)
+    {
+        m_flushScheduled = true;
+        QTimer::singleShot(0, this, &Bridge::flush);
+    }
+}
+
+/**
+ * Removes the disconnected client from the client list
+ */
+void Bridge::onDisconnected()
+{
+    auto client = qobject_cast<QTcpSocket *>(sender());
+    if (!client)
+        return;
+
+    qDebug() << "TCP bridge client disconnected:" << client->peerAddress().toString();
+
+    delete m_clients.take(client);
+    client->deleteLater();
+    emit clientCountChanged();
+}
+
+/**
+ * Configures the sockets of incoming connections
+ */
+void Bridge::onNewConnection()
+{
+    while (m_server.hasPendingConnections())
+    {
+        auto client = m_server.nextPendingConnection();
+        client->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        connect(client, &QTcpSocket::readyRead, this, &Bridge::onReadyRead);
+        connect(client, &QTcpSocket::disconnected, this, &Bridge::onDisconnected);
+        connect(client, &QTcpSocket::bytesWritten, this, &Bridge::writeQueuedData);
+
+        // Create the queue of the client
+        auto name = QString("bridge:%1:%2").arg(client->peerAddress().toString())
+                        .arg(client->peerPort());
+        auto queue = new Serial::Subscription(name, m_queuePolicy, m_queueCapacity);
+        connect(queue, &Serial::Subscription::dataAvailable, this,
+                &Bridge::writeQueuedData);
+        connect(queue, &Serial::Subscription::overflowed, this,
+                &Bridge::onQueueOverflowed);
+        m_clients.insert(client, queue);
+
+        qDebug() << "TCP bridge client connected:" << client->peerAddress().toString();
+    }
+
+    emit clientCountChanged();
+}
+
+/**
+ * Disconnects the client whose queue overflowed (with the @c Disconnect policy)
+ */
+void Bridge::onQueueOverflowed()
+{
+    auto queue = qobject_cast<Serial::Subscription *>(sender());
+    auto client = m_clients.key(queue, nullptr);
+    if (!client)
+        return;
+
+    qWarning() << "TCP bridge client too slow:" << client->peerAddress().toString();
+    ++m_slowClients;
+    QTimer::singleShot(0, client, [=]() { client->abort(); });
+}
+
+/**
+ * Writes the queued data of a client while its socket write buffer is below a fixed
+ * size (called when data is queued & when the socket sends data)
+ */
+void Bridge::writeQueuedData()
+{
+    TRACE_SCOPE("Bridge::writeQueuedData", "network");
+
+    // Get client
+    auto client = qobject_cast<QTcpSocket *>(sender());
+    if (!client)
+        client = m_clients.key(qobject_cast<Serial::Subscription *>(sender()), nullptr);
+    if (!client || !m_clients.contains(client))
+        return;
+
+    // Write queued blocks (implicitly shared with the other clients)
+    auto queue = m_clients.value(client);
+    while (!queue->isEmpty() && client->bytesToWrite() < SOCKET_BUFFER_SIZE)
+    {
+        auto data = queue->takeChunk();
+        client->write(data);
+        m_bytesSent += data.size();
+    }
+}
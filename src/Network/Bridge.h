@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NETWORK_BRIDGE_H
+#define NETWORK_BRIDGE_H
+
+#include <QHash>
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostAddress>
+
+#include <Serial/Subscription.h>
+
+namespace Network
+{
+/**
+ * Exposes the serial port opened by @c Serial::Manager on a TCP port (similar to
+ * ser2net), so that several tools can use the same device at the same time:
+ *
+ * - Received data is sent to all connected clients. Each client has its own
+ *   @c Serial::Subscription queue, which is drained whenever the socket write buffer
+ *   is below a fixed size. Queued blocks are shared between clients, Qt appends chunks
+ *   of 4 KB or more to the write buffer of each socket by reference, so large chunks
+ *   are not copied for each client.
+ * - Data written by the clients is merged & written to the serial port once per event
+ *   loop iteration, which keeps the number of write calls low when several clients
+ *   send data at the same time.
+ *
+ * Clients that do not keep up with the data rate are handled with the policy given to
+ * @c setQueuePolicy() (by default, clients are disconnected when their queue exceeds
+ * 8 MB), so that they cannot increase the memory usage of the application without
+ * bounds or stall the other consumers.
+ */
+class Bridge : public QObject
+{
+    // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool listening
+               READ isListening
+               NOTIFY listeningChanged)
+    Q_PROPERTY(quint16 port
+               READ port
+               NOTIFY listeningChanged)
+    Q_PROPERTY(int clientCount
+               READ clientCount
+               NOTIFY clientCountChanged)
+    Q_PROPERTY(qint64 bytesSent
+               READ bytesSent
+               NOTIFY clientCountChanged)
+    Q_PROPERTY(qint64 bytesReceived
+               READ bytesReceived
+               NOTIFY clientCountChanged)
+    Q_PROPERTY(qint64 slowClients
+               READ slowClients
+               NOTIFY clientCountChanged)
+    // clang-format on
+
+signals:
+    void listeningChanged();
+    void clientCountChanged();
+
+public:
+    static Bridge *getInstance();
+
+    bool isListening() const;
+    quint16 port() const;
+    int clientCount() const;
+    qint64 bytesSent() const;
+    qint64 bytesReceived() const;
+    qint64 slowClients() const;
+
+    void setQueuePolicy(const Serial::Subscription::Policy policy,
+                        const qint64 capacity);
+
+public slots:
+    bool listen(const quint16 port,
+                const QHostAddress &address = QHostAddress(QHostAddress::LocalHost));
+    void close();
+
+private slots:
+    void flush();
+    void onReadyRead();
+    void onDisconnected();
+    void onNewConnection();
+    void onQueueOverflowed();
+    void writeQueuedData();
+
+private:
+    Bridge();
+
+private:
+    QTcpServer m_server;
+    QHash<QTcpSocket *, Serial::Subscription *> m_clients;
+
+    qint64 m_queueCapacity;
+    Serial::Subscription::Policy m_queuePolicy;
+
+    QByteArray m_txBuffer;
+    bool m_flushScheduled;
+
+    qint64 m_bytesSent;
+    qint64 m_bytesReceived;
+    qint64 m_slowClients;
+};
+}
+
+#endif
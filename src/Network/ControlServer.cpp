@@ -0,0 +1,786 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QTimer>
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSerialPortInfo>
+
+#include <Misc/Tracer.h>
+#include <Serial/Manager.h>
+#include <Serial/Dispatcher.h>
+#include <Serial/Statistics.h>
+#include <Network/ControlServer.h>
+
+using namespace Network;
+
+/**
+ * Pointer to the only instance of the class
+ */
+static ControlServer *INSTANCE = nullptr;
+
+/**
+ * Clients are disconnected if their write buffer exceeds this size
+ */
+static const qint64 MAX_CLIENT_BUFFER = 8 * 1024 * 1024;
+
+/**
+ * Default size of the queue of each subscription
+ */
+static const qint64 DEFAULT_QUEUE_CAPACITY = 8 * 1024 * 1024;
+
+/**
+ * Queued data is written to the socket while its write buffer is below this size
+ */
+static const qint64 SOCKET_BUFFER_SIZE = 256 * 1024;
+
+/**
+ * Clients are disconnected if they send a request longer than this size
+ */
+static const int MAX_REQUEST_SIZE = 1024 * 1024;
+
+/**
+ * Partial lines longer than this size are processed as complete lines
+ */
+static const int MAX_LINE_SIZE = 64 * 1024;
+
+/**
+ * Default timeout of the @c transact command (in milliseconds)
+ */
+static const int DEFAULT_TIMEOUT = 1000;
+
+/**
+ * Initializes the state of a new client
+ */
+ControlServer::Client::Client()
+    : dropped(false)
+    , filtered(false)
+    , hexadecimal(false)
+    , subscription(nullptr)
+    , transaction(0)
+{
+}
+
+/**
+ * Constructor function
+ */
+ControlServer::ControlServer()
+    : m_transactions(0)
+    , m_subscriptions(0)
+    , m_commands(0)
+    , m_errors(0)
+    , m_eventsSent(0)
+    , m_slowClients(0)
+{
+    auto manager = Serial::Manager::getInstance();
+    connect(manager, &Serial::Manager::closed, this, &ControlServer::onPortClosed);
+    connect(manager, &Serial::Manager::dataReceived, this,
+            &ControlServer::onDataReceived);
+    connect(&m_server, &QLocalServer::newConnection, this,
+            &ControlServer::onNewConnection);
+
+    m_server.setSocketOptions(QLocalServer::UserAccessOption);
+}
+
+/**
+ * Returns the only instance of the class
+ */
+ControlServer *ControlServer::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new ControlServer;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns @c true if the control socket is accepting connections
+ */
+bool ControlServer::isListening() const
+{
+    return m_server.isListening();
+}
+
+/**
+ * Returns the full path of the control socket
+ */
+QString ControlServer::serverName() const
+{
+    return m_server.fullServerName();
+}
+
+/**
+ * Starts accepting connections on the control socket with the given @a name (or
+ * path), stale sockets left by previous instances are removed
+ */
+bool ControlServer::listen(const QString &name)
+{
+    close();
+    QLocalServer::removeServer(name);
+    if (!m_server.listen(name))
+    {
+        qWarning() << "Cannot start control socket:" << m_server.errorString();
+        return false;
+    }
+
+    qDebug() << "Control socket listening on" << serverName();
+    return true;
+}
+
+/**
+ * Stops accepting connections & disconnects all the clients
+ */
+void ControlServer::close()
+{
+    foreach (auto socket, m_clients.keys())
+        socket->abort();
+
+    m_server.close();
+}
+
+/**
+ * Processes the requests received from a client
+ */
+void ControlServer::onReadyRead()
+{
+    TRACE_SCOPE("ControlServer::onReadyRead", "network");
+
+    auto socket = qobject_cast<QLocalSocket *>(sender());
+    if (!socket || !m_clients.contains(socket))
+        return;
+
+    // Read data
+    auto &input = m_clients[socket].input;
+    input.append(socket->readAll());
+
+    // Process complete requests
+    int start = 0;
+    int end;
+    while ((end = input.indexOf('\n', start)) >= 0)
+    {
+        const auto line = input.mid(start, end - start).trimmed();
+        start = end + 1;
+        if (line.isEmpty())
+            continue;
+
+        // Parse request
+        QJsonParseError error;
+        auto document = QJsonDocument::fromJson(line, &error);
+        if (!document.isObject())
+        {
+            ++m_errors;
+            QJsonObject response;
+            response.insert("ok", false);
+            response.insert("error", error.errorString());
+            send(socket, response);
+            continue;
+        }
+
+        // Process request (deferred responses are sent later)
+        auto request = document.object();
+        auto response = process(socket, request);
+        if (response.isEmpty())
+            continue;
+
+        // Send response
+        if (request.contains("id"))
+            response.insert("id", request.value("id"));
+        if (!response.value("ok").toBool())
+            ++m_errors;
+
+        send(socket, response);
+    }
+
+    // Remove processed requests
+    input.remove(0, start);
+    if (input.size() > MAX_REQUEST_SIZE)
+    {
+        qWarning() << "Control socket request too long, disconnecting client";
+        socket->abort();
+    }
+}
+
+/**
+ * Notifies the subscribed clients that the device was closed
+ */
+void ControlServer::onPortClosed()
+{
+    QJsonObject event;
+    event.insert("event", "closed");
+
+    foreach (auto socket, m_clients.keys())
+    {
+        if (m_clients.value(socket).subscription)
+            send(socket, event);
+    }
+}
+
+/**
+ * Removes the disconnected client from the client list
+ */
+void ControlServer::onDisconnected()
+{
+    auto socket = qobject_cast<QLocalSocket *>(sender());
+    if (!socket)
+        return;
+
+    m_clients.remove(socket);
+    socket->deleteLater();
+}
+
+/**
+ * Registers incoming connections
+ */
+void ControlServer::onNewConnection()
+{
+    while (m_server.hasPendingConnections())
+    {
+        auto socket = m_server.nextPendingConnection();
+        connect(socket, &QLocalSocket::readyRead, this, &ControlServer::onReadyRead);
+        connect(socket, &QLocalSocket::disconnected, this,
+                &ControlServer::onDisconnected);
+        connect(socket, &QLocalSocket::bytesWritten, this,
+                &ControlServer::writeQueuedData);
+        m_clients.insert(socket, Client());
+    }
+}
+
+/**
+ * Disconnects the client whose subscription queue overflowed (with the @c Disconnect
+ * policy)
+ */
+void ControlServer::onQueueOverflowed()
+{
+    auto subscription = qobject_cast<Serial::Subscription *>(sender());
+    foreach (auto socket, m_clients.keys())
+    {
+        auto &client = m_clients[socket];
+        if (client.subscription == subscription && !client.dropped)
+        {
+            qWarning() << "Control socket client too slow, disconnecting";
+            ++m_slowClients;
+            client.dropped = true;
+            QTimer::singleShot(0, socket, [=]() { socket->abort(); });
+        }
+    }
+}
+
+/**
+ * Sends the queued data of a subscribed client while its socket write buffer is below
+ * a fixed size (called when data is queued & when the socket sends data)
+ */
+void ControlServer::writeQueuedData()
+{
+    TRACE_SCOPE("ControlServer::writeQueuedData", "network");
+
+    // Get client
+    auto socket = qobject_cast<QLocalSocket *>(sender());
+    if (!socket && sender())
+        socket = qobject_cast<QLocalSocket *>(sender()->parent());
+    if (!socket || !m_clients.contains(socket))
+        return;
+
+    // Client not subscribed
+    auto &client = m_clients[socket];
+    if (!client.subscription)
+        return;
+
+    // Send queued data
+    while (!client.subscription->isEmpty() && !client.dropped
+           && socket->bytesToWrite() < SOCKET_BUFFER_SIZE)
+    {
+        auto data = client.subscription->takeChunk();
+
+        // Send received data as-is
+        if (!client.filtered)
+        {
+            QJsonObject event;
+            event.insert("event", "rx");
+            event.insert("data", encode(client, data));
+            send(socket, event);
+            continue;
+        }
+
+        // Send lines that match the filter
+        foreach (auto line, splitLines(client.line, data))
+        {
+            if (client.filter.match(QString::fromUtf8(line)).hasMatch())
+            {
+                QJsonObject event;
+                event.insert("event", "rx");
+                event.insert("data", encode(client, line));
+                send(socket, event);
+            }
+        }
+    }
+}
+
+/**
+ * Completes the pending transactions with the @a data received from the device
+ */
+void ControlServer::onDataReceived(const QByteArray &data)
+{
+    TRACE_SCOPE("ControlServer::onDataReceived", "network");
+
+    foreach (auto socket, m_clients.keys())
+    {
+        auto &client = m_clients[socket];
+        if (!client.transaction)
+            continue;
+
+        foreach (auto line, splitLines(client.transactionLine, data))
+        {
+            if (client.expect.match(QString::fromUtf8(line)).hasMatch())
+            {
+                QJsonObject response;
+                response.insert("ok", true);
+                response.insert("line", encode(client, line));
+                if (!client.transactionId.isUndefined())
+                    response.insert("id", client.transactionId);
+
+                client.transaction = 0;
+                send(socket, response);
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * Executes the given @a request sent by the given client @a socket.
+ *
+ * @returns the response, or an empty object if the response is sent later
+ */
+QJsonObject ControlServer::process(QLocalSocket *socket, const QJsonObject &request)
+{
+    ++m_commands;
+
+    QJsonObject response;
+    auto manager = Serial::Manager::getInstance();
+    const auto cmd = request.value("cmd").toString();
+
+    // List serial ports
+    if (cmd == "ports")
+    {
+        QJsonArray ports;
+        foreach (auto info, QSerialPortInfo::availablePorts())
+        {
+            QJsonObject port;
+            port.insert("name", info.systemLocation());
+            port.insert("description", info.description());
+            ports.append(port);
+        }
+
+        response.insert("ok", true);
+        response.insert("ports", ports);
+    }
+
+    // Configure & open device
+    else if (cmd == "open")
+    {
+        const auto name = request.value("port").toString();
+        response = configure(request);
+        if (name.isEmpty())
+        {
+            response.insert("ok", false);
+            response.insert("error", "missing port");
+        }
+        else if (response.value("ok").toBool())
+        {
+            manager->connectToPort(name);
+            if (!manager->connected())
+            {
+                response.insert("ok", false);
+                response.insert("error", manager->port() ? manager->port()->errorString()
+                                                         : QString("cannot open port"));
+            }
+        }
+    }
+
+    // Change line configuration
+    else if (cmd == "configure")
+        response = configure(request);
+
+    // Close device
+    else if (cmd == "close")
+    {
+        manager->disconnectDevice();
+        response.insert("ok", true);
+    }
+
+    // Write data
+    else if (cmd == "send")
+        response = transmit(request);
+
+    // Write data & wait for an answer
+    else if (cmd == "transact")
+        response = transact(socket, request);
+
+    // Subscribe to received data
+    else if (cmd == "subscribe")
+        response = subscribe(socket, request);
+
+    // Stop sending received data
+    else if (cmd == "unsubscribe")
+    {
+        delete m_clients[socket].subscription;
+        m_clients[socket].subscription = nullptr;
+        response.insert("ok", true);
+    }
+
+    // Get counters
+    else if (cmd == "counters")
+    {
+        response = counters();
+        response.insert("ok", true);
+    }
+
+    // Unknown command
+    else
+    {
+        response.insert("ok", false);
+        response.insert("error", QString("unknown command: %1").arg(cmd));
+    }
+
+    return response;
+}
+
+/**
+ * Changes the line configuration with the optional fields of the given @a request
+ */
+QJsonObject ControlServer::configure(const QJsonObject &request)
+{
+    // Parity & flow control names (same order as the lists of @c Serial::Manager)
+    static const QStringList PARITIES = { "none", "even", "odd", "space", "mark" };
+    static const QStringList FLOW_CONTROLS = { "none", "hardware", "software" };
+
+    // Get options
+    auto manager = Serial::Manager::getInstance();
+    auto baudRate = request.value("baud").toInt(manager->baudRate());
+    int dataBits = manager->dataBitsIndex();
+    int stopBits = manager->stopBitsIndex();
+    int parity = manager->parityIndex();
+    int flowControl = manager->flowControlIndex();
+    auto value = [&](const char *key) {
+        return request.value(key).toVariant().toString().toLower();
+    };
+    if (request.contains("dataBits"))
+        dataBits = manager->dataBitsList().indexOf(value("dataBits"));
+    if (request.contains("stopBits"))
+        stopBits = manager->stopBitsList().indexOf(value("stopBits"));
+    if (request.contains("parity"))
+        parity = PARITIES.indexOf(value("parity"));
+    if (request.contains("flowControl"))
+        flowControl = FLOW_CONTROLS.indexOf(value("flowControl"));
+
+    // Validate options
+    QJsonObject response;
+    response.insert("ok", false);
+    if (baudRate <= 10)
+        response.insert("error", "invalid baud rate");
+    else if (dataBits < 0)
+        response.insert("error", "invalid data bits");
+    else if (stopBits < 0)
+        response.insert("error", "invalid stop bits");
+    else if (parity < 0)
+        response.insert("error", "invalid parity");
+    else if (flowControl < 0)
+        response.insert("error", "invalid flow control");
+
+    // Apply configuration
+    else
+    {
+        if (baudRate != manager->baudRate())
+            manager->setBaudRate(baudRate);
+        if (dataBits != manager->dataBitsIndex())
+            manager->setDataBits(dataBits);
+        if (stopBits != manager->stopBitsIndex())
+            manager->setStopBits(stopBits);
+        if (parity != manager->parityIndex())
+            manager->setParity(parity);
+        if (flowControl != manager->flowControlIndex())
+            manager->setFlowControl(flowControl);
+
+        response.insert("ok", true);
+    }
+
+    return response;
+}
+
+/**
+ * Writes the @c data (text) or @c hex (hexadecimal) field of the given @a request to
+ * the device
+ */
+QJsonObject ControlServer::transmit(const QJsonObject &request)
+{
+    QJsonObject response;
+    response.insert("ok", false);
+
+    // Get data
+    QByteArray data;
+    if (request.contains("hex"))
+        data = QByteArray::fromHex(request.value("hex").toString().toLatin1());
+    else
+        data = request.value("data").toString().toUtf8();
+
+    // Write data
+    auto manager = Serial::Manager::getInstance();
+    if (!manager->connected())
+        response.insert("error", "not connected");
+    else if (data.isEmpty())
+        response.insert("error", "no data");
+    else
+    {
+        auto written = manager->writeData(data);
+        response.insert("ok", written == data.size());
+        response.insert("written", written);
+        if (written != data.size())
+            response.insert("error", "write error");
+    }
+
+    return response;
+}
+
+/**
+ * Enables the subscription of the given @a client with the @c filter & @c format
+ * fields of the given @a request
+ */
+QJsonObject ControlServer::subscribe(QLocalSocket *socket, const QJsonObject &request)
+{
+    QJsonObject response;
+    auto &client = m_clients[socket];
+
+    // Validate policy
+    auto policy = Serial::Subscription::Policy::Disconnect;
+    if (request.contains("policy")
+        && !Serial::Subscription::policyFromName(request.value("policy").toString(),
+                                                 policy))
+    {
+        response.insert("ok", false);
+        response.insert("error", "invalid policy");
+        return response;
+    }
+
+    // Validate filter
+    QRegularExpression filter;
+    if (request.contains("filter"))
+    {
+        filter.setPattern(request.value("filter").toString());
+        if (!filter.isValid())
+        {
+            response.insert("ok", false);
+            response.insert("error", filter.errorString());
+            return response;
+        }
+
+        filter.optimize();
+    }
+
+    // Replace previous subscription
+    delete client.subscription;
+    auto name = QString("control:%1").arg(++m_subscriptions);
+    auto capacity = static_cast<qint64>(
+        request.value("queue").toDouble(static_cast<double>(DEFAULT_QUEUE_CAPACITY)));
+    client.subscription = new Serial::Subscription(name, policy, capacity, socket);
+    connect(client.subscription, &Serial::Subscription::dataAvailable, this,
+            &ControlServer::writeQueuedData);
+    connect(client.subscription, &Serial::Subscription::overflowed, this,
+            &ControlServer::onQueueOverflowed);
+
+    // Register filter & format
+    client.line.clear();
+    client.filter = filter;
+    client.filtered = request.contains("filter");
+    client.hexadecimal = request.value("format").toString() == "hex";
+    response.insert("ok", true);
+    return response;
+}
+
+/**
+ * Writes the data of the given @a request to the device & waits for a line that
+ * matches the @c expect regular expression. The response is sent when the line is
+ * received or when the @c timeout expires.
+ */
+QJsonObject ControlServer::transact(QLocalSocket *socket, const QJsonObject &request)
+{
+    QJsonObject response;
+    auto &client = m_clients[socket];
+
+    // Only one transaction at a time
+    if (client.transaction)
+    {
+        response.insert("ok", false);
+        response.insert("error", "transaction in progress");
+        return response;
+    }
+
+    // Validate expected answer
+    QRegularExpression expect(request.value("expect").toString());
+    if (!request.contains("expect") || !expect.isValid())
+    {
+        response.insert("ok", false);
+        response.insert("error", "invalid expect pattern");
+        return response;
+    }
+
+    // Register transaction before writing data (the answer may arrive immediately)
+    expect.optimize();
+    client.expect = expect;
+    client.transaction = ++m_transactions;
+    client.transactionId = request.value("id");
+    client.transactionLine.clear();
+
+    // Write data
+    response = transmit(request);
+    if (!response.value("ok").toBool())
+    {
+        client.transaction = 0;
+        return response;
+    }
+
+    // Fail transaction when the timeout expires
+    const auto transaction = client.transaction;
+    const auto timeout = request.value("timeout").toInt(DEFAULT_TIMEOUT);
+    QTimer::singleShot(timeout, socket,
+                       [=]() { onTransactionTimeout(socket, transaction); });
+
+    return QJsonObject();
+}
+
+/**
+ * Returns the link statistics & the counters of the control socket
+ */
+QJsonObject ControlServer::counters() const
+{
+    QJsonObject control;
+    control.insert("clients", m_clients.count());
+    control.insert("commands", m_commands);
+    control.insert("errors", m_errors);
+    control.insert("eventsSent", m_eventsSent);
+    control.insert("slowClients", m_slowClients);
+
+    QJsonObject counters;
+    counters.insert("link", Serial::Statistics::getInstance()->toJson());
+    counters.insert("consumers", Serial::Dispatcher::getInstance()->toJson());
+    counters.insert("control", control);
+    return counters;
+}
+
+/**
+ * Appends the received @a data to the @a partial line & returns the complete lines
+ * (without line breaks). Partial lines longer than a fixed size are returned as
+ * complete lines.
+ */
+QList<QByteArray> ControlServer::splitLines(QByteArray &partial, const QByteArray &data)
+{
+    QList<QByteArray> lines;
+
+    int start = 0;
+    while (start < data.size())
+    {
+        // Get next line
+        auto end = data.indexOf('\n', start);
+        if (end < 0)
+        {
+            partial.append(data.constData() + start, data.size() - start);
+            if (partial.size() < MAX_LINE_SIZE)
+                break;
+
+            start = data.size();
+        }
+        else
+        {
+            partial.append(data.constData() + start, end - start + 1);
+            start = end + 1;
+        }
+
+        // Remove line break
+        auto line = partial;
+        partial.clear();
+        while (line.endsWith('\n') || line.endsWith('\r'))
+            line.chop(1);
+
+        lines.append(line);
+    }
+
+    return lines;
+}
+
+/**
+ * Fails the given @a transaction of the given client @a socket if it is still
+ * pending
+ */
+void ControlServer::onTransactionTimeout(QLocalSocket *socket, const quint64 transaction)
+{
+    if (!m_clients.contains(socket) || m_clients[socket].transaction != transaction)
+        return;
+
+    auto &client = m_clients[socket];
+    client.transaction = 0;
+    ++m_errors;
+
+    QJsonObject response;
+    response.insert("ok", false);
+    response.insert("error", "timeout");
+    if (!client.transactionId.isUndefined())
+        response.insert("id", client.transactionId);
+
+    send(socket, response);
+}
+
+/**
+ * Encodes the given @a data in the format selected by the given @a client
+ */
+QJsonValue ControlServer::encode(const Client &client, const QByteArray &data) const
+{
+    if (client.hexadecimal)
+        return QString::fromLatin1(data.toHex());
+
+    return QString::fromUtf8(data);
+}
+
+/**
+ * Writes the given @a message to the given client @a socket, clients that do not read
+ * the messages are disconnected (in the next event loop iteration, so that the client
+ * list is not modified while it is being used)
+ */
+void ControlServer::send(QLocalSocket *socket, const QJsonObject &message)
+{
+    auto client = m_clients.find(socket);
+    if (client == m_clients.end() || client->dropped)
+        return;
+
+    if (socket->bytesToWrite() > MAX_CLIENT_BUFFER)
+    {
+        qWarning() << "Control socket client too slow, disconnecting";
+        ++m_slowClients;
+        client->dropped = true;
+        QTimer::singleShot(0, socket, [=]() { socket->abort(); });
+        return;
+    }
+
+    if (message.contains("event"))
+        ++m_eventsSent;
+
+    socket->write(QJsonDocument(message).toJson(QJsonDocument::Compact) + '\n');
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NETWORK_CONTROL_SERVER_H
+#define NETWORK_CONTROL_SERVER_H
+
+#include <QHash>
+#include <QObject>
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QRegularExpression>
+
+#include <Serial/Subscription.h>
+
+namespace Network
+{
+/**
+ * Local control socket (Unix-domain socket, or named pipe on Windows) used by scripts
+ * & test harnesses to automate the application without driving the user interface.
+ *
+ * The protocol is newline-delimited JSON: each request is a JSON object in a single
+ * line with a @c cmd field & an optional @c id field, which is copied to the response.
+ * Responses contain an @c ok field & an @c error field when the request fails:
+ *
+ * - @c ports: lists the available serial ports
+ * - @c open: opens the given @c port, optionally with @c baud, @c dataBits,
+ *   @c parity, @c stopBits & @c flowControl
+ * - @c configure: changes the line configuration (same fields as @c open)
+ * - @c close: closes the current device
+ * - @c send: writes @c data (text) or @c hex (hexadecimal) to the device
+ * - @c transact: writes data like @c send & replies with the first received line that
+ *   matches the @c expect regular expression, or fails after @c timeout milliseconds
+ * - @c subscribe: sends received data as @c {"event":"rx","data":...} messages, either
+ *   as received or only the lines that match the @c filter regular expression, in the
+ *   given @c format (@c text or @c hex). Received data is queued in a
+ *   @c Serial::Subscription with the given @c policy & @c queue size (in bytes)
+ * - @c unsubscribe: stops sending received data
+ * - @c counters: returns the link statistics & the counters of the control socket
+ *
+ * Only the user that runs the application can connect to the socket.
+ */
+class ControlServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static ControlServer *getInstance();
+
+    bool isListening() const;
+    QString serverName() const;
+
+public slots:
+    bool listen(const QString &name);
+    void close();
+
+private slots:
+    void onReadyRead();
+    void onPortClosed();
+    void onDisconnected();
+    void onNewConnection();
+    void onQueueOverflowed();
+    void writeQueuedData();
+    void onDataReceived(const QByteArray &data);
+
+private:
+    struct Client
+    {
+        Client();
+
+        QByteArray input;
+
+        bool dropped;
+        bool filtered;
+        bool hexadecimal;
+        QByteArray line;
+        QRegularExpression filter;
+        Serial::Subscription *subscription;
+
+        quint64 transaction;
+        QByteArray transactionLine;
+        QJsonValue transactionId;
+        QRegularExpression expect;
+    };
+
+    ControlServer();
+
+    QJsonObject process(QLocalSocket *socket, const QJsonObject &request);
+    QJsonObject configure(const QJsonObject &request);
+    QJsonObject transmit(const QJsonObject &request);
+    QJsonObject subscribe(QLocalSocket *socket, const QJsonObject &request);
+    QJsonObject transact(QLocalSocket *socket, const QJsonObject &request);
+    QJsonObject counters() const;
+
+    static QList<QByteArray> splitLines(QByteArray &partial, const QByteArray &data);
+    void onTransactionTimeout(QLocalSocket *socket, const quint64 transaction);
+    QJsonValue encode(const Client &client, const QByteArray &data) const;
+    void send(QLocalSocket *socket, const QJsonObject &message);
+
+private:
+    QLocalServer m_server;
+    QHash<QLocalSocket *, Client> m_clients;
+
+    quint64 m_transactions;
+    quint64 m_subscriptions;
+    qint64 m_commands;
+    qint64 m_errors;
+    qint64 m_eventsSent;
+    qint64 m_slowClients;
+};
+}
+
+#endif
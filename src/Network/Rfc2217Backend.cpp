@@ -0,0 +1,493 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include <QDebug>
+#include <QtEndian>
+
+#include <Network/Rfc2217Backend.h>
+
+using namespace Network;
+
+/**
+ * Telnet commands (RFC 854)
+ */
+enum TelnetCommand
+{
+    SE = 240,
+    SB = 250,
+    WILL = 251,
+    WONT = 252,
+    DO = 253,
+    DONT = 254,
+    IAC = 255
+};
+
+/**
+ * Telnet options used by the backend
+ */
+enum TelnetOption
+{
+    BINARY = 0,
+    SUPPRESS_GO_AHEAD = 3,
+    COM_PORT_OPTION = 44
+};
+
+/**
+ * COM port option commands sent by the client (RFC 2217), the server answers with the
+ * same command + 100
+ */
+enum ComPortCommand
+{
+    SET_BAUDRATE = 1,
+    SET_DATASIZE = 2,
+    SET_PARITY = 3,
+    SET_STOPSIZE = 4,
+    SET_CONTROL = 5,
+    NOTIFY_LINESTATE = 6,
+    NOTIFY_MODEMSTATE = 7,
+    SET_LINESTATE_MASK = 10,
+    SERVER_OFFSET = 100
+};
+
+/**
+ * Default Telnet port
+ */
+static const quint16 DEFAULT_PORT = 23;
+
+/**
+ * Line state mask (overrun, parity, framing & break errors)
+ */
+static const quint8 LINESTATE_MASK = 0x1E;
+
+/**
+ * Constructor function
+ */
+Rfc2217Backend::Rfc2217Backend(const QUrl &url, QObject *parent)
+    : Serial::Backend(parent)
+    , m_url(url)
+    , m_state(Data)
+    , m_command(0)
+{
+    connect(&m_socket, &QTcpSocket::connected, this, &Rfc2217Backend::onConnected);
+    connect(&m_socket, &QTcpSocket::readyRead, this, &Rfc2217Backend::onReadyRead);
+    connect(&m_socket, &QTcpSocket::disconnected, this, &Rfc2217Backend::onDisconnected);
+    connect(&m_socket, &QTcpSocket::bytesWritten, this, &Rfc2217Backend::bytesWritten);
+    connect(&m_socket, SIGNAL(error(QAbstractSocket::SocketError)), this,
+            SLOT(onErrorOccurred()));
+}
+
+/**
+ * Returns the device URL
+ */
+QString Rfc2217Backend::name() const
+{
+    return m_url.toString();
+}
+
+/**
+ * Starts connecting to the terminal server, data written before the connection is
+ * established is buffered
+ */
+bool Rfc2217Backend::open(OpenMode mode)
+{
+    if (m_url.host().isEmpty())
+    {
+        setErrorString(tr("Invalid RFC 2217 URL: %1").arg(name()));
+        return false;
+    }
+
+    m_state = Data;
+    m_readBuffer.clear();
+    m_socket.connectToHost(m_url.host(), static_cast<quint16>(m_url.port(DEFAULT_PORT)));
+    return Serial::Backend::open(mode | QIODevice::Unbuffered);
+}
+
+/**
+ * Closes the connection with the terminal server
+ */
+void Rfc2217Backend::close()
+{
+    m_socket.abort();
+    Serial::Backend::close();
+}
+
+/**
+ * Returns the number of received bytes (without Telnet commands)
+ */
+qint64 Rfc2217Backend::bytesAvailable() const
+{
+    return m_readBuffer.size() + Serial::Backend::bytesAvailable();
+}
+
+/**
+ * Returns the number of bytes waiting to be sent to the terminal server
+ */
+qint64 Rfc2217Backend::bytesToWrite() const
+{
+    return m_socket.bytesToWrite();
+}
+
+/**
+ * Writes as much buffered data as possible to the socket without blocking
+ */
+bool Rfc2217Backend::flush()
+{
+    return m_socket.flush();
+}
+
+/**
+ * Changes the baud rate of the remote serial port
+ */
+void Rfc2217Backend::setBaudRate(const qint32 rate)
+{
+    Serial::Backend::setBaudRate(rate);
+
+    QByteArray value(4, '\0');
+    qToBigEndian<quint32>(static_cast<quint32>(rate),
+                          reinterpret_cast<uchar *>(value.data()));
+    sendComPortOption(SET_BAUDRATE, value);
+}
+
+/**
+ * Changes the parity of the remote serial port
+ */
+void Rfc2217Backend::setParity(const QSerialPort::Parity parity)
+{
+    Serial::Backend::setParity(parity);
+
+    quint8 value = 1;
+    switch (parity)
+    {
+        case QSerialPort::OddParity:
+            value = 2;
+            break;
+        case QSerialPort::EvenParity:
+            value = 3;
+            break;
+        case QSerialPort::MarkParity:
+            value = 4;
+            break;
+        case QSerialPort::SpaceParity:
+            value = 5;
+            break;
+        default:
+            value = 1;
+            break;
+    }
+
+    sendComPortOption(SET_PARITY, QByteArray(1, static_cast<char>(value)));
+}
+
+/**
+ * Changes the number of data bits of the remote serial port
+ */
+void Rfc2217Backend::setDataBits(const QSerialPort::DataBits dataBits)
+{
+    Serial::Backend::setDataBits(dataBits);
+    sendComPortOption(SET_DATASIZE, QByteArray(1, static_cast<char>(dataBits)));
+}
+
+/**
+ * Changes the number of stop bits of the remote serial port
+ */
+void Rfc2217Backend::setStopBits(const QSerialPort::StopBits stopBits)
+{
+    Serial::Backend::setStopBits(stopBits);
+
+    quint8 value = 1;
+    if (stopBits == QSerialPort::TwoStop)
+        value = 2;
+    else if (stopBits == QSerialPort::OneAndHalfStop)
+        value = 3;
+
+    sendComPortOption(SET_STOPSIZE, QByteArray(1, static_cast<char>(value)));
+}
+
+/**
+ * Changes the flow control mode of the remote serial port
+ */
+void Rfc2217Backend::setFlowControl(const QSerialPort::FlowControl flowControl)
+{
+    Serial::Backend::setFlowControl(flowControl);
+
+    quint8 value = 1;
+    if (flowControl == QSerialPort::SoftwareControl)
+        value = 2;
+    else if (flowControl == QSerialPort::HardwareControl)
+        value = 3;
+
+    sendComPortOption(SET_CONTROL, QByteArray(1, static_cast<char>(value)));
+}
+
+/**
+ * Reads up to @a maxSize bytes of received data
+ */
+qint64 Rfc2217Backend::readData(char *data, qint64 maxSize)
+{
+    const auto size = qMin<qint64>(maxSize, m_readBuffer.size());
+    memcpy(data, m_readBuffer.constData(), static_cast<size_t>(size));
+    m_readBuffer.remove(0, static_cast<int>(size));
+    return size;
+}
+
+/**
+ * Sends @a maxSize bytes to the remote serial port, 0xFF bytes are escaped
+ */
+qint64 Rfc2217Backend::writeData(const char *data, qint64 maxSize)
+{
+    // Nothing to escape, write data directly
+    if (!memchr(data, IAC, static_cast<size_t>(maxSize)))
+        return m_socket.write(data, maxSize);
+
+    // Escape IAC bytes
+    QByteArray escaped;
+    escaped.reserve(static_cast<int>(maxSize) + 16);
+    for (qint64 i = 0; i < maxSize; ++i)
+    {
+        escaped.append(data[i]);
+        if (static_cast<quint8>(data[i]) == IAC)
+            escaped.append(data[i]);
+    }
+
+    if (m_socket.write(escaped) != escaped.size())
+        return -1;
+
+    return maxSize;
+}
+
+/**
+ * Negotiates the Telnet options & sends the line configuration once connected
+ */
+void Rfc2217Backend::onConnected()
+{
+    m_socket.setSocketOption(QAbstractSocket::LowDelayOption, 1);
+
+    sendCommand(WILL, COM_PORT_OPTION);
+    sendCommand(WILL, BINARY);
+    sendCommand(DO, BINARY);
+    sendCommand(WILL, SUPPRESS_GO_AHEAD);
+    sendCommand(DO, SUPPRESS_GO_AHEAD);
+    sendConfiguration();
+
+    qDebug() << "Connected to RFC 2217 server" << name();
+}
+
+/**
+ * Removes Telnet commands from the received data & notifies the application
+ */
+void Rfc2217Backend::onReadyRead()
+{
+    const auto input = m_socket.readAll();
+    const auto bytes = reinterpret_cast<const quint8 *>(input.constData());
+    const int size = input.size();
+
+    // Fast path, no Telnet commands in received data
+    if (m_state == Data && !memchr(bytes, IAC, static_cast<size_t>(size)))
+    {
+        if (m_readBuffer.isEmpty())
+            m_readBuffer = input;
+        else
+            m_readBuffer.append(input);
+
+        emit readyRead();
+        return;
+    }
+
+    // Process Telnet commands
+    const int previousSize = m_readBuffer.size();
+    for (int i = 0; i < size; ++i)
+    {
+        const auto c = bytes[i];
+        switch (m_state)
+        {
+            case Data:
+            {
+                // Copy data up to the next IAC byte
+                auto next = static_cast<const quint8 *>(memchr(bytes + i, IAC, size - i));
+                auto end = next ? static_cast<int>(next - bytes) : size;
+                m_readBuffer.append(reinterpret_cast<const char *>(bytes + i), end - i);
+                if (next)
+                    m_state = Command;
+
+                i = end;
+                break;
+            }
+            case Command:
+                if (c == IAC)
+                {
+                    m_readBuffer.append(static_cast<char>(IAC));
+                    m_state = Data;
+                }
+                else if (c == SB)
+                {
+                    m_subnegotiation.clear();
+                    m_state = Subnegotiation;
+                }
+                else if (c >= WILL && c <= DONT)
+                {
+                    m_command = c;
+                    m_state = Option;
+                }
+                else
+                    m_state = Data;
+                break;
+            case Option:
+                negotiate(m_command, c);
+                m_state = Data;
+                break;
+            case Subnegotiation:
+                if (c == IAC)
+                    m_state = SubnegotiationCommand;
+                else
+                    m_subnegotiation.append(static_cast<char>(c));
+                break;
+            case SubnegotiationCommand:
+                if (c == SE)
+                {
+                    processSubnegotiation();
+                    m_state = Data;
+                }
+                else
+                {
+                    m_subnegotiation.append(static_cast<char>(c));
+                    m_state = Subnegotiation;
+                }
+                break;
+        }
+    }
+
+    // Notify application
+    if (m_readBuffer.size() > previousSize)
+        emit readyRead();
+}
+
+/**
+ * Reports the end of the data stream & the closed connection as an error, so that the
+ * device is closed
+ */
+void Rfc2217Backend::onDisconnected()
+{
+    if (isOpen())
+    {
+        emit readChannelFinished();
+        emit errorOccurred(tr("Connection closed by %1").arg(name()));
+    }
+}
+
+/**
+ * Reports socket errors
+ */
+void Rfc2217Backend::onErrorOccurred()
+{
+    if (m_socket.error() != QAbstractSocket::RemoteHostClosedError)
+    {
+        setErrorString(m_socket.errorString());
+        emit errorOccurred(m_socket.errorString());
+    }
+}
+
+/**
+ * Answers the option negotiation requests of the server, only the options needed by
+ * the COM port control protocol are accepted
+ */
+void Rfc2217Backend::negotiate(const quint8 command, const quint8 option)
+{
+    const bool supported = option == BINARY || option == SUPPRESS_GO_AHEAD
+        || option == COM_PORT_OPTION;
+
+    // Requests that we already made are acknowledged by the server, only answer
+    // requests for options that we do not support
+    if (supported)
+        return;
+
+    if (command == DO)
+        sendCommand(WONT, option);
+    else if (command == WILL)
+        sendCommand(DONT, option);
+}
+
+/**
+ * Sends the given Telnet @a command for the given @a option
+ */
+void Rfc2217Backend::sendCommand(const quint8 command, const quint8 option)
+{
+    const char data[] = { static_cast<char>(IAC), static_cast<char>(command),
+                          static_cast<char>(option) };
+    m_socket.write(data, sizeof(data));
+}
+
+/**
+ * Sends a COM-PORT-OPTION subnegotiation with the given @a command & @a value (if
+ * connected, the complete configuration is sent when the connection is established)
+ */
+void Rfc2217Backend::sendComPortOption(const quint8 command, const QByteArray &value)
+{
+    if (m_socket.state() != QAbstractSocket::ConnectedState)
+        return;
+
+    QByteArray data;
+    data.append(static_cast<char>(IAC));
+    data.append(static_cast<char>(SB));
+    data.append(static_cast<char>(COM_PORT_OPTION));
+    data.append(static_cast<char>(command));
+    for (int i = 0; i < value.size(); ++i)
+    {
+        data.append(value.at(i));
+        if (static_cast<quint8>(value.at(i)) == IAC)
+            data.append(value.at(i));
+    }
+    data.append(static_cast<char>(IAC));
+    data.append(static_cast<char>(SE));
+
+    m_socket.write(data);
+}
+
+/**
+ * Processes the COM-PORT-OPTION notifications sent by the server
+ */
+void Rfc2217Backend::processSubnegotiation()
+{
+    if (m_subnegotiation.size() < 3
+        || static_cast<quint8>(m_subnegotiation.at(0)) != COM_PORT_OPTION)
+        return;
+
+    const auto command = static_cast<quint8>(m_subnegotiation.at(1));
+    const auto value = static_cast<quint8>(m_subnegotiation.at(2));
+    if (command == NOTIFY_LINESTATE + SERVER_OFFSET && (value & LINESTATE_MASK))
+        emit lineError(value & LINESTATE_MASK);
+}
+
+/**
+ * Sends the complete line configuration to the server
+ */
+void Rfc2217Backend::sendConfiguration()
+{
+    setBaudRate(baudRate());
+    setDataBits(dataBits());
+    setParity(parity());
+    setStopBits(stopBits());
+    setFlowControl(flowControl());
+    sendComPortOption(SET_LINESTATE_MASK,
+                      QByteArray(1, static_cast<char>(LINESTATE_MASK)));
+}
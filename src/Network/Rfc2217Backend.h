@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NETWORK_RFC2217_BACKEND_H
+#define NETWORK_RFC2217_BACKEND_H
+
+#include <QUrl>
+#include <QTcpSocket>
+#include <Serial/Backend.h>
+
+namespace Network
+{
+/**
+ * Backend for serial ports exposed by terminal servers (e.g. ser2net) through the
+ * Telnet COM port control option (RFC 2217). Device names have the form
+ * @c rfc2217://host:port.
+ *
+ * Line configuration changes are sent as COM-PORT-OPTION subnegotiations & line state
+ * notifications (overrun, parity, framing & break) are reported with the
+ * @c Serial::Backend::lineError() signal. Telnet commands are removed from received
+ * data & 0xFF bytes are escaped in transmitted data.
+ *
+ * Nagle's algorithm is disabled, so that small writes are sent immediately. Writes done
+ * during the same event loop iteration are coalesced by the socket write buffer & sent
+ * with a single system call.
+ */
+class Rfc2217Backend : public Serial::Backend
+{
+    Q_OBJECT
+
+public:
+    Rfc2217Backend(const QUrl &url, QObject *parent = nullptr);
+
+    QString name() const override;
+
+    bool open(OpenMode mode) override;
+    void close() override;
+
+    qint64 bytesAvailable() const override;
+    qint64 bytesToWrite() const override;
+    bool flush() override;
+
+    void setBaudRate(const qint32 rate) override;
+    void setParity(const QSerialPort::Parity parity) override;
+    void setDataBits(const QSerialPort::DataBits dataBits) override;
+    void setStopBits(const QSerialPort::StopBits stopBits) override;
+    void setFlowControl(const QSerialPort::FlowControl flowControl) override;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private slots:
+    void onConnected();
+    void onReadyRead();
+    void onDisconnected();
+    void onErrorOccurred();
+
+private:
+    enum State
+    {
+        Data,
+        Command,
+        Option,
+        Subnegotiation,
+        SubnegotiationCommand
+    };
+
+    void negotiate(const quint8 command, const quint8 option);
+    void sendCommand(const quint8 command, const quint8 option);
+    void sendComPortOption(const quint8 command, const QByteArray &value);
+    void processSubnegotiation();
+    void sendConfiguration();
+
+private:
+    QUrl m_url;
+    QTcpSocket m_socket;
+
+    State m_state;
+    quint8 m_command;
+    QByteArray m_subnegotiation;
+    QByteArray m_readBuffer;
+};
+}
+
+#endif
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Network/SocketBackend.h>
+
+using namespace Network;
+
+/**
+ * Size of the socket receive buffer requested to the operating system
+ */
+static const int RECEIVE_BUFFER_SIZE = 4 * 1024 * 1024;
+
+/**
+ * Constructor function
+ */
+SocketBackend::SocketBackend(const QUrl &url, QObject *parent)
+    : Serial::Backend(parent)
+    , m_url(url)
+{
+}
+
+/**
+ * Returns the device URL
+ */
+QString SocketBackend::name() const
+{
+    return m_url.toString();
+}
+
+/**
+ * Returns the number of bytes that can be read from the current socket
+ */
+qint64 SocketBackend::bytesAvailable() const
+{
+    if (m_socket)
+        return m_socket->bytesAvailable() + Serial::Backend::bytesAvailable();
+
+    return Serial::Backend::bytesAvailable();
+}
+
+/**
+ * Returns the number of bytes waiting to be sent by the current socket
+ */
+qint64 SocketBackend::bytesToWrite() const
+{
+    if (m_socket)
+        return m_socket->bytesToWrite();
+
+    return 0;
+}
+
+/**
+ * Writes as much buffered data as possible to the current socket without blocking
+ */
+bool SocketBackend::flush()
+{
+    if (m_socket)
+        return m_socket->flush();
+
+    return false;
+}
+
+/**
+ * Returns the device URL
+ */
+QUrl SocketBackend::url() const
+{
+    return m_url;
+}
+
+/**
+ * Returns the socket used to exchange data (if any)
+ */
+QAbstractSocket *SocketBackend::socket() const
+{
+    return m_socket;
+}
+
+/**
+ * Changes the socket used to exchange data & forwards its signals
+ */
+void SocketBackend::setSocket(QAbstractSocket *socket)
+{
+    if (m_socket)
+        m_socket->disconnect(this);
+
+    m_socket = socket;
+    if (m_socket)
+    {
+        connect(m_socket, &QAbstractSocket::readyRead, this, &SocketBackend::onReadyRead);
+        connect(m_socket, &QAbstractSocket::bytesWritten, this,
+                &SocketBackend::bytesWritten);
+    }
+}
+
+/**
+ * Enlarges the receive buffer & disables Nagle's algorithm, socket options can only be
+ * changed once the socket is connected (or bound)
+ */
+void SocketBackend::configureSocket()
+{
+    if (!m_socket)
+        return;
+
+    m_socket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption,
+                              RECEIVE_BUFFER_SIZE);
+    if (m_socket->socketType() == QAbstractSocket::TcpSocket)
+        m_socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+}
+
+/**
+ * Reads up to @a maxSize bytes from the current socket
+ */
+qint64 SocketBackend::readData(char *data, qint64 maxSize)
+{
+    if (m_socket)
+        return m_socket->read(data, maxSize);
+
+    return 0;
+}
+
+/**
+ * Writes @a maxSize bytes to the current socket, data is discarded if there is no
+ * peer to send it to (as a serial port with nothing attached to it would do)
+ */
+qint64 SocketBackend::writeData(const char *data, qint64 maxSize)
+{
+    if (m_socket)
+        return m_socket->write(data, maxSize);
+
+    return maxSize;
+}
+
+/**
+ * Notifies the application that data can be read from the socket
+ */
+void SocketBackend::onReadyRead()
+{
+    emit readyRead();
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NETWORK_SOCKET_BACKEND_H
+#define NETWORK_SOCKET_BACKEND_H
+
+#include <QUrl>
+#include <QPointer>
+#include <QAbstractSocket>
+#include <Serial/Backend.h>
+
+namespace Network
+{
+/**
+ * Base class of the backends that exchange raw data through a network socket. Data is
+ * read directly from the socket (the backend is unbuffered), the socket receive buffer
+ * is enlarged so that bursts sent by network-attached devices are not dropped while
+ * the user interface is busy & Nagle's algorithm is disabled for TCP sockets.
+ *
+ * Line configuration changes are stored, but have no effect on network devices.
+ */
+class SocketBackend : public Serial::Backend
+{
+    Q_OBJECT
+
+public:
+    SocketBackend(const QUrl &url, QObject *parent = nullptr);
+
+    QString name() const override;
+
+    qint64 bytesAvailable() const override;
+    qint64 bytesToWrite() const override;
+    bool flush() override;
+
+protected:
+    QUrl url() const;
+    QAbstractSocket *socket() const;
+    void setSocket(QAbstractSocket *socket);
+    void configureSocket();
+
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+protected slots:
+    virtual void onReadyRead();
+
+private:
+    QUrl m_url;
+    QPointer<QAbstractSocket> m_socket;
+};
+}
+
+#endif
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDebug>
+
+#include <Network/TcpClientBackend.h>
+
+using namespace Network;
+
+/**
+ * Constructor function
+ */
+TcpClientBackend::TcpClientBackend(const QUrl &url, QObject *parent)
+    : SocketBackend(url, parent)
+{
+    setSocket(&m_socket);
+
+    connect(&m_socket, &QTcpSocket::connected, this, &TcpClientBackend::onConnected);
+    connect(&m_socket, &QTcpSocket::disconnected, this,
+            &TcpClientBackend::onDisconnected);
+    connect(&m_socket, SIGNAL(error(QAbstractSocket::SocketError)), this,
+            SLOT(onErrorOccurred()));
+}
+
+/**
+ * Starts connecting to the server, data written before the connection is established
+ * is buffered
+ */
+bool TcpClientBackend::open(OpenMode mode)
+{
+    if (url().host().isEmpty() || url().port() <= 0)
+    {
+        setErrorString(tr("Invalid TCP address: %1").arg(name()));
+        return false;
+    }
+
+    m_socket.connectToHost(url().host(), static_cast<quint16>(url().port()));
+    return SocketBackend::open(mode | QIODevice::Unbuffered);
+}
+
+/**
+ * Closes the connection with the server
+ */
+void TcpClientBackend::close()
+{
+    m_socket.abort();
+    SocketBackend::close();
+}
+
+/**
+ * Tunes the socket once the connection is established
+ */
+void TcpClientBackend::onConnected()
+{
+    configureSocket();
+    qDebug() << "Connected to TCP server" << name();
+}
+
+/**
+ * Reports the end of the data stream & the closed connection as an error, so that the
+ * device is closed
+ */
+void TcpClientBackend::onDisconnected()
+{
+    if (isOpen())
+    {
+        emit readChannelFinished();
+        emit errorOccurred(tr("Connection closed by %1").arg(name()));
+    }
+}
+
+/**
+ * Reports socket errors
+ */
+void TcpClientBackend::onErrorOccurred()
+{
+    if (m_socket.error() != QAbstractSocket::RemoteHostClosedError)
+    {
+        setErrorString(m_socket.errorString());
+        emit errorOccurred(m_socket.errorString());
+    }
+}
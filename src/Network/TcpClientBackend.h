@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NETWORK_TCP_CLIENT_BACKEND_H
+#define NETWORK_TCP_CLIENT_BACKEND_H
+
+#include <QTcpSocket>
+#include <Network/SocketBackend.h>
+
+namespace Network
+{
+/**
+ * Exchanges raw data with a TCP server (e.g. a network-attached MCU or a serial device
+ * server in raw mode). Device names have the form @c tcp://host:port, the device is
+ * closed when the connection is lost.
+ */
+class TcpClientBackend : public SocketBackend
+{
+    Q_OBJECT
+
+public:
+    TcpClientBackend(const QUrl &url, QObject *parent = nullptr);
+
+    bool open(OpenMode mode) override;
+    void close() override;
+
+private slots:
+    void onConnected();
+    void onDisconnected();
+    void onErrorOccurred();
+
+private:
+    QTcpSocket m_socket;
+};
+}
+
+#endif
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDebug>
+#include <QHostAddress>
+
+#include <Network/TcpServerBackend.h>
+
+using namespace Network;
+
+/**
+ * Constructor function
+ */
+TcpServerBackend::TcpServerBackend(const QUrl &url, QObject *parent)
+    : SocketBackend(url, parent)
+{
+    connect(&m_server, &QTcpServer::newConnection, this,
+            &TcpServerBackend::onNewConnection);
+}
+
+/**
+ * Starts listening for incoming connections
+ */
+bool TcpServerBackend::open(OpenMode mode)
+{
+    // Get listening address
+    QHostAddress address(QHostAddress::Any);
+    if (!url().host().isEmpty())
+        address = QHostAddress(url().host());
+
+    // Validate address
+    if (address.isNull() || url().port() <= 0)
+    {
+        setErrorString(tr("Invalid TCP address: %1").arg(name()));
+        return false;
+    }
+
+    // Start server
+    if (!m_server.listen(address, static_cast<quint16>(url().port())))
+    {
+        setErrorString(m_server.errorString());
+        return false;
+    }
+
+    qDebug() << "Waiting for TCP connections on" << name();
+    return SocketBackend::open(mode | QIODevice::Unbuffered);
+}
+
+/**
+ * Closes the connection with the peer & stops listening
+ */
+void TcpServerBackend::close()
+{
+    if (socket())
+    {
+        auto peer = socket();
+        setSocket(nullptr);
+        peer->abort();
+        peer->deleteLater();
+    }
+
+    m_server.close();
+    SocketBackend::close();
+}
+
+/**
+ * Replaces the current peer with the newest incoming connection
+ */
+void TcpServerBackend::onNewConnection()
+{
+    while (m_server.hasPendingConnections())
+    {
+        auto peer = m_server.nextPendingConnection();
+
+        // Drop previous peer
+        if (socket())
+        {
+            auto previous = socket();
+            setSocket(nullptr);
+            previous->disconnect(this);
+            previous->abort();
+            previous->deleteLater();
+        }
+
+        // Register new peer
+        setSocket(peer);
+        configureSocket();
+        connect(peer, &QTcpSocket::disconnected, this,
+                &TcpServerBackend::onPeerDisconnected);
+
+        qDebug() << "TCP peer connected:" << peer->peerAddress().toString()
+                 << peer->peerPort();
+
+        // Read data that arrived before the peer was registered
+        if (peer->bytesAvailable() > 0)
+            emit readyRead();
+    }
+}
+
+/**
+ * Forgets the current peer when it closes the connection
+ */
+void TcpServerBackend::onPeerDisconnected()
+{
+    auto peer = qobject_cast<QTcpSocket *>(sender());
+    if (!peer || peer != socket())
+        return;
+
+    qDebug() << "TCP peer disconnected:" << peer->peerAddress().toString();
+    setSocket(nullptr);
+    peer->deleteLater();
+}
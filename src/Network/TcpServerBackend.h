@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NETWORK_TCP_SERVER_BACKEND_H
+#define NETWORK_TCP_SERVER_BACKEND_H
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <Network/SocketBackend.h>
+
+namespace Network
+{
+/**
+ * Waits for a network-attached device to connect to the given TCP port & exchanges
+ * raw data with it. Device names have the form @c tcp-server://address:port (use
+ * @c 0.0.0.0 to accept connections from any interface).
+ *
+ * Only one peer is served at a time: a new connection replaces the current one (so
+ * that devices that reboot without closing their connection can reconnect) & the
+ * device stays open when the peer disconnects.
+ */
+class TcpServerBackend : public SocketBackend
+{
+    Q_OBJECT
+
+public:
+    TcpServerBackend(const QUrl &url, QObject *parent = nullptr);
+
+    bool open(OpenMode mode) override;
+    void close() override;
+
+private slots:
+    void onNewConnection();
+    void onPeerDisconnected();
+
+private:
+    QTcpServer m_server;
+};
+}
+
+#endif
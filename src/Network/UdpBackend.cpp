@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include <QDebug>
+#include <QUrlQuery>
+
+#include <Network/UdpBackend.h>
+
+using namespace Network;
+
+/**
+ * Constructor function
+ */
+UdpBackend::UdpBackend(const QUrl &url, QObject *parent)
+    : SocketBackend(url, parent)
+    , m_replyToSender(false)
+    , m_peerPort(0)
+{
+    setSocket(&m_socket);
+}
+
+/**
+ * Binds the local port & registers the remote peer
+ */
+bool UdpBackend::open(OpenMode mode)
+{
+    // Get remote address
+    m_peerPort = 0;
+    m_peerAddress = QHostAddress(url().host());
+    if (m_peerAddress.isNull() || url().port() <= 0)
+    {
+        setErrorString(tr("Invalid UDP address: %1").arg(name()));
+        return false;
+    }
+
+    // Get local port
+    auto localPort = url().port();
+    QUrlQuery query(url());
+    if (query.hasQueryItem("local"))
+        localPort = query.queryItemValue("local").toInt();
+
+    // Reply to the sender of the last datagram if no peer is given
+    m_replyToSender = m_peerAddress == QHostAddress::AnyIPv4
+        || m_peerAddress == QHostAddress::Any;
+    if (m_replyToSender)
+        m_peerAddress.clear();
+    else
+        m_peerPort = static_cast<quint16>(url().port());
+
+    // Bind local port
+    if (!m_socket.bind(QHostAddress::Any, static_cast<quint16>(localPort),
+                       QUdpSocket::ShareAddress))
+    {
+        setErrorString(m_socket.errorString());
+        return false;
+    }
+
+    // Tune socket & open device
+    configureSocket();
+    m_readBuffer.clear();
+    qDebug() << "Listening for UDP datagrams on port" << localPort;
+    return SocketBackend::open(mode | QIODevice::Unbuffered);
+}
+
+/**
+ * Releases the local port
+ */
+void UdpBackend::close()
+{
+    m_socket.close();
+    SocketBackend::close();
+}
+
+/**
+ * Returns the number of received bytes that have not been read yet
+ */
+qint64 UdpBackend::bytesAvailable() const
+{
+    return m_readBuffer.size() + Serial::Backend::bytesAvailable();
+}
+
+/**
+ * Reads up to @a maxSize bytes of received data
+ */
+qint64 UdpBackend::readData(char *data, qint64 maxSize)
+{
+    const auto size = qMin<qint64>(maxSize, m_readBuffer.size());
+    memcpy(data, m_readBuffer.constData(), static_cast<size_t>(size));
+    m_readBuffer.remove(0, static_cast<int>(size));
+    return size;
+}
+
+/**
+ * Sends @a maxSize bytes to the remote peer as a single datagram, data is discarded
+ * if the peer is not known yet
+ */
+qint64 UdpBackend::writeData(const char *data, qint64 maxSize)
+{
+    if (m_peerAddress.isNull())
+        return maxSize;
+
+    return m_socket.writeDatagram(data, maxSize, m_peerAddress, m_peerPort);
+}
+
+/**
+ * Appends all pending datagrams to the read buffer, so that the application reads
+ * them with a single call
+ */
+void UdpBackend::onReadyRead()
+{
+    const int previousSize = m_readBuffer.size();
+    while (m_socket.hasPendingDatagrams())
+    {
+        // Get datagram size
+        const auto size = m_socket.pendingDatagramSize();
+        if (size < 0)
+            break;
+
+        // Read datagram directly into the read buffer
+        QHostAddress sender;
+        quint16 senderPort = 0;
+        const int offset = m_readBuffer.size();
+        m_readBuffer.resize(offset + static_cast<int>(size));
+        const auto read = m_socket.readDatagram(m_readBuffer.data() + offset, size,
+                                                &sender, &senderPort);
+        m_readBuffer.resize(offset + static_cast<int>(qMax<qint64>(0, read)));
+
+        // Reply to the last sender if no peer was given
+        if (m_replyToSender && read >= 0)
+        {
+            m_peerAddress = sender;
+            m_peerPort = senderPort;
+        }
+    }
+
+    if (m_readBuffer.size() > previousSize)
+        emit readyRead();
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NETWORK_UDP_BACKEND_H
+#define NETWORK_UDP_BACKEND_H
+
+#include <QUdpSocket>
+#include <QHostAddress>
+#include <Network/SocketBackend.h>
+
+namespace Network
+{
+/**
+ * Exchanges raw data with a network-attached device through UDP datagrams. Device
+ * names have the form @c udp://host:port:
+ *
+ * - Datagrams received on the local port are passed to the application. The local
+ *   port is the same as the remote port, unless a different port is given with the
+ *   @c local query item (e.g. @c udp://192.168.1.50:5000?local=5001).
+ * - Written data is sent to @c host:port. If the host is @c 0.0.0.0, data is sent to
+ *   the sender of the last received datagram instead.
+ *
+ * Each write call produces a single datagram.
+ */
+class UdpBackend : public SocketBackend
+{
+    Q_OBJECT
+
+public:
+    UdpBackend(const QUrl &url, QObject *parent = nullptr);
+
+    bool open(OpenMode mode) override;
+    void close() override;
+
+    qint64 bytesAvailable() const override;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+protected slots:
+    void onReadyRead() override;
+
+private:
+    QUdpSocket m_socket;
+    QByteArray m_readBuffer;
+
+    bool m_replyToSender;
+    quint16 m_peerPort;
+    QHostAddress m_peerAddress;
+};
+}
+
+#endif
@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include <QDebug>
+#include <QtEndian>
+#include <QDateTime>
+#include <QUrlQuery>
+#include <QHostAddress>
+
+#include <Misc/Tracer.h>
+#include <Serial/Manager.h>
+#include <Misc/LatencyMonitor.h>
+#include <Network/WebSocketServer.h>
+
+using namespace Network;
+
+/**
+ * Pointer to the only instance of the class
+ */
+static WebSocketServer *INSTANCE = nullptr;
+
+/**
+ * Interval between messages (in milliseconds), one display frame at 60 Hz
+ */
+static const int FRAME_INTERVAL = 16;
+
+/**
+ * Messages are not sent to clients with more than this amount of data in flight
+ */
+static const qint64 MAX_IN_FLIGHT = 8 * 1024 * 1024;
+
+/**
+ * Data received during a single frame is discarded beyond this size
+ */
+static const int MAX_BATCH_SIZE = 16 * 1024 * 1024;
+
+/**
+ * Partial lines longer than this size are sent as complete lines
+ */
+static const int MAX_LINE_SIZE = 64 * 1024;
+
+/**
+ * Size of the header of each record (timestamp & payload length)
+ */
+static const int RECORD_HEADER_SIZE = 12;
+
+/**
+ * Returns the wall-clock time (in milliseconds since the Unix epoch) that corresponds
+ * to the given @c Misc::LatencyMonitor::timestamp() value
+ */
+static double WallClock(const qint64 timestamp)
+{
+    static const double OFFSET = QDateTime::currentMSecsSinceEpoch()
+        - Misc::LatencyMonitor::timestamp() / 1e6;
+
+    return OFFSET + timestamp / 1e6;
+}
+
+/**
+ * Initializes the state of a new client
+ */
+WebSocketServer::Client::Client()
+    : lines(true)
+    , inFlight(0)
+    , sentMessages(0)
+    , droppedMessages(0)
+{
+}
+
+/**
+ * Constructor function
+ */
+WebSocketServer::WebSocketServer()
+    : m_server("QSerialTerminal", QWebSocketServer::NonSecureMode)
+    , m_droppedBytes(0)
+{
+    m_frameTimer.setSingleShot(true);
+    m_frameTimer.setInterval(FRAME_INTERVAL);
+    m_frameTimer.setTimerType(Qt::PreciseTimer);
+
+    connect(&m_frameTimer, &QTimer::timeout, this, &WebSocketServer::flush);
+    connect(&m_server, &QWebSocketServer::newConnection, this,
+            &WebSocketServer::onNewConnection);
+    connect(Serial::Manager::getInstance(), &Serial::Manager::dataReceived, this,
+            &WebSocketServer::onDataReceived);
+}
+
+/**
+ * Returns the only instance of the class
+ */
+WebSocketServer *WebSocketServer::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new WebSocketServer;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns @c true if the server is accepting connections
+ */
+bool WebSocketServer::isListening() const
+{
+    return m_server.isListening();
+}
+
+/**
+ * Returns the TCP port used by the server
+ */
+quint16 WebSocketServer::serverPort() const
+{
+    return m_server.serverPort();
+}
+
+/**
+ * Starts accepting connections on the given @a port of the loopback interface
+ */
+bool WebSocketServer::listen(const quint16 port)
+{
+    close();
+    if (!m_server.listen(QHostAddress::LocalHost, port))
+    {
+        qWarning() << "Cannot start WebSocket server:" << m_server.errorString();
+        return false;
+    }
+
+    qDebug() << "WebSocket server listening on ws://localhost:" << serverPort();
+    return true;
+}
+
+/**
+ * Stops accepting connections & disconnects all the clients
+ */
+void WebSocketServer::close()
+{
+    foreach (auto client, m_clients.keys())
+        client->abort();
+
+    m_server.close();
+}
+
+/**
+ * Sends the records accumulated during the last frame to every client (as a single
+ * message per client)
+ */
+void WebSocketServer::flush()
+{
+    TRACE_SCOPE("WebSocketServer::flush", "network");
+
+    for (auto it = m_clients.begin(); it != m_clients.end(); ++it)
+    {
+        const auto &batch = it->lines ? m_lineBatch : m_rawBatch;
+        if (batch.isEmpty())
+            continue;
+
+        // Skip clients that do not keep up with the data rate
+        if (it->inFlight > MAX_IN_FLIGHT)
+        {
+            ++it->droppedMessages;
+            continue;
+        }
+
+        // Send the same (implicitly shared) batch to every client
+        it.key()->sendBinaryMessage(batch);
+        it->inFlight += batch.size();
+        ++it->sentMessages;
+    }
+
+    m_rawBatch.clear();
+    m_lineBatch.clear();
+
+    // Report data discarded during the frame
+    if (m_droppedBytes > 0)
+    {
+        qWarning() << "WebSocket server discarded" << m_droppedBytes << "bytes";
+        m_droppedBytes = 0;
+    }
+}
+
+/**
+ * Registers incoming connections & obtains the mode requested by each client
+ */
+void WebSocketServer::onNewConnection()
+{
+    while (m_server.hasPendingConnections())
+    {
+        auto socket = m_server.nextPendingConnection();
+        connect(socket, &QWebSocket::disconnected, this,
+                &WebSocketServer::onDisconnected);
+        connect(socket, &QWebSocket::bytesWritten, this,
+                &WebSocketServer::onBytesWritten);
+
+        Client client;
+        client.lines = QUrlQuery(socket->requestUrl()).queryItemValue("mode") != "raw";
+        m_clients.insert(socket, client);
+
+        qDebug() << "WebSocket client connected:" << socket->requestUrl().toString();
+    }
+}
+
+/**
+ * Removes the disconnected client from the client list
+ */
+void WebSocketServer::onDisconnected()
+{
+    auto socket = qobject_cast<QWebSocket *>(sender());
+    if (!socket)
+        return;
+
+    auto client = m_clients.take(socket);
+    qDebug() << "WebSocket client disconnected, sent" << client.sentMessages
+             << "messages, dropped" << client.droppedMessages << "messages";
+
+    socket->deleteLater();
+}
+
+/**
+ * Updates the amount of data in flight of the client that wrote the given number of
+ * @a bytes to its socket
+ */
+void WebSocketServer::onBytesWritten(qint64 bytes)
+{
+    auto socket = qobject_cast<QWebSocket *>(sender());
+    if (socket && m_clients.contains(socket))
+    {
+        auto &client = m_clients[socket];
+        client.inFlight = qMax<qint64>(0, client.inFlight - bytes);
+    }
+}
+
+/**
+ * Appends the received @a data to the batches of the current frame & schedules the
+ * next flush
+ */
+void WebSocketServer::onDataReceived(const QByteArray &data)
+{
+    TRACE_SCOPE("WebSocketServer::onDataReceived", "network");
+
+    // Nobody is listening
+    if (m_clients.isEmpty())
+    {
+        m_partialLine.clear();
+        return;
+    }
+
+    // Limit memory usage if the event loop cannot keep up
+    if (m_rawBatch.size() + m_lineBatch.size() > MAX_BATCH_SIZE)
+    {
+        m_droppedBytes += data.size();
+        return;
+    }
+
+    // Check which batches are needed
+    bool raw = false;
+    bool lines = false;
+    foreach (const auto &client, m_clients)
+    {
+        raw |= !client.lines;
+        lines |= client.lines;
+    }
+
+    // Register reception time
+    const auto timestamp = WallClock(Serial::Manager::getInstance()->readTimestamp());
+
+    // Append raw record
+    if (raw)
+        appendRecord(m_rawBatch, timestamp, data.constData(), data.size());
+
+    // Append line records
+    if (lines)
+    {
+        int start = 0;
+        while (start < data.size())
+        {
+            // Get next line
+            auto end = data.indexOf('\n', start);
+            if (end < 0)
+            {
+                m_partialLine.append(data.constData() + start, data.size() - start);
+                if (m_partialLine.size() < MAX_LINE_SIZE)
+                    break;
+
+                start = data.size();
+            }
+            else
+            {
+                m_partialLine.append(data.constData() + start, end - start);
+                start = end + 1;
+            }
+
+            // Remove line break & append line
+            if (m_partialLine.endsWith('\r'))
+                m_partialLine.chop(1);
+
+            appendRecord(m_lineBatch, timestamp, m_partialLine.constData(),
+                         m_partialLine.size());
+            m_partialLine.clear();
+        }
+    }
+    else
+        m_partialLine.clear();
+
+    // Send batches at the end of the frame
+    if (!m_frameTimer.isActive())
+        m_frameTimer.start();
+}
+
+/**
+ * Appends a record with the given @a timestamp & payload to the given @a batch
+ */
+void WebSocketServer::appendRecord(QByteArray &batch, const double timestamp,
+                                   const char *data, const int size)
+{
+    // Convert timestamp to little-endian
+    quint64 bits;
+    memcpy(&bits, &timestamp, sizeof(bits));
+
+    // Write record header
+    uchar header[RECORD_HEADER_SIZE];
+    qToLittleEndian<quint64>(bits, header);
+    qToLittleEndian<quint32>(static_cast<quint32>(size), header + 8);
+
+    // Write record
+    batch.append(reinterpret_cast<const char *>(header), RECORD_HEADER_SIZE);
+    batch.append(data, size);
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NETWORK_WEB_SOCKET_SERVER_H
+#define NETWORK_WEB_SOCKET_SERVER_H
+
+#include <QHash>
+#include <QTimer>
+#include <QObject>
+#include <QWebSocket>
+#include <QWebSocketServer>
+
+namespace Network
+{
+/**
+ * Localhost WebSocket server that streams the data received from the current device
+ * to browser dashboards.
+ *
+ * Received data is not sent as it arrives: records are accumulated during one display
+ * frame (~16 ms) & each client receives a single binary message per frame, so that
+ * high-rate devices do not cost one message (and one system call) per line. Clients
+ * select the record type with the query of the URL:
+ *
+ * - @c ws://localhost:port/?mode=lines (default): one record per received line, line
+ *   breaks are removed
+ * - @c ws://localhost:port/?mode=raw: one record per block read from the device
+ *
+ * Each binary message contains a sequence of records (little-endian):
+ *
+ * @code
+ * float64  timestamp (milliseconds since the Unix epoch, with sub-millisecond digits)
+ * uint32   payload length
+ * uint8[]  payload
+ * @endcode
+ *
+ * Messages are not sent to clients that have more than a fixed amount of data in
+ * flight, dropped messages are counted per client.
+ */
+class WebSocketServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static WebSocketServer *getInstance();
+
+    bool isListening() const;
+    quint16 serverPort() const;
+
+public slots:
+    bool listen(const quint16 port);
+    void close();
+
+private slots:
+    void flush();
+    void onNewConnection();
+    void onDisconnected();
+    void onBytesWritten(qint64 bytes);
+    void onDataReceived(const QByteArray &data);
+
+private:
+    struct Client
+    {
+        Client();
+
+        bool lines;
+        qint64 inFlight;
+        qint64 sentMessages;
+        qint64 droppedMessages;
+    };
+
+    WebSocketServer();
+    void appendRecord(QByteArray &batch, const double timestamp, const char *data,
+                      const int size);
+
+private:
+    QTimer m_frameTimer;
+    QWebSocketServer m_server;
+    QHash<QWebSocket *, Client> m_clients;
+
+    QByteArray m_partialLine;
+    QByteArray m_rawBatch;
+    QByteArray m_lineBatch;
+    qint64 m_droppedBytes;
+};
+}
+
+#endif
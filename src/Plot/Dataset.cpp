@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <limits>
+
+#include <Misc/Tracer.h>
+#include <Plot/Dataset.h>
+#include <Serial/Manager.h>
+#include <Plot/FieldParser.h>
+
+using namespace Plot;
+
+/**
+ * Only instance of the class
+ */
+static Dataset *INSTANCE = nullptr;
+
+/**
+ * Constructor function
+ */
+Dataset::Dataset()
+    : m_enabled(false)
+    , m_changed(false)
+    , m_memoryLimit(Q_INT64_C(1024) * 1024 * 1024)
+    , m_sampleCount(0)
+    , m_firstSample(0)
+{
+    // Notify views at most once per frame
+    m_timer.setInterval(16);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &Dataset::notifyUpdates);
+
+    // Parse received data
+    connect(Serial::Manager::getInstance(), &Serial::Manager::dataReceived, this,
+            &Dataset::append);
+}
+
+/**
+ * Releases the memory used by the channels
+ */
+Dataset::~Dataset()
+{
+    qDeleteAll(m_channels);
+}
+
+/**
+ * Returns the only instance of the class
+ */
+Dataset *Dataset::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new Dataset;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns @c true if the dataset was created (it is created the first time that a plot
+ * is opened)
+ */
+bool Dataset::hasInstance()
+{
+    return INSTANCE != nullptr;
+}
+
+/**
+ * Returns @c true if received data is being parsed
+ */
+bool Dataset::enabled() const
+{
+    return m_enabled;
+}
+
+/**
+ * Returns the number of channels (i.e. the maximum number of fields found in a line)
+ */
+int Dataset::channelCount() const
+{
+    return m_channels.count();
+}
+
+/**
+ * Returns the number of samples appended since the dataset was cleared
+ */
+qint64 Dataset::sampleCount() const
+{
+    return m_sampleCount;
+}
+
+/**
+ * Returns the index of the oldest sample kept in memory, the first value of each
+ * channel corresponds to this sample
+ */
+qint64 Dataset::firstSample() const
+{
+    return m_firstSample;
+}
+
+/**
+ * Returns the number of bytes used by the samples & summaries of all channels
+ */
+qint64 Dataset::memoryUsage() const
+{
+    qint64 usage = 0;
+    foreach (auto channel, m_channels)
+        usage += channel->memoryUsage();
+
+    return usage;
+}
+
+/**
+ * Returns the maximum number of bytes used by the channels before old samples are
+ * discarded
+ */
+qint64 Dataset::memoryLimit() const
+{
+    return m_memoryLimit;
+}
+
+/**
+ * Returns the samples of the channel with the given @a index (missing values are NaN)
+ */
+const Pyramid *Dataset::channel(const int index) const
+{
+    Q_ASSERT(index >= 0 && index < m_channels.count());
+    return m_channels.at(index);
+}
+
+/**
+ * Changes the maximum number of bytes used by the channels, the oldest samples are
+ * discarded when the limit is exceeded (the last two blocks of each channel are always
+ * kept)
+ */
+void Dataset::setMemoryLimit(const qint64 bytes)
+{
+    m_memoryLimit = bytes;
+    discardOldSamples();
+}
+
+/**
+ * Removes all channels & samples
+ */
+void Dataset::clear()
+{
+    qDeleteAll(m_channels);
+    m_splitter.clear();
+    m_channels.clear();
+    m_sampleCount = 0;
+    m_firstSample = 0;
+    m_changed = true;
+}
+
+/**
+ * Enables or disables parsing received data
+ */
+void Dataset::setEnabled(const bool enabled)
+{
+    if (m_enabled == enabled)
+        return;
+
+    m_enabled = enabled;
+    m_splitter.clear();
+
+    if (enabled)
+        m_timer.start();
+    else
+        m_timer.stop();
+
+    emit enabledChanged();
+}
+
+/**
+ * Splits the given @a data into lines & appends the fields of each completed line, the
+ * last (incomplete) line is kept until its line break is received
+ */
+void Dataset::append(const QByteArray &data)
+{
+    if (!m_enabled || data.isEmpty())
+        return;
+
+    TRACE_SCOPE("Dataset::append", "plot");
+
+    const char *begin;
+    const char *end;
+    m_splitter.feed(data);
+    while (m_splitter.next(begin, end))
+        appendLine(begin, end);
+}
+
+/**
+ * Notifies views that new samples were appended (or that the dataset was cleared)
+ */
+void Dataset::notifyUpdates()
+{
+    if (m_changed)
+    {
+        m_changed = false;
+        emit updated();
+    }
+}
+
+/**
+ * Parses the line between @a begin & @a end & appends its fields to the channels
+ */
+void Dataset::appendLine(const char *begin, const char *end)
+{
+    // Parse fields
+    double values[MaxChannels];
+    const int count = FieldParser::parseLine(begin, end, values, MaxChannels);
+    if (count <= 0)
+        return;
+
+    // Register new channels (previous samples are reported as NaN)
+    while (m_channels.count() < count)
+        m_channels.append(new Pyramid(m_sampleCount));
+
+    // Append values
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    for (int i = 0; i < m_channels.count(); ++i)
+        m_channels[i]->append(i < count ? static_cast<float>(values[i]) : nan);
+
+    ++m_sampleCount;
+    m_changed = true;
+
+    // Check the memory limit when a new block is started
+    if (m_sampleCount % Pyramid::BlockSize == 1)
+        discardOldSamples();
+}
+
+/**
+ * Discards the oldest blocks of all channels until the memory limit is respected
+ */
+void Dataset::discardOldSamples()
+{
+    if (m_channels.isEmpty())
+        return;
+
+    // Get the number of blocks that each channel can keep
+    const qint64 blockUsage = Pyramid::blockMemoryUsage() * m_channels.count();
+    const qint64 blocks = qMax<qint64>(2, m_memoryLimit / blockUsage);
+
+    // Discard old blocks
+    const qint64 lastBlock = (m_sampleCount - 1) / Pyramid::BlockSize;
+    const qint64 first = (lastBlock - blocks + 1) * Pyramid::BlockSize;
+    if (first > m_firstSample)
+    {
+        m_firstSample = first;
+        foreach (auto channel, m_channels)
+            channel->discardBefore(first);
+
+        m_changed = true;
+    }
+}
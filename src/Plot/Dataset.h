@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PLOT_DATASET_H
+#define PLOT_DATASET_H
+
+#include <QTimer>
+#include <QVector>
+#include <QObject>
+#include <QByteArray>
+
+#include <Plot/Pyramid.h>
+#include <Plot/LineSplitter.h>
+
+namespace Plot
+{
+/**
+ * Parse stage of the plot: splits the data received by @c Serial::Manager into lines,
+ * extracts the numeric fields of each completed line with @c FieldParser & appends
+ * them to one channel per field (the sample index is the line number).
+ *
+ * Lines with fewer fields than the number of channels are padded with NaN values, so
+ * that all channels always have the same number of samples. Each channel is stored in
+ * a @c Pyramid, so that views can draw any interval of the history quickly. The
+ * oldest samples are discarded when the channels use more memory than the limit set
+ * with @c setMemoryLimit(). Views are notified with the @c updated() signal at most
+ * once per frame.
+ *
+ * The dataset is created the first time that a plot is opened. Parsing is disabled by
+ * default, it is enabled while a plot is visible.
+ */
+class Dataset : public QObject
+{
+    // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool enabled
+               READ enabled
+               WRITE setEnabled
+               NOTIFY enabledChanged)
+    Q_PROPERTY(int channelCount
+               READ channelCount
+               NOTIFY updated)
+    Q_PROPERTY(qint64 sampleCount
+               READ sampleCount
+               NOTIFY updated)
+    // clang-format on
+
+signals:
+    void updated();
+    void enabledChanged();
+
+public:
+    static const int MaxChannels = 64;
+
+    static Dataset *getInstance();
+    static bool hasInstance();
+
+    bool enabled() const;
+    int channelCount() const;
+    qint64 sampleCount() const;
+    qint64 firstSample() const;
+    qint64 memoryUsage() const;
+    qint64 memoryLimit() const;
+    const Pyramid *channel(const int index) const;
+
+    void setMemoryLimit(const qint64 bytes);
+
+public slots:
+    void clear();
+    void setEnabled(const bool enabled);
+    void append(const QByteArray &data);
+
+private slots:
+    void notifyUpdates();
+
+private:
+    Dataset();
+    ~Dataset();
+
+    void discardOldSamples();
+    void appendLine(const char *begin, const char *end);
+
+private:
+    bool m_enabled;
+    bool m_changed;
+    QTimer m_timer;
+    LineSplitter m_splitter;
+
+    qint64 m_memoryLimit;
+    qint64 m_sampleCount;
+    qint64 m_firstSample;
+    QVector<Pyramid *> m_channels;
+};
+}
+
+#endif
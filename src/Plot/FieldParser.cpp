@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cmath>
+#include <limits>
+
+#include <Plot/FieldParser.h>
+
+using namespace Plot;
+
+/**
+ * Powers of ten that can be represented exactly by a double
+ */
+static const double POWERS_OF_TEN[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                        1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                        1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+/**
+ * Returns @c true if the given character separates two fields
+ */
+static inline bool IsSeparator(const char c)
+{
+    return c == ',' || c == ';' || c == '\t' || c == ' ';
+}
+
+/**
+ * Returns @c true if the given character is a decimal digit
+ */
+static inline bool IsDigit(const char c)
+{
+    return static_cast<unsigned char>(c - '0') < 10;
+}
+
+/**
+ * Parses the numeric fields of the line between @a begin and @a end (without the line
+ * break) & writes up to @a maxValues values to the @a values array.
+ *
+ * @returns the number of fields written, or 0 if the line does not contain any number
+ *          (e.g. empty lines, headers or log messages)
+ */
+int FieldParser::parseLine(const char *begin, const char *end, double *values,
+                           const int maxValues)
+{
+    // Remove trailing carriage returns & spaces
+    while (end > begin && (end[-1] == '\r' || end[-1] == ' '))
+        --end;
+
+    int count = 0;
+    int numbers = 0;
+    const char *cursor = begin;
+    while (cursor < end && count < maxValues)
+    {
+        // Skip spaces before the field
+        while (cursor < end && *cursor == ' ')
+            ++cursor;
+
+        // Parse the field, the number must be followed by a separator
+        double value;
+        const char *start = cursor;
+        bool valid = parseNumber(cursor, end, value);
+        if (valid && cursor < end && !IsSeparator(*cursor))
+            valid = false;
+
+        // Not a number, look for a "name=value" or "name:value" field
+        if (!valid)
+        {
+            const char *assignment = nullptr;
+            for (cursor = start; cursor < end && !IsSeparator(*cursor); ++cursor)
+            {
+                if (*cursor == '=' || *cursor == ':')
+                    assignment = cursor;
+            }
+
+            const char *fieldEnd = cursor;
+            if (assignment)
+            {
+                const char *number = assignment + 1;
+                valid = parseNumber(number, fieldEnd, value) && number == fieldEnd;
+            }
+
+            if (!valid)
+                value = std::numeric_limits<double>::quiet_NaN();
+        }
+
+        // Register the field
+        values[count++] = value;
+        numbers += valid ? 1 : 0;
+
+        // Skip the separator (runs of spaces count as a single separator)
+        while (cursor < end && *cursor == ' ')
+            ++cursor;
+        if (cursor < end && IsSeparator(*cursor))
+            ++cursor;
+    }
+
+    return numbers > 0 ? count : 0;
+}
+
+/**
+ * Parses the decimal number that starts at @a cursor (e.g. "-12", "3.25", ".5" or
+ * "1e-3") & moves the cursor after its last character.
+ *
+ * @returns @c false if there is no number at the cursor (the cursor is not moved)
+ */
+bool FieldParser::parseNumber(const char *&cursor, const char *end, double &value)
+{
+    const char *p = cursor;
+
+    // Sign
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+    {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    // Integer part (only the first 19 significant digits fit in the mantissa)
+    quint64 mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool valid = false;
+    for (; p < end && IsDigit(*p); ++p)
+    {
+        valid = true;
+        if (digits < 19)
+        {
+            mantissa = mantissa * 10 + static_cast<quint64>(*p - '0');
+            digits += (mantissa > 0) ? 1 : 0;
+        }
+        else
+            ++exponent;
+    }
+
+    // Fractional part
+    if (p < end && *p == '.')
+    {
+        for (++p; p < end && IsDigit(*p); ++p)
+        {
+            valid = true;
+            if (digits < 19)
+            {
+                mantissa = mantissa * 10 + static_cast<quint64>(*p - '0');
+                digits += (mantissa > 0) ? 1 : 0;
+                --exponent;
+            }
+        }
+    }
+
+    // No digits
+    if (!valid)
+        return false;
+
+    // Exponent (ignored if it has no digits, e.g. "12e")
+    if (p < end && (*p == 'e' || *p == 'E'))
+    {
+        const char *e = p + 1;
+        bool negativeExponent = false;
+        if (e < end && (*e == '-' || *e == '+'))
+        {
+            negativeExponent = (*e == '-');
+            ++e;
+        }
+
+        if (e < end && IsDigit(*e))
+        {
+            int value = 0;
+            for (; e < end && IsDigit(*e); ++e)
+            {
+                if (value < 10000)
+                    value = value * 10 + (*e - '0');
+            }
+
+            exponent += negativeExponent ? -value : value;
+            p = e;
+        }
+    }
+
+    // Exact conversion (both the mantissa & the power of ten are exact doubles)
+    double result = static_cast<double>(mantissa);
+    if (mantissa == 0)
+        result = 0;
+    else if (digits <= 15 && exponent >= -22 && exponent <= 22)
+    {
+        if (exponent < 0)
+            result /= POWERS_OF_TEN[-exponent];
+        else
+            result *= POWERS_OF_TEN[exponent];
+    }
+
+    // Approximate conversion for very long numbers or very large exponents
+    else
+        result *= std::pow(10.0, exponent);
+
+    // Update cursor & result
+    value = negative ? -result : result;
+    cursor = p;
+    return true;
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PLOT_FIELD_PARSER_H
+#define PLOT_FIELD_PARSER_H
+
+#include <QtGlobal>
+
+namespace Plot
+{
+/**
+ * Extracts numeric fields from CSV-like telemetry lines (e.g. "12.5,-3,1e-3" or
+ * "temp=21.5;hum=40") without allocating memory or building intermediate strings.
+ *
+ * Fields are separated by commas, semicolons, tabs or runs of spaces. A field that is
+ * not a number is reported as NaN (so that the following fields keep their channel
+ * index), unless it has a "name=value" or "name:value" form, in which case the value
+ * is used. Numbers are parsed in a single pass (Clinger's fast path), the result is
+ * exact for numbers with up to 15 significant digits & exponents up to 22, which
+ * covers the values printed by firmware.
+ */
+class FieldParser
+{
+public:
+    static int parseLine(const char *begin, const char *end, double *values,
+                         const int maxValues);
+    static bool parseNumber(const char *&cursor, const char *end, double &value);
+};
+}
+
+#endif
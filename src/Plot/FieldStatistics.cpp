@@ -0,0 +1,457 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cmath>
+#include <limits>
+
+#include <QVariantMap>
+
+#include <Misc/Tracer.h>
+#include <Plot/Dataset.h>
+#include <Serial/Manager.h>
+#include <Plot/FieldParser.h>
+#include <Misc/LatencyMonitor.h>
+#include <Plot/FieldStatistics.h>
+
+using namespace Plot;
+
+/**
+ * Interval between result updates (one frame)
+ */
+static const int PUBLISH_INTERVAL = 16;
+
+/**
+ * Number of nanoseconds in a second
+ */
+static const qint64 NSECS_PER_SECOND = Q_INT64_C(1000000000);
+
+/**
+ * Only instance of the class
+ */
+static FieldStatistics *INSTANCE = nullptr;
+
+/**
+ * Constructor function
+ */
+FieldStatistics::FieldStatistics()
+    : m_window(60)
+    , m_enabled(false)
+    , m_changed(false)
+    , m_context(new QObject)
+    , m_publishTimer(nullptr)
+    , m_dirty(false)
+    , m_timestamp(0)
+    , m_publishedSecond(0)
+{
+    // Copy the published results at most once per frame
+    m_timer.setInterval(PUBLISH_INTERVAL);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &FieldStatistics::notifyUpdates);
+
+    // The worker thread is started the first time the statistics are enabled
+    m_context->moveToThread(&m_thread);
+}
+
+/**
+ * Stops the worker thread (if it was started)
+ */
+FieldStatistics::~FieldStatistics()
+{
+    m_thread.quit();
+    m_thread.wait();
+    delete m_context;
+}
+
+/**
+ * Returns the only instance of the class
+ */
+FieldStatistics *FieldStatistics::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new FieldStatistics;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns @c true if received data is parsed
+ */
+bool FieldStatistics::enabled() const
+{
+    return m_enabled;
+}
+
+/**
+ * Returns the length (in seconds) of the window used for the windowed statistics
+ */
+int FieldStatistics::window() const
+{
+    return m_window;
+}
+
+/**
+ * Returns the number of fields found in the received lines
+ */
+int FieldStatistics::fieldCount() const
+{
+    return m_fields.count();
+}
+
+/**
+ * Returns the statistics of each field as a list of maps, used by the QML panel
+ */
+QVariantList FieldStatistics::fields() const
+{
+    QVariantList list;
+    foreach (auto field, m_fields)
+    {
+        QVariantMap map;
+        map.insert("count", field.count);
+        map.insert("min", field.min);
+        map.insert("max", field.max);
+        map.insert("mean", field.mean);
+        map.insert("variance", field.variance);
+        map.insert("stddev", std::sqrt(field.variance));
+        map.insert("rate", field.rate);
+        map.insert("windowCount", field.windowCount);
+        map.insert("windowMin", field.windowMin);
+        map.insert("windowMax", field.windowMax);
+        map.insert("windowMean", field.windowMean);
+        map.insert("windowVariance", field.windowVariance);
+        map.insert("windowStddev", std::sqrt(field.windowVariance));
+        map.insert("windowRate", field.windowRate);
+        list.append(map);
+    }
+
+    return list;
+}
+
+/**
+ * Returns the statistics of each field, as published in the last frame
+ */
+const QVector<FieldStatistics::Field> &FieldStatistics::snapshot() const
+{
+    return m_fields;
+}
+
+/**
+ * Removes the statistics of all fields
+ */
+void FieldStatistics::clear()
+{
+    QMetaObject::invokeMethod(m_context, [=]() {
+        m_splitter.clear();
+        m_accumulators.clear();
+        m_dirty = true;
+    });
+}
+
+/**
+ * Changes the length of the window used for the windowed statistics (up to
+ * @c MaxWindow seconds)
+ */
+void FieldStatistics::setWindow(const int seconds)
+{
+    const int window = qBound(1, seconds, MaxWindow);
+    if (m_window != window)
+    {
+        m_window = window;
+        QMetaObject::invokeMethod(m_context, [=]() { m_dirty = true; });
+        emit windowChanged();
+    }
+}
+
+/**
+ * Enables or disables parsing received data, the worker thread is started the first
+ * time that the statistics are enabled
+ */
+void FieldStatistics::setEnabled(const bool enabled)
+{
+    if (m_enabled == enabled)
+        return;
+
+    m_enabled = enabled;
+    if (enabled)
+    {
+        startWorker();
+        m_timer.start();
+        m_connection = connect(Serial::Manager::getInstance(),
+                               &Serial::Manager::dataReceived, m_context,
+                               [=](const QByteArray &data) { process(data); });
+    }
+    else
+    {
+        m_timer.stop();
+        disconnect(m_connection);
+    }
+
+    // Start/stop publishing results from the worker thread
+    QMetaObject::invokeMethod(m_context, [=]() {
+        m_splitter.clear();
+        if (enabled)
+            m_publishTimer->start();
+        else
+            m_publishTimer->stop();
+    });
+
+    emit enabledChanged();
+}
+
+/**
+ * Starts the worker thread & creates the timer used to publish results at most once
+ * per frame (only the first time this function is called)
+ */
+void FieldStatistics::startWorker()
+{
+    if (m_thread.isRunning())
+        return;
+
+    m_thread.start();
+    QMetaObject::invokeMethod(m_context, [=]() {
+        m_publishTimer = new QTimer(m_context);
+        m_publishTimer->setInterval(PUBLISH_INTERVAL);
+        m_publishTimer->setTimerType(Qt::PreciseTimer);
+        connect(m_publishTimer, &QTimer::timeout, m_context, [=]() { publish(); });
+    });
+}
+
+/**
+ * Copies the results published by the worker thread & notifies views
+ */
+void FieldStatistics::notifyUpdates()
+{
+    if (m_changed.exchange(false))
+    {
+        m_mutex.lock();
+        m_fields = m_published;
+        m_mutex.unlock();
+
+        emit updated();
+    }
+}
+
+/**
+ * Splits the given @a data into lines & updates the statistics with the fields of each
+ * completed line (called in the worker thread)
+ */
+void FieldStatistics::process(const QByteArray &data)
+{
+    if (!m_enabled)
+    {
+        m_splitter.clear();
+        return;
+    }
+
+    TRACE_SCOPE("FieldStatistics::process", "plot");
+
+    // All the lines of the chunk share the same timestamp
+    m_timestamp = Misc::LatencyMonitor::timestamp();
+    const char *begin;
+    const char *end;
+    m_splitter.feed(data);
+    while (m_splitter.next(begin, end))
+        processLine(begin, end);
+}
+
+/**
+ * Parses the line between @a begin & @a end & adds each numeric field to the totals
+ * & to the summary of the current second of its field (called in the worker thread)
+ */
+void FieldStatistics::processLine(const char *begin, const char *end)
+{
+    // Parse fields
+    double values[Dataset::MaxChannels];
+    const int count = FieldParser::parseLine(begin, end, values, Dataset::MaxChannels);
+    if (count <= 0)
+        return;
+
+    // Register new fields
+    while (m_accumulators.count() < count)
+    {
+        Accumulator accumulator;
+        resetBucket(accumulator.total, -1);
+        accumulator.ring = QVector<Bucket>(MaxWindow, accumulator.total);
+        accumulator.firstTimestamp = m_timestamp;
+        accumulator.lastTimestamp = m_timestamp;
+        m_accumulators.append(accumulator);
+    }
+
+    // Update accumulators
+    const qint64 second = m_timestamp / NSECS_PER_SECOND;
+    for (int i = 0; i < count; ++i)
+    {
+        const double value = values[i];
+        if (std::isnan(value))
+            continue;
+
+        // Update totals
+        Accumulator &accumulator = m_accumulators[i];
+        Bucket &total = accumulator.total;
+        if (total.count == 0)
+            accumulator.firstTimestamp = m_timestamp;
+
+        accumulator.lastTimestamp = m_timestamp;
+        addValue(total, value);
+
+        // Update the summary of the current second (reusing the oldest ring entry)
+        Bucket &bucket = accumulator.ring[static_cast<int>(second % MaxWindow)];
+        if (bucket.second != second)
+            resetBucket(bucket, second);
+
+        addValue(bucket, value);
+    }
+
+    m_dirty = true;
+}
+
+/**
+ * Calculates the statistics of each field & hands them to the user interface thread.
+ * Windowed statistics are obtained by merging the summaries of the last seconds (Chan's
+ * parallel algorithm), results are also published once per second without new samples
+ * so that old samples leave the window (called in the worker thread).
+ */
+void FieldStatistics::publish()
+{
+    if (!m_enabled)
+        return;
+
+    // Nothing changed since the last update
+    const qint64 now = Misc::LatencyMonitor::timestamp();
+    const qint64 second = now / NSECS_PER_SECOND;
+    if (!m_dirty && second == m_publishedSecond)
+        return;
+
+    TRACE_SCOPE("FieldStatistics::publish", "plot");
+
+    const int window = m_window;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const auto fraction = static_cast<double>(now % NSECS_PER_SECOND) / NSECS_PER_SECOND;
+
+    QVector<Field> fields(m_accumulators.count());
+    for (int i = 0; i < m_accumulators.count(); ++i)
+    {
+        Field &field = fields[i];
+        const Accumulator &accumulator = m_accumulators.at(i);
+
+        // Totals
+        const Bucket &total = accumulator.total;
+        const double span = static_cast<double>(accumulator.lastTimestamp
+                                                - accumulator.firstTimestamp)
+            / NSECS_PER_SECOND;
+        field.count = total.count;
+        field.min = total.count > 0 ? total.min : nan;
+        field.max = total.count > 0 ? total.max : nan;
+        field.mean = total.count > 0 ? total.mean : nan;
+        field.variance = total.count > 1 ? total.m2 / (total.count - 1) : nan;
+        field.rate = (total.count > 1 && span > 0) ? (total.count - 1) / span : nan;
+
+        // Merge the summaries of the window
+        const Bucket summary = windowSummary(accumulator, second, window);
+
+        // Windowed statistics (the rate is calculated over the elapsed part of the
+        // window, the current second is not complete)
+        const qint64 age = now - accumulator.firstTimestamp;
+        const double elapsed = qMin(window - 1 + fraction,
+                                    static_cast<double>(age) / NSECS_PER_SECOND);
+        const qint64 count = summary.count;
+        field.windowCount = count;
+        field.windowMin = count > 0 ? summary.min : nan;
+        field.windowMax = count > 0 ? summary.max : nan;
+        field.windowMean = count > 0 ? summary.mean : nan;
+        field.windowVariance = count > 1 ? summary.m2 / (count - 1) : nan;
+        field.windowRate = (total.count > 0 && elapsed > 0) ? count / elapsed : nan;
+    }
+
+    // Hand results to the user interface thread
+    m_mutex.lock();
+    m_published = fields;
+    m_mutex.unlock();
+
+    m_changed = true;
+    m_dirty = false;
+    m_publishedSecond = second;
+}
+
+/**
+ * Merges the one-second summaries of the given @a accumulator over the @a window
+ * seconds that end at the given @a second. Timestamps start at zero when the
+ * application starts, so the window is clamped to the first second.
+ */
+FieldStatistics::Bucket FieldStatistics::windowSummary(const Accumulator &accumulator,
+                                                       const qint64 second,
+                                                       const int window)
+{
+    Bucket summary;
+    resetBucket(summary, second);
+    for (qint64 s = qMax<qint64>(0, second - window + 1); s <= second; ++s)
+    {
+        const Bucket &bucket = accumulator.ring.at(static_cast<int>(s % MaxWindow));
+        if (bucket.second == s)
+            mergeBucket(summary, bucket);
+    }
+
+    return summary;
+}
+
+/**
+ * Removes the samples of the given @a bucket & assigns it to the given @a second
+ */
+void FieldStatistics::resetBucket(Bucket &bucket, const qint64 second)
+{
+    bucket.second = second;
+    bucket.count = 0;
+    bucket.min = std::numeric_limits<double>::max();
+    bucket.max = std::numeric_limits<double>::lowest();
+    bucket.mean = 0;
+    bucket.m2 = 0;
+}
+
+/**
+ * Adds the given @a value to the @a bucket (Welford's algorithm)
+ */
+void FieldStatistics::addValue(Bucket &bucket, const double value)
+{
+    ++bucket.count;
+    const double delta = value - bucket.mean;
+    bucket.mean += delta / bucket.count;
+    bucket.m2 += delta * (value - bucket.mean);
+    bucket.min = qMin(bucket.min, value);
+    bucket.max = qMax(bucket.max, value);
+}
+
+/**
+ * Adds the samples summarized by the @a other bucket to the given @a bucket (Chan's
+ * parallel algorithm)
+ */
+void FieldStatistics::mergeBucket(Bucket &bucket, const Bucket &other)
+{
+    if (other.count == 0)
+        return;
+
+    const qint64 count = bucket.count + other.count;
+    const double delta = other.mean - bucket.mean;
+    bucket.mean += delta * other.count / count;
+    bucket.m2 += other.m2 + delta * delta * bucket.count * other.count / count;
+    bucket.min = qMin(bucket.min, other.min);
+    bucket.max = qMax(bucket.max, other.max);
+    bucket.count = count;
+}
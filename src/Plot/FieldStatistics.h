@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PLOT_FIELD_STATISTICS_H
+#define PLOT_FIELD_STATISTICS_H
+
+#include <atomic>
+
+#include <QMutex>
+#include <QTimer>
+#include <QThread>
+#include <QVector>
+#include <QObject>
+#include <QByteArray>
+#include <QVariantList>
+
+#include <Plot/LineSplitter.h>
+
+namespace Benchmark
+{
+class PlotBenchmark;
+}
+
+namespace Plot
+{
+/**
+ * Running statistics of the numeric fields of the received telemetry lines (see
+ * @c FieldParser): count, minimum, maximum, mean, variance & sample rate of each field,
+ * both since the statistics were cleared & over the last @c window seconds.
+ *
+ * Received data is split into lines & parsed in a worker thread, so the user interface
+ * thread only copies the published results. Totals are updated with Welford's
+ * algorithm. Windowed values are obtained from a ring of one-second summaries (count,
+ * min, max, mean & sum of squared deviations) that are merged when the results are
+ * published, so samples are never rescanned.
+ *
+ * Results are published by the worker at most once per frame & views are notified with
+ * the @c updated() signal. Parsing is disabled by default, it is enabled while the
+ * statistics panel is visible. The worker thread is started the first time that the
+ * panel is opened & its timers only run while the panel is visible.
+ */
+class FieldStatistics : public QObject
+{
+    // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool enabled
+               READ enabled
+               WRITE setEnabled
+               NOTIFY enabledChanged)
+    Q_PROPERTY(int window
+               READ window
+               WRITE setWindow
+               NOTIFY windowChanged)
+    Q_PROPERTY(int fieldCount
+               READ fieldCount
+               NOTIFY updated)
+    Q_PROPERTY(QVariantList fields
+               READ fields
+               NOTIFY updated)
+    // clang-format on
+
+signals:
+    void updated();
+    void windowChanged();
+    void enabledChanged();
+
+public:
+    static const int MaxWindow = 600;
+
+    /**
+     * Statistics of a single field, NaN values are used when there are no samples
+     */
+    struct Field
+    {
+        qint64 count;
+        double min;
+        double max;
+        double mean;
+        double variance;
+        double rate;
+
+        qint64 windowCount;
+        double windowMin;
+        double windowMax;
+        double windowMean;
+        double windowVariance;
+        double windowRate;
+    };
+
+    static FieldStatistics *getInstance();
+
+    bool enabled() const;
+    int window() const;
+    int fieldCount() const;
+    QVariantList fields() const;
+    const QVector<Field> &snapshot() const;
+
+public slots:
+    void clear();
+    void setWindow(const int seconds);
+    void setEnabled(const bool enabled);
+
+private slots:
+    void notifyUpdates();
+
+private:
+    FieldStatistics();
+    ~FieldStatistics();
+
+    void startWorker();
+    void process(const QByteArray &data);
+    void processLine(const char *begin, const char *end);
+    void publish();
+
+private:
+    /**
+     * Samples received during one second (mean & sum of squared deviations are
+     * updated with Welford's algorithm)
+     */
+    struct Bucket
+    {
+        qint64 second;
+        qint64 count;
+        double min;
+        double max;
+        double mean;
+        double m2;
+    };
+
+    /**
+     * State of a field in the worker thread: totals & ring of one-second summaries
+     */
+    struct Accumulator
+    {
+        Bucket total;
+        qint64 firstTimestamp;
+        qint64 lastTimestamp;
+        QVector<Bucket> ring;
+    };
+
+private:
+    static void resetBucket(Bucket &bucket, const qint64 second);
+    static void addValue(Bucket &bucket, const double value);
+    static void mergeBucket(Bucket &bucket, const Bucket &other);
+    static Bucket windowSummary(const Accumulator &accumulator, const qint64 second,
+                                const int window);
+
+    friend class Benchmark::PlotBenchmark;
+
+private:
+    QTimer m_timer;
+    QVector<Field> m_fields;
+
+    QMutex m_mutex;
+    QVector<Field> m_published;
+    std::atomic<int> m_window;
+    std::atomic<bool> m_enabled;
+    std::atomic<bool> m_changed;
+
+    QThread m_thread;
+    QObject *m_context;
+    QTimer *m_publishTimer;
+    QMetaObject::Connection m_connection;
+    bool m_dirty;
+    qint64 m_timestamp;
+    qint64 m_publishedSecond;
+    LineSplitter m_splitter;
+    QVector<Accumulator> m_accumulators;
+};
+}
+
+#endif
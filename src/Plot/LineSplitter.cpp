@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include <Plot/LineSplitter.h>
+
+using namespace Plot;
+
+/**
+ * Constructor function
+ */
+LineSplitter::LineSplitter()
+    : m_discarding(false)
+    , m_partialTaken(false)
+    , m_cursor(nullptr)
+    , m_end(nullptr)
+{
+}
+
+/**
+ * Returns @c true if the rest of an oversized line is being dropped
+ */
+bool LineSplitter::discarding() const
+{
+    return m_discarding;
+}
+
+/**
+ * Drops the current chunk & the incomplete line
+ */
+void LineSplitter::clear()
+{
+    m_data.clear();
+    m_partial.clear();
+    m_discarding = false;
+    m_partialTaken = false;
+    m_cursor = nullptr;
+    m_end = nullptr;
+}
+
+/**
+ * Sets the chunk of received @a data that is split by the following calls to
+ * @c next(), the chunk is shared (not copied)
+ */
+void LineSplitter::feed(const QByteArray &data)
+{
+    m_data = data;
+    m_cursor = m_data.constData();
+    m_end = m_cursor + m_data.size();
+}
+
+/**
+ * Obtains the next complete line of the chunk (without the line break), the pointers
+ * are valid until the next call to @c next(), @c feed() or @c clear().
+ *
+ * @returns @c false when the chunk contains no more complete lines, the incomplete line
+ *          at the end of the chunk is kept
+ */
+bool LineSplitter::next(const char *&begin, const char *&end)
+{
+    // Release the line completed in the previous call
+    if (m_partialTaken)
+    {
+        m_partial.clear();
+        m_partialTaken = false;
+    }
+
+    while (m_cursor && m_cursor < m_end)
+    {
+        auto lineEnd = static_cast<const char *>(memchr(m_cursor, '\n', m_end - m_cursor));
+        if (!lineEnd)
+        {
+            keepTail();
+            break;
+        }
+
+        const char *lineBegin = m_cursor;
+        m_cursor = lineEnd + 1;
+
+        // Drop the rest of an oversized line
+        if (m_discarding)
+        {
+            m_discarding = false;
+            continue;
+        }
+
+        // Complete the line received in previous chunks
+        if (!m_partial.isEmpty())
+        {
+            if (m_partial.size() + (lineEnd - lineBegin) > MaxLineSize)
+            {
+                m_partial.clear();
+                continue;
+            }
+
+            m_partial.append(lineBegin, static_cast<int>(lineEnd - lineBegin));
+            m_partialTaken = true;
+            begin = m_partial.constData();
+            end = begin + m_partial.size();
+            return true;
+        }
+
+        // Report lines directly from the received data
+        if (lineEnd - lineBegin > MaxLineSize)
+            continue;
+
+        begin = lineBegin;
+        end = lineEnd;
+        return true;
+    }
+
+    // Release the chunk
+    m_data.clear();
+    m_cursor = nullptr;
+    m_end = nullptr;
+    return false;
+}
+
+/**
+ * Keeps the incomplete line at the end of the chunk, or starts dropping data until the
+ * next line break if the line is longer than @c MaxLineSize
+ */
+void LineSplitter::keepTail()
+{
+    if (m_discarding)
+        return;
+
+    const qint64 size = m_end - m_cursor;
+    if (m_partial.size() + size > MaxLineSize)
+    {
+        m_partial.clear();
+        m_discarding = true;
+        return;
+    }
+
+    m_partial.append(m_cursor, static_cast<int>(size));
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PLOT_LINE_SPLITTER_H
+#define PLOT_LINE_SPLITTER_H
+
+#include <QByteArray>
+
+namespace Plot
+{
+/**
+ * Splits received data into lines without copying complete lines. Lines are read with
+ * @c next() after each chunk is given to @c feed(), the last (incomplete) line of a
+ * chunk is kept until its line break is received.
+ *
+ * Lines longer than @c MaxLineSize bytes are discarded: once a line exceeds the limit,
+ * everything up to the next line break is dropped, so that the rest of the line is
+ * never reported as a line of its own.
+ *
+ * Usage:
+ *
+ *     splitter.feed(data);
+ *     while (splitter.next(begin, end))
+ *         parse(begin, end);
+ */
+class LineSplitter
+{
+public:
+    static const int MaxLineSize = 64 * 1024;
+
+    LineSplitter();
+
+    bool discarding() const;
+
+    void clear();
+    void feed(const QByteArray &data);
+    bool next(const char *&begin, const char *&end);
+
+private:
+    void keepTail();
+
+private:
+    bool m_discarding;
+    bool m_partialTaken;
+    QByteArray m_data;
+    QByteArray m_partial;
+    const char *m_cursor;
+    const char *m_end;
+};
+}
+
+#endif
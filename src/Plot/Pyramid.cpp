@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include <Plot/Pyramid.h>
+
+using namespace Plot;
+
+/**
+ * Minimum & maximum of a group of samples (min > max if the group has no samples)
+ */
+struct Summary
+{
+    float min;
+    float max;
+};
+
+/**
+ * Samples & summary levels of a block, level @c n has @c BlockSize >> (3 * n) entries
+ * (level 0 is not stored, the samples themselves are used instead)
+ */
+struct Pyramid::Block
+{
+    float samples[BlockSize];
+    Summary *levels[Levels + 1];
+};
+
+/**
+ * Creates an empty pyramid, @a firstSample is the index of the first sample that will
+ * be appended (used by channels that appear after other channels received samples)
+ */
+Pyramid::Pyramid(const qint64 firstSample)
+    : m_count(firstSample)
+    , m_firstBlock(firstSample / BlockSize)
+{
+}
+
+/**
+ * Releases all the blocks
+ */
+Pyramid::~Pyramid()
+{
+    discardBefore(std::numeric_limits<qint64>::max());
+}
+
+/**
+ * Returns the number of samples appended (including discarded samples), i.e. the index
+ * of the next sample
+ */
+qint64 Pyramid::count() const
+{
+    return m_count;
+}
+
+/**
+ * Returns the index of the oldest sample that is still stored
+ */
+qint64 Pyramid::firstSample() const
+{
+    return qMin(m_firstBlock * BlockSize, m_count);
+}
+
+/**
+ * Returns the number of bytes used by the stored blocks
+ */
+qint64 Pyramid::memoryUsage() const
+{
+    return static_cast<qint64>(m_blocks.size()) * blockMemoryUsage();
+}
+
+/**
+ * Returns the sample with the given @a index, or NaN if the sample is not stored
+ */
+float Pyramid::at(const qint64 index) const
+{
+    if (m_blocks.empty() || index < firstSample() || index >= m_count)
+        return std::numeric_limits<float>::quiet_NaN();
+
+    const auto block = m_blocks[blockIndex(index)];
+    return block->samples[index % BlockSize];
+}
+
+/**
+ * Obtains the minimum & maximum values of the samples in the [@a first, @a last)
+ * interval by combining the largest aligned summaries that fit in it.
+ *
+ * @returns @c false if the interval does not contain any (non-NaN) sample
+ */
+bool Pyramid::range(qint64 first, const qint64 last, float &min, float &max) const
+{
+    min = std::numeric_limits<float>::max();
+    max = std::numeric_limits<float>::lowest();
+
+    // No blocks are stored yet when the history starts at a non-zero offset
+    if (m_blocks.empty())
+        return false;
+
+    first = qMax(first, firstSample());
+    const qint64 end = qMin(last, m_count);
+    while (first < end)
+    {
+        // Find the largest summary that starts at the current sample & fits in the
+        // interval (summaries never cross block boundaries)
+        int level = 0;
+        while (level < Levels)
+        {
+            const qint64 size = bucketSize(level + 1);
+            if (first % size != 0 || first + size > end)
+                break;
+
+            ++level;
+        }
+
+        // Combine the sample or the summary
+        const auto block = m_blocks[blockIndex(first)];
+        const qint64 offset = first % BlockSize;
+        if (level == 0)
+        {
+            const float value = block->samples[offset];
+            if (!std::isnan(value))
+            {
+                min = qMin(min, value);
+                max = qMax(max, value);
+            }
+        }
+        else
+        {
+            const Summary &summary = block->levels[level][offset >> (level * LevelShift)];
+            min = qMin(min, summary.min);
+            max = qMax(max, summary.max);
+        }
+
+        first += bucketSize(level);
+    }
+
+    return min <= max;
+}
+
+/**
+ * Splits the [@a first, @a last) interval in @a count columns & writes the minimum &
+ * maximum values of each column to the @a min & @a max arrays (min > max for columns
+ * without samples).
+ *
+ * The summaries are read from the coarsest level that has at least two entries per
+ * column, each summary is assigned to the column that contains its first sample (so
+ * column boundaries are accurate to half a column at most, which is not visible).
+ */
+void Pyramid::columns(const qint64 first, const qint64 last, const int count, float *min,
+                      float *max) const
+{
+    // Reset columns
+    std::fill(min, min + count, std::numeric_limits<float>::max());
+    std::fill(max, max + count, std::numeric_limits<float>::lowest());
+    if (count <= 0 || last <= first || m_blocks.empty())
+        return;
+
+    // Select the level to read
+    int level = 0;
+    const double perColumn = static_cast<double>(last - first) / count;
+    while (level < Levels && bucketSize(level + 1) * 2 <= perColumn)
+        ++level;
+
+    // Combine the summaries of each column
+    const qint64 size = bucketSize(level);
+    const qint64 end = qMin(last, m_count);
+    qint64 index = qMax(first, firstSample());
+    index -= index % size;
+    for (; index < end; index += size)
+    {
+        float lo, hi;
+        const auto block = m_blocks[blockIndex(index)];
+        const qint64 offset = index % BlockSize;
+        if (level == 0)
+        {
+            lo = hi = block->samples[offset];
+            if (std::isnan(lo))
+                continue;
+        }
+        else
+        {
+            const Summary &summary = block->levels[level][offset >> (level * LevelShift)];
+            lo = summary.min;
+            hi = summary.max;
+        }
+
+        const auto column = static_cast<int>(qMax<qint64>(0, index - first) / perColumn);
+        if (column < count)
+        {
+            min[column] = qMin(min[column], lo);
+            max[column] = qMax(max[column], hi);
+        }
+    }
+}
+
+/**
+ * Appends the given @a value & updates the summaries that contain it
+ */
+void Pyramid::append(const float value)
+{
+    // Get the block of the new sample
+    const qint64 offset = m_count % BlockSize;
+    const auto index = blockIndex(m_count);
+    while (index >= m_blocks.size())
+        m_blocks.push_back(allocateBlock());
+
+    // Store sample
+    auto block = m_blocks[index];
+    block->samples[offset] = value;
+    ++m_count;
+
+    // Update summaries
+    if (!std::isnan(value))
+    {
+        for (int level = 1; level <= Levels; ++level)
+        {
+            Summary &summary = block->levels[level][offset >> (level * LevelShift)];
+            summary.min = qMin(summary.min, value);
+            summary.max = qMax(summary.max, value);
+        }
+    }
+}
+
+/**
+ * Discards the blocks that only contain samples older than the given @a index
+ */
+void Pyramid::discardBefore(const qint64 index)
+{
+    while (!m_blocks.empty() && (m_firstBlock + 1) * BlockSize <= index)
+    {
+        auto block = m_blocks.front();
+        for (int level = 1; level <= Levels; ++level)
+            delete[] block->levels[level];
+
+        delete block;
+        m_blocks.pop_front();
+        ++m_firstBlock;
+    }
+
+    if (m_blocks.empty())
+        m_firstBlock = qMax(m_firstBlock, qMin(index, m_count) / BlockSize);
+}
+
+/**
+ * Returns the number of bytes used by a block (samples & summaries)
+ */
+qint64 Pyramid::blockMemoryUsage()
+{
+    qint64 summaries = 0;
+    for (int level = 1; level <= Levels; ++level)
+        summaries += (BlockSize >> (level * LevelShift)) * sizeof(Summary);
+
+    return sizeof(Block) + summaries;
+}
+
+/**
+ * Returns the number of samples summarized by each entry of the given @a level
+ */
+qint64 Pyramid::bucketSize(const int level)
+{
+    return Q_INT64_C(1) << (level * LevelShift);
+}
+
+/**
+ * Returns the position in @c m_blocks of the block that contains the sample with the
+ * given @a index
+ */
+size_t Pyramid::blockIndex(const qint64 index) const
+{
+    return static_cast<size_t>(index / BlockSize - m_firstBlock);
+}
+
+/**
+ * Allocates a new block, samples are initialized to NaN & summaries are empty
+ */
+Pyramid::Block *Pyramid::allocateBlock()
+{
+    auto block = new Block;
+    std::fill(block->samples, block->samples + BlockSize,
+              std::numeric_limits<float>::quiet_NaN());
+
+    block->levels[0] = nullptr;
+    for (int level = 1; level <= Levels; ++level)
+    {
+        const qint64 size = BlockSize >> (level * LevelShift);
+        block->levels[level] = new Summary[size];
+        std::fill(block->levels[level], block->levels[level] + size,
+                  Summary{ std::numeric_limits<float>::max(),
+                           std::numeric_limits<float>::lowest() });
+    }
+
+    return block;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PLOT_PYRAMID_H
+#define PLOT_PYRAMID_H
+
+#include <deque>
+#include <QtGlobal>
+
+namespace Plot
+{
+/**
+ * Multi-resolution min/max summary of the samples of a single channel, used to draw
+ * long time series at any zoom level with a bounded amount of work.
+ *
+ * Samples are stored (as single-precision floats) in blocks of @c BlockSize samples.
+ * Each block also holds @c Levels summary levels: level @c n stores the minimum &
+ * maximum of every group of 8^n samples, up to a single summary for the whole block.
+ * Summaries are updated incrementally when a sample is appended (one comparison per
+ * level), so appending is O(1) & there is never a full rebuild.
+ *
+ * @c range() returns the exact minimum & maximum of any interval by combining the
+ * largest aligned summaries that fit in it. @c columns() splits an interval in pixel
+ * columns & reads a level with 2 to 16 summaries per column, so the cost of drawing a
+ * frame depends on the width of the plot, not on the number of visible samples. Old
+ * samples are discarded one block at a time.
+ *
+ * Sample indexes are absolute (they keep growing when old blocks are discarded). NaN
+ * samples are stored, but ignored by the summaries.
+ */
+class Pyramid
+{
+public:
+    static const int Levels = 6;
+    static const int LevelShift = 3;
+    static const qint64 BlockSize = Q_INT64_C(1) << (Levels * LevelShift);
+
+    Pyramid(const qint64 firstSample = 0);
+    ~Pyramid();
+
+    qint64 count() const;
+    qint64 firstSample() const;
+    qint64 memoryUsage() const;
+
+    float at(const qint64 index) const;
+    bool range(qint64 first, const qint64 last, float &min, float &max) const;
+    void columns(const qint64 first, const qint64 last, const int count, float *min,
+                 float *max) const;
+
+    void append(const float value);
+    void discardBefore(const qint64 index);
+
+    static qint64 bucketSize(const int level);
+    static qint64 blockMemoryUsage();
+
+private:
+    struct Block;
+    Block *allocateBlock();
+    size_t blockIndex(const qint64 index) const;
+
+private:
+    qint64 m_count;
+    qint64 m_firstBlock;
+    std::deque<Block *> m_blocks;
+};
+}
+
+#endif
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Serial/Backend.h>
+#include <Serial/ProcessBackend.h>
+#include <Serial/SerialPortBackend.h>
+#include <Network/UdpBackend.h>
+#include <Network/Rfc2217Backend.h>
+#include <Network/TcpClientBackend.h>
+#include <Network/TcpServerBackend.h>
+
+#ifdef Q_OS_UNIX
+#    include <Serial/PtyProcessBackend.h>
+#endif
+
+using namespace Serial;
+
+/**
+ * Constructor function
+ */
+Backend::Backend(QObject *parent)
+    : QIODevice(parent)
+    , m_baudRate(9600)
+    , m_parity(QSerialPort::NoParity)
+    , m_dataBits(QSerialPort::Data8)
+    , m_stopBits(QSerialPort::OneStop)
+    , m_flowControl(QSerialPort::NoFlowControl)
+    , m_boundedReadBuffer(false)
+{
+}
+
+/**
+ * Creates the backend that corresponds to the given device @a name:
+ *
+ * - @c rfc2217://host:port opens a serial port exposed by a terminal server through
+ *   the Telnet COM port control protocol (RFC 2217)
+ * - @c tcp://host:port connects to a TCP server & exchanges raw data with it
+ * - @c tcp-server://address:port waits for a device to connect to the given TCP port
+ * - @c udp://host:port exchanges raw data through UDP datagrams
+ * - @c exec:command runs a local program & exchanges data through its standard
+ *   input & output
+ * - @c pty:command runs a local program attached to a pseudo-terminal (Unix only)
+ * - Any other name is treated as a local serial port (e.g. "COM3", "ttyUSB0" or
+ *   "/dev/pts/4")
+ */
+Backend *Backend::create(const QString &name)
+{
+    if (name.startsWith(QStringLiteral("rfc2217://"), Qt::CaseInsensitive))
+        return new Network::Rfc2217Backend(QUrl(name));
+    if (name.startsWith(QStringLiteral("tcp://"), Qt::CaseInsensitive))
+        return new Network::TcpClientBackend(QUrl(name));
+    if (name.startsWith(QStringLiteral("tcp-server://"), Qt::CaseInsensitive))
+        return new Network::TcpServerBackend(QUrl(name));
+    if (name.startsWith(QStringLiteral("udp://"), Qt::CaseInsensitive))
+        return new Network::UdpBackend(QUrl(name));
+    if (name.startsWith(QStringLiteral("exec:")))
+        return new ProcessBackend(name.mid(5));
+#ifdef Q_OS_UNIX
+    if (name.startsWith(QStringLiteral("pty:")))
+        return new PtyProcessBackend(name.mid(4));
+#endif
+
+    return new SerialPortBackend(name);
+}
+
+/**
+ * Returns the local serial port used by the backend (if any), which gives access to
+ * platform-specific features, such as the native handle of the device
+ */
+QSerialPort *Backend::serialPort() const
+{
+    return nullptr;
+}
+
+/**
+ * Writes as much buffered data as possible to the underlying device without waiting for
+ * the event loop & returns @c true if any data was written. Backends that write data
+ * immediately do not need to implement this function.
+ */
+bool Backend::flush()
+{
+    return false;
+}
+
+/**
+ * Backends are sequential devices
+ */
+bool Backend::isSequential() const
+{
+    return true;
+}
+
+/**
+ * Returns the configured baud rate
+ */
+qint32 Backend::baudRate() const
+{
+    return m_baudRate;
+}
+
+/**
+ * Returns the configured parity
+ */
+QSerialPort::Parity Backend::parity() const
+{
+    return m_parity;
+}
+
+/**
+ * Returns the configured number of data bits
+ */
+QSerialPort::DataBits Backend::dataBits() const
+{
+    return m_dataBits;
+}
+
+/**
+ * Returns the configured number of stop bits
+ */
+QSerialPort::StopBits Backend::stopBits() const
+{
+    return m_stopBits;
+}
+
+/**
+ * Returns the configured flow control mode
+ */
+QSerialPort::FlowControl Backend::flowControl() const
+{
+    return m_flowControl;
+}
+
+/**
+ * Returns @c true if the read buffer of the device should be bounded
+ */
+bool Backend::boundedReadBuffer() const
+{
+    return m_boundedReadBuffer;
+}
+
+/**
+ * Changes the baud rate, subclasses apply the value to the device
+ */
+void Backend::setBaudRate(const qint32 rate)
+{
+    m_baudRate = rate;
+}
+
+/**
+ * Changes the parity, subclasses apply the value to the device
+ */
+void Backend::setParity(const QSerialPort::Parity parity)
+{
+    m_parity = parity;
+}
+
+/**
+ * Changes the number of data bits, subclasses apply the value to the device
+ */
+void Backend::setDataBits(const QSerialPort::DataBits dataBits)
+{
+    m_dataBits = dataBits;
+}
+
+/**
+ * Changes the number of stop bits, subclasses apply the value to the device
+ */
+void Backend::setStopBits(const QSerialPort::StopBits stopBits)
+{
+    m_stopBits = stopBits;
+}
+
+/**
+ * Changes the flow control mode, subclasses apply the value to the device
+ */
+void Backend::setFlowControl(const QSerialPort::FlowControl flowControl)
+{
+    m_flowControl = flowControl;
+}
+
+/**
+ * Bounds (or unbounds) the read buffer, subclasses apply the value to the device
+ */
+void Backend::setBoundedReadBuffer(const bool bounded)
+{
+    m_boundedReadBuffer = bounded;
+}
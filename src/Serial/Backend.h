@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SERIAL_BACKEND_H
+#define SERIAL_BACKEND_H
+
+#include <QIODevice>
+#include <QSerialPort>
+
+namespace Serial
+{
+/**
+ * Interface of the devices used by @c Manager to exchange data (local serial ports,
+ * serial ports exposed by terminal servers, etc).
+ *
+ * Backends are sequential @c QIODevice objects that emit @c readyRead() when data is
+ * received & @c bytesWritten() when data is written to the device. Line configuration
+ * changes are applied immediately if the device is open, otherwise they are applied
+ * when the device is opened.
+ *
+ * Backends report fatal errors with the @c errorOccurred() signal (after which the
+ * device is closed by @c Manager) & line errors (parity, framing, overrun & break) with
+ * the @c lineError() signal, if the underlying device reports them. Devices whose data
+ * stream can end (programs, TCP connections, etc) emit @c readChannelFinished() before
+ * reporting the end as an error.
+ *
+ * While a consumer that cannot lose data is registered, @c Manager asks the backend to
+ * bound its read buffer, so that unread data stays in the device (or driver) & flow
+ * control can stop the remote side. Backends without such a buffer ignore the request.
+ */
+class Backend : public QIODevice
+{
+    Q_OBJECT
+
+signals:
+    void lineError(const int errors);
+    void errorOccurred(const QString &error);
+
+public:
+    enum LineError
+    {
+        OverrunError = 0x02,
+        ParityError = 0x04,
+        FramingError = 0x08,
+        BreakError = 0x10
+    };
+
+    Backend(QObject *parent = nullptr);
+
+    static Backend *create(const QString &name);
+
+    virtual QString name() const = 0;
+    virtual QSerialPort *serialPort() const;
+    virtual bool isSequential() const override;
+    virtual bool flush();
+
+    qint32 baudRate() const;
+    QSerialPort::Parity parity() const;
+    QSerialPort::DataBits dataBits() const;
+    QSerialPort::StopBits stopBits() const;
+    QSerialPort::FlowControl flowControl() const;
+    bool boundedReadBuffer() const;
+
+    virtual void setBaudRate(const qint32 rate);
+    virtual void setParity(const QSerialPort::Parity parity);
+    virtual void setDataBits(const QSerialPort::DataBits dataBits);
+    virtual void setStopBits(const QSerialPort::StopBits stopBits);
+    virtual void setFlowControl(const QSerialPort::FlowControl flowControl);
+    virtual void setBoundedReadBuffer(const bool bounded);
+
+private:
+    qint32 m_baudRate;
+    QSerialPort::Parity m_parity;
+    QSerialPort::DataBits m_dataBits;
+    QSerialPort::StopBits m_stopBits;
+    QSerialPort::FlowControl m_flowControl;
+    bool m_boundedReadBuffer;
+};
+}
+
+#endif
@@ -28,7 +28,9 @@
 
 #include <Serial/Console.h>
 #include <Serial/Manager.h>
+#include <Misc/Tracer.h>
 #include <Misc/Utilities.h>
+#include <Misc/LatencyMonitor.h>
 
 using namespace Serial;
 static Console *INSTANCE = nullptr;
@@ -83,6 +85,8 @@ Console::Console()
     , m_lineEnding(LineEnding::NoLineEnding)
     , m_displayMode(DisplayMode::DisplayPlainText)
     , m_historyItem(0)
+    , m_dataTimestamp(0)
+    , m_displayTimestamp(0)
     , m_echo(false)
     , m_autoscroll(true)
     , m_showTimestamp(false)
@@ -200,6 +204,46 @@ QString Console::currentHistoryString() const
     return "";
 }
 
+/**
+ * Returns the time at which the data that is currently being displayed was read from
+ * the device, or 0 if the console is not displaying received data (e.g. when echoing
+ * sent data). This is used to measure the latency of the data pipeline.
+ */
+qint64 Console::displayTimestamp() const
+{
+    return m_displayTimestamp;
+}
+
+/**
+ * Returns the number of bytes used by the list of sent commands
+ */
+qint64 Console::historySize() const
+{
+    qint64 bytes = 0;
+    foreach (auto item, m_historyItems)
+        bytes += sizeof(QString) + item.capacity() * static_cast<qint64>(sizeof(QChar));
+
+    return bytes;
+}
+
+/**
+ * Returns the number of bytes reserved by the incoming data buffer (which may be larger
+ * than the amount of pending data, see @c clear()).
+ */
+qint64 Console::dataBufferSize() const
+{
+    return m_dataBuffer.capacity();
+}
+
+/**
+ * Returns the number of bytes reserved by the text buffer, which contains all the text
+ * displayed by the console since it was last cleared.
+ */
+qint64 Console::textBufferSize() const
+{
+    return m_textBuffer.capacity() * static_cast<qint64>(sizeof(QChar));
+}
+
 /**
  * Returns a list with the available data (sending) modes. This list must be synchronized
  * with the order of the @c DataMode enums.
@@ -451,52 +495,38 @@ void Console::setDisplayMode(const DisplayMode mode)
  */
 void Console::append(const QString &string)
 {
+    TRACE_SCOPE("Console::append", "console");
+
     // Abort on empty strings
     if (string.isEmpty())
         return;
 
-    // Only use \n as line separator
-    auto data = string;
-    data = data.replace("\r\n", "\n");
-    data = data.replace("\r", "\n");
-
-    // Initialize final string
+    // Only use \n as line separator (replace \r\n & \r in a single pass)
     QString processedString;
-    processedString.reserve(data.length());
-
-    // Create list with lines (keep separators)
-    QStringList tokens;
-    QString currentToken;
-    for (int i = 0; i < data.length(); ++i)
+    processedString.reserve(string.length());
+    const auto length = string.length();
+    const auto input = string.constData();
+    for (int i = 0; i < length; ++i)
     {
-        if (data.at(i) == "\n")
+        if (input[i] == QLatin1Char('\r'))
         {
-            tokens.append(currentToken);
-            tokens.append("\n");
-            currentToken.clear();
+            processedString.append(QLatin1Char('\n'));
+            if (i + 1 < length && input[i + 1] == QLatin1Char('\n'))
+                ++i;
         }
 
         else
-            currentToken += data.at(i);
+            processedString.append(input[i]);
     }
 
-    // Add last item to list
-    if (!currentToken.isEmpty())
-        tokens.append(currentToken);
-
-    // Process lines
-    while (!tokens.isEmpty())
-    {
-        auto token = tokens.first();
-        processedString.append(token);
-        m_isStartingLine = (token == "\n");
-        tokens.removeFirst();
-    }
+    // Check if the next string starts a new line
+    m_isStartingLine = processedString.endsWith(QLatin1Char('\n'));
 
     // Add data to saved text buffer
     m_textBuffer.append(processedString);
 
     // Update UI
+    TRACE_SCOPE("Console::stringReceived", "signal");
     emit dataReceived();
     emit stringReceived(processedString);
 }
@@ -508,8 +538,17 @@ void Console::append(const QString &string)
  */
 void Console::displayData()
 {
+    TRACE_SCOPE("Console::displayData", "timer");
+
     if (!m_dataBuffer.isEmpty())
     {
+        // Register the time that the data spent in the buffer
+        auto monitor = Misc::LatencyMonitor::getInstance();
+        auto elapsed = Misc::LatencyMonitor::timestamp() - m_dataTimestamp;
+        monitor->record(Misc::LatencyMonitor::Stage::Drain, elapsed);
+
+        // Display data
+        m_displayTimestamp = m_dataTimestamp;
         if (showTimestamp())
         {
             QString header;
@@ -522,6 +561,7 @@ void Console::displayData()
             append(dataToString(m_dataBuffer));
 
         m_dataBuffer.clear();
+        m_displayTimestamp = 0;
     }
 }
 
@@ -553,6 +593,9 @@ void Console::onDataSent(const QByteArray &data)
  */
 void Console::onDataReceived(const QByteArray &data)
 {
+    if (m_dataBuffer.isEmpty())
+        m_dataTimestamp = Manager::getInstance()->readTimestamp();
+
     m_dataBuffer.append(data);
 }
 
@@ -597,6 +640,8 @@ QByteArray Console::hexToBytes(const QString &data)
  */
 QString Console::dataToString(const QByteArray &data)
 {
+    TRACE_SCOPE("Console::dataToString", "console");
+
     switch (displayMode())
     {
         case DisplayMode::DisplayPlainText:
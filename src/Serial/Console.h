@@ -27,6 +27,12 @@
 #include <QObject>
 #include <QStringList>
 
+namespace Benchmark
+{
+class FuzzBenchmark;
+class ConsoleBenchmark;
+}
+
 namespace Serial
 {
 class Console : public QObject
@@ -112,6 +118,11 @@ public:
     LineEnding lineEnding() const;
     DisplayMode displayMode() const;
     QString currentHistoryString() const;
+    qint64 displayTimestamp() const;
+
+    qint64 historySize() const;
+    qint64 dataBufferSize() const;
+    qint64 textBufferSize() const;
 
     Q_INVOKABLE QStringList dataModes() const;
     Q_INVOKABLE QStringList lineEndings() const;
@@ -139,6 +150,9 @@ private slots:
     void onDataReceived(const QByteArray &data);
 
 private:
+    friend class Benchmark::FuzzBenchmark;
+    friend class Benchmark::ConsoleBenchmark;
+
     Console();
     QByteArray hexToBytes(const QString &data);
     QString dataToString(const QByteArray &data);
@@ -152,6 +166,8 @@ private:
 
     QTimer m_timer;
     int m_historyItem;
+    qint64 m_dataTimestamp;
+    qint64 m_displayTimestamp;
 
     bool m_echo;
     bool m_autoscroll;
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Misc/Tracer.h>
+#include <Serial/Manager.h>
+#include <Serial/Dispatcher.h>
+#include <Serial/Subscription.h>
+
+using namespace Serial;
+
+/**
+ * Pointer to the only instance of the class
+ */
+static Dispatcher *INSTANCE = nullptr;
+
+/**
+ * Constructor function
+ */
+Dispatcher::Dispatcher()
+{
+    connect(Manager::getInstance(), &Manager::dataReceived, this,
+            &Dispatcher::onDataReceived);
+}
+
+/**
+ * Returns the only instance of the class
+ */
+Dispatcher *Dispatcher::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new Dispatcher;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns the state & the counters of every subscription
+ */
+QJsonArray Dispatcher::toJson() const
+{
+    QJsonArray array;
+    foreach (auto subscription, m_subscriptions)
+        array.append(subscription->toJson());
+
+    return array;
+}
+
+/**
+ * Returns the registered subscriptions
+ */
+QList<Subscription *> Dispatcher::subscriptions() const
+{
+    return m_subscriptions;
+}
+
+/**
+ * Registers the given @a subscription (called by the @c Subscription constructor)
+ */
+void Dispatcher::add(Subscription *subscription)
+{
+    Q_ASSERT(subscription);
+
+    m_subscriptions.append(subscription);
+    connect(subscription, &Subscription::spaceAvailable, this,
+            &Dispatcher::updateReadState);
+
+    updateReadState();
+}
+
+/**
+ * Unregisters the given @a subscription (called by the @c Subscription destructor)
+ */
+void Dispatcher::remove(Subscription *subscription)
+{
+    m_subscriptions.removeAll(subscription);
+    updateReadState();
+}
+
+/**
+ * Limits reading from the device to the free space of the fullest blocking
+ * subscription, reading is paused while a blocking subscription is full
+ */
+void Dispatcher::updateReadState()
+{
+    qint64 limit = -1;
+    foreach (auto subscription, m_subscriptions)
+    {
+        if (subscription->policy() == Subscription::Policy::Block)
+        {
+            const auto space = subscription->freeSpace();
+            if (limit < 0 || space < limit)
+                limit = space;
+        }
+    }
+
+    Manager::getInstance()->setReadLimit(limit);
+}
+
+/**
+ * Appends the received @a data to every subscription
+ */
+void Dispatcher::onDataReceived(const QByteArray &data)
+{
+    TRACE_SCOPE("Dispatcher::onDataReceived", "serial");
+
+    // Iterate over a copy, consumers may remove their subscription
+    const auto subscriptions = m_subscriptions;
+    foreach (auto subscription, subscriptions)
+    {
+        if (m_subscriptions.contains(subscription))
+            subscription->push(data);
+    }
+
+    updateReadState();
+}
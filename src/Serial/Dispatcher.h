@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SERIAL_DISPATCHER_H
+#define SERIAL_DISPATCHER_H
+
+#include <QList>
+#include <QObject>
+#include <QJsonArray>
+
+namespace Serial
+{
+class Subscription;
+
+/**
+ * Distributes the data received by @c Manager to all the registered subscriptions
+ * (see @c Subscription), so that each consumer reads data at its own pace without
+ * stalling the other consumers or the device reader.
+ *
+ * Reading from the device is paused while a subscription with the @c Block policy is
+ * full & resumed when its consumer takes data from the queue (data is kept by the
+ * device backend in the meantime).
+ */
+class Dispatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    static Dispatcher *getInstance();
+
+    QJsonArray toJson() const;
+    QList<Subscription *> subscriptions() const;
+
+    void add(Subscription *subscription);
+    void remove(Subscription *subscription);
+
+private slots:
+    void updateReadState();
+    void onDataReceived(const QByteArray &data);
+
+private:
+    Dispatcher();
+
+private:
+    QList<Subscription *> m_subscriptions;
+};
+}
+
+#endif
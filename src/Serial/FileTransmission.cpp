@@ -22,6 +22,7 @@
 
 #include <Serial/Manager.h>
 #include <Serial/FileTransmission.h>
+#include <Misc/Tracer.h>
 
 #include <QFileInfo>
 #include <QFileDialog>
@@ -34,6 +35,11 @@ using namespace Serial;
  */
 static FileTransmission *INSTANCE = Q_NULLPTR;
 
+/*
+ * Size of the read buffers used by QIODevice & QTextStream
+ */
+static const qint64 STREAM_BUFFER_SIZE = 16 * 1024;
+
 /**
  * Constructor function
  */
@@ -130,6 +136,18 @@ int FileTransmission::lineTransmissionInterval() const
     return m_timer.interval();
 }
 
+/**
+ * Returns the approximate number of bytes used by the buffers of the file stream: the
+ * read buffer of the file & the decoded text buffer of the text stream (UTF-16).
+ */
+qint64 FileTransmission::bufferSize() const
+{
+    if (!m_file.isOpen() || !m_stream)
+        return 0;
+
+    return STREAM_BUFFER_SIZE + STREAM_BUFFER_SIZE * static_cast<qint64>(sizeof(QChar));
+}
+
 /**
  * Allows the user to select a file to send to the serial port.
  */
@@ -176,6 +194,7 @@ void FileTransmission::closeFile()
 
     // Reset text stream handler
     delete m_stream;
+    m_stream = Q_NULLPTR;
 
     // Emit signals to update the UI
     emit fileChanged();
@@ -236,6 +255,8 @@ void FileTransmission::setLineTransmissionInterval(const int msec)
  */
 void FileTransmission::sendLine()
 {
+    TRACE_SCOPE("FileTransmission::sendLine", "timer");
+
     // Transmission disabled, abort
     if (!active())
         return;
@@ -66,6 +66,7 @@ public:
     QString fileName() const;
     int transmissionProgress() const;
     int lineTransmissionInterval() const;
+    qint64 bufferSize() const;
 
 public slots:
     void openFile();
@@ -0,0 +1,482 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include <QDebug>
+#include <QtAlgorithms>
+
+#include <Serial/Manager.h>
+#include <Serial/LoopbackTester.h>
+#include <Misc/LatencyMonitor.h>
+
+using namespace Serial;
+
+/**
+ * Size of the chunks written to the serial port
+ */
+static const int CHUNK_SIZE = 4096;
+
+/**
+ * Stop writing data while the serial port write queue is larger than this size
+ */
+static const qint64 MAX_WRITE_QUEUE = 16 * 1024;
+
+/**
+ * Maximum number of bytes written but not received back yet
+ */
+static const qint64 MAX_IN_FLIGHT = 256 * 1024;
+
+/**
+ * Size of the transmitted data history (must be a power of two)
+ */
+static const qint64 HISTORY_SIZE = 4 * 1024 * 1024;
+
+/**
+ * Maximum distance (in bytes) searched around the expected position after a slip
+ */
+static const qint64 SEARCH_WINDOW = 4096;
+
+/**
+ * Number of bytes that must match to resynchronize the stream after a slip
+ */
+static const int SYNC_LENGTH = 16;
+
+/**
+ * A 64-bit word with this number of wrong bits (or more) is considered misaligned,
+ * misaligned pseudo-random data has ~32 wrong bits per word.
+ */
+static const int SLIP_THRESHOLD = 16;
+
+/**
+ * Maximum number of wrong bits accepted in @c SYNC_LENGTH bytes to resynchronize
+ */
+static const int SYNC_THRESHOLD = 4;
+
+/**
+ * Consider in-flight data lost if nothing is received during this time (ns)
+ */
+static const qint64 STALL_TIMEOUT = 1000ll * 1000 * 1000;
+
+/**
+ * Returns the 64-bit word stored at the given (possibly unaligned) @a data pointer
+ */
+static inline quint64 LoadWord(const quint8 *data)
+{
+    quint64 word;
+    memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+/**
+ * Constructor function
+ */
+LoopbackTester::LoopbackTester(const PatternGenerator::Pattern pattern, QObject *parent)
+    : QObject(parent)
+    , m_generator(pattern)
+    , m_running(false)
+    , m_draining(false)
+    , m_history(static_cast<int>(HISTORY_SIZE), '\0')
+    , m_txOffset(0)
+    , m_expected(0)
+    , m_rxBytes(0)
+    , m_bitErrors(0)
+    , m_comparedBytes(0)
+    , m_lostBytes(0)
+    , m_duplicatedBytes(0)
+    , m_unmatchedBytes(0)
+    , m_resyncs(0)
+    , m_startTime(0)
+    , m_lastRxTime(0)
+    , m_stopTime(0)
+{
+    // Configure timers
+    m_stopTimer.setSingleShot(true);
+    m_drainTimer.setSingleShot(true);
+    connect(&m_txTimer, &QTimer::timeout, this, &LoopbackTester::transmit);
+    connect(&m_logTimer, &QTimer::timeout, this, &LoopbackTester::logProgress);
+    connect(&m_logTimer, &QTimer::timeout, this, &LoopbackTester::checkStall);
+    connect(&m_stopTimer, &QTimer::timeout, this, &LoopbackTester::stop);
+    connect(&m_drainTimer, &QTimer::timeout, this, &LoopbackTester::finish);
+}
+
+/**
+ * Returns @c true if data was received & no errors were detected
+ */
+bool LoopbackTester::passed() const
+{
+    return m_comparedBytes > 0 && m_bitErrors == 0 && m_lostBytes == 0
+        && m_duplicatedBytes == 0 && m_unmatchedBytes == 0;
+}
+
+/**
+ * Returns the results of the test as a JSON object
+ */
+QJsonObject LoopbackTester::toJson() const
+{
+    // Get duration of the test
+    const auto end = m_stopTime > 0 ? m_stopTime : Misc::LatencyMonitor::timestamp();
+    const double seconds = qMax<qint64>(1, end - m_startTime) * 1e-9;
+
+    // Get bit error rate
+    double ber = 0;
+    if (m_comparedBytes > 0)
+        ber = static_cast<double>(m_bitErrors) / (m_comparedBytes * 8.0);
+
+    // Get latency distribution (in microseconds)
+    QJsonObject latency;
+    latency.insert("samples", static_cast<qint64>(m_latency.count()));
+    latency.insert("p50", m_latency.percentile(0.50) / 1000.0);
+    latency.insert("p90", m_latency.percentile(0.90) / 1000.0);
+    latency.insert("p99", m_latency.percentile(0.99) / 1000.0);
+    latency.insert("max", m_latency.max() / 1000.0);
+
+    // Create result object
+    QJsonObject result;
+    auto manager = Manager::getInstance();
+    result.insert("pattern", m_generator.patternName());
+    result.insert("port", manager->portName());
+    result.insert("baudRate", manager->baudRate());
+    result.insert("seconds", seconds);
+    result.insert("txBytes", m_txOffset);
+    result.insert("rxBytes", m_rxBytes);
+    result.insert("comparedBytes", m_comparedBytes);
+    result.insert("bitErrors", m_bitErrors);
+    result.insert("bitErrorRate", ber);
+    result.insert("lostBytes", m_lostBytes);
+    result.insert("duplicatedBytes", m_duplicatedBytes);
+    result.insert("unmatchedBytes", m_unmatchedBytes);
+    result.insert("resyncs", m_resyncs);
+    result.insert("txBytesPerSecond", m_txOffset / seconds);
+    result.insert("rxBytesPerSecond", m_rxBytes / seconds);
+    result.insert("latencyUs", latency);
+    result.insert("passed", passed());
+    return result;
+}
+
+/**
+ * Starts transmitting the test pattern, the test is stopped automatically after the
+ * given number of @a seconds (0 = run until @c stop() is called).
+ */
+void LoopbackTester::start(const int seconds)
+{
+    // Serial port not open
+    auto manager = Manager::getInstance();
+    if (!manager->connected())
+    {
+        qWarning() << "Loopback test: serial port not open";
+        emit finished();
+        return;
+    }
+
+    // Reset state
+    m_generator.reset();
+    m_startTime = Misc::LatencyMonitor::timestamp();
+    m_lastRxTime = m_startTime;
+    m_running = true;
+
+    // Receive data & transmit more data as soon as the write queue is drained
+    connect(manager, &Manager::dataReceived, this, &LoopbackTester::onDataReceived);
+    connect(manager->port(), &QIODevice::bytesWritten, this, &LoopbackTester::transmit);
+
+    // Start timers
+    m_txTimer.start(10);
+    m_logTimer.start(1000);
+    if (seconds > 0)
+        m_stopTimer.start(seconds * 1000);
+
+    // Log test information
+    qDebug() << "Loopback test started:" << qPrintable(m_generator.patternName()) << "@"
+             << manager->baudRate() << "baud";
+
+    transmit();
+}
+
+/**
+ * Stops transmitting data & waits until the data in flight is received (or until the
+ * time needed to transmit the pending data at the current baud rate has elapsed)
+ */
+void LoopbackTester::stop()
+{
+    if (!m_running)
+        return;
+
+    m_running = false;
+    m_draining = true;
+    m_txTimer.stop();
+    m_stopTimer.stop();
+
+    // Estimate time needed to transmit the data in the write queue (10 bits per byte)
+    qint64 timeout = 1000;
+    auto manager = Manager::getInstance();
+    if (manager->port() && manager->baudRate() > 0)
+        timeout += manager->port()->bytesToWrite() * 10 * 1000 / manager->baudRate();
+
+    // Finish the test now or when the data in flight arrives
+    if (m_expected >= m_txOffset)
+        finish();
+    else
+        m_drainTimer.start(static_cast<int>(qMin<qint64>(timeout, 60 * 1000)));
+}
+
+/**
+ * Writes chunks of the test pattern to the serial port, as long as the serial port
+ * write queue & the amount of data in flight are below their limits
+ */
+void LoopbackTester::transmit()
+{
+    auto manager = Manager::getInstance();
+    auto port = manager->port();
+
+    while (m_running && manager->connected() && port->bytesToWrite() < MAX_WRITE_QUEUE
+           && m_txOffset - m_expected < MAX_IN_FLIGHT)
+    {
+        // Generate data & store it in the history ring
+        auto data = m_generator.next(CHUNK_SIZE);
+        const auto index = m_txOffset & (HISTORY_SIZE - 1);
+        const auto first = qMin<qint64>(CHUNK_SIZE, HISTORY_SIZE - index);
+        memcpy(m_history.data() + index, data.constData(), first);
+        memcpy(m_history.data(), data.constData() + first, CHUNK_SIZE - first);
+
+        // Write data to the serial port
+        if (manager->writeData(data) != CHUNK_SIZE)
+        {
+            qWarning() << "Loopback test: write error";
+            stop();
+            return;
+        }
+
+        // Register the time at which the chunk was written
+        m_txOffset += CHUNK_SIZE;
+        m_chunks.enqueue(qMakePair(m_txOffset, Misc::LatencyMonitor::timestamp()));
+    }
+}
+
+/**
+ * Writes the current state of the test to the log
+ */
+void LoopbackTester::logProgress()
+{
+    auto result = toJson();
+    qDebug() << "Loopback test:" << result.value("rxBytesPerSecond").toDouble()
+             << "bytes/s, BER" << result.value("bitErrorRate").toDouble() << "lost"
+             << m_lostBytes << "duplicated" << m_duplicatedBytes;
+}
+
+/**
+ * Considers the data in flight as lost if nothing has been received for a while
+ * (e.g. the loopback plug was removed), so that the transmission can continue.
+ */
+void LoopbackTester::checkStall()
+{
+    const auto now = Misc::LatencyMonitor::timestamp();
+    if (m_txOffset > m_expected && now - m_lastRxTime > STALL_TIMEOUT)
+    {
+        m_lostBytes += m_txOffset - m_expected;
+        m_expected = m_txOffset;
+        m_lastRxTime = now;
+        m_pending.clear();
+        m_chunks.clear();
+    }
+}
+
+/**
+ * Registers the received @a data & compares it with the transmitted data
+ */
+void LoopbackTester::onDataReceived(const QByteArray &data)
+{
+    if (!m_running && !m_draining)
+        return;
+
+    const auto timestamp = Manager::getInstance()->readTimestamp();
+    m_rxBytes += data.size();
+    m_lastRxTime = timestamp;
+    m_pending.append(data);
+    verify(timestamp);
+
+    // All the data in flight has been received
+    if (m_draining && m_expected >= m_txOffset)
+        finish();
+}
+
+/**
+ * Stops the test & notifies the caller, data that did not arrive is counted as lost
+ */
+void LoopbackTester::finish()
+{
+    if (!m_draining)
+        return;
+
+    m_draining = false;
+    m_drainTimer.stop();
+    m_logTimer.stop();
+
+    // Compare the last incomplete word byte by byte
+    int i = 0;
+    const auto rx = reinterpret_cast<const quint8 *>(m_pending.constData());
+    for (; i < m_pending.size() && m_expected < m_txOffset; ++i)
+    {
+        const auto expected = m_history.at(m_expected & (HISTORY_SIZE - 1));
+        m_bitErrors += qPopulationCount(static_cast<quint8>(rx[i] ^ expected));
+        ++m_comparedBytes;
+        ++m_expected;
+    }
+
+    // Register data that was never sent & data that did not arrive
+    m_unmatchedBytes += m_pending.size() - i;
+    m_lostBytes += m_txOffset - m_expected;
+    m_stopTime = Misc::LatencyMonitor::timestamp();
+    m_pending.clear();
+
+    // Disconnect from serial port
+    auto manager = Manager::getInstance();
+    disconnect(manager, &Manager::dataReceived, this, &LoopbackTester::onDataReceived);
+    if (manager->port())
+        manager->port()->disconnect(this);
+
+    emit finished();
+}
+
+/**
+ * Compares the pending received data with the transmitted data, one 64-bit word at a
+ * time. See the class documentation for the resynchronization algorithm.
+ */
+void LoopbackTester::verify(const qint64 timestamp)
+{
+    int pos = 0;
+    const auto rx = reinterpret_cast<const quint8 *>(m_pending.constData());
+    while (m_pending.size() - pos >= 8 && m_expected + 8 <= m_txOffset)
+    {
+        // Compare word with the expected data
+        const auto diff = qPopulationCount(LoadWord(rx + pos) ^ historyWord(m_expected));
+        if (diff < SLIP_THRESHOLD)
+        {
+            m_bitErrors += diff;
+            m_comparedBytes += 8;
+            m_expected += 8;
+            pos += 8;
+            continue;
+        }
+
+        // Wait for more data to find out if this is a burst error or a slip
+        if (m_pending.size() - pos < 8 + SYNC_LENGTH)
+            break;
+
+        // Following data is still aligned, burst of bit errors
+        const auto next = m_expected + 8;
+        if (next + SYNC_LENGTH <= m_txOffset
+            && compare(rx + pos + 8, next, SYNC_LENGTH) <= SYNC_THRESHOLD)
+        {
+            m_bitErrors += diff;
+            m_comparedBytes += 8;
+            m_expected += 8;
+            pos += 8;
+            continue;
+        }
+
+        // Data slipped, search the following data around the expected position
+        const auto found = search(rx + pos + 8, next);
+        if (found >= 0)
+        {
+            if (found > next)
+                m_lostBytes += found - next;
+            else
+                m_duplicatedBytes += next - found;
+
+            ++m_resyncs;
+            m_expected = found;
+        }
+
+        // Data not found, skip it
+        else
+        {
+            m_unmatchedBytes += 8;
+            m_expected += 8;
+        }
+
+        pos += 8;
+    }
+
+    // Remove processed data
+    m_pending.remove(0, pos);
+
+    // Register the latency of the chunks that have been received completely
+    while (!m_chunks.isEmpty() && m_chunks.head().first <= m_expected)
+        m_latency.record(timestamp - m_chunks.dequeue().second);
+}
+
+/**
+ * Returns the transmitted 64-bit word that starts at the given stream @a offset
+ */
+quint64 LoopbackTester::historyWord(const qint64 offset) const
+{
+    const auto data = reinterpret_cast<const quint8 *>(m_history.constData());
+    const auto index = offset & (HISTORY_SIZE - 1);
+    if (index + 8 <= HISTORY_SIZE)
+        return LoadWord(data + index);
+
+    // Word wraps around the end of the history ring
+    quint8 word[8];
+    for (int i = 0; i < 8; ++i)
+        word[i] = data[(offset + i) & (HISTORY_SIZE - 1)];
+
+    return LoadWord(word);
+}
+
+/**
+ * Returns the number of bits that differ between the given @a data & the transmitted
+ * data that starts at @a offset (@a length must be a multiple of 8).
+ */
+int LoopbackTester::compare(const quint8 *data, const qint64 offset, const int length) const
+{
+    int diff = 0;
+    for (int i = 0; i < length; i += 8)
+        diff += qPopulationCount(LoadWord(data + i) ^ historyWord(offset + i));
+
+    return diff;
+}
+
+/**
+ * Searches @c SYNC_LENGTH bytes of received @a data in the transmitted data, starting at
+ * the given @a offset & moving away from it in both directions.
+ *
+ * @returns the stream offset where the data was found or -1 if it was not found
+ */
+qint64 LoopbackTester::search(const quint8 *data, const qint64 offset) const
+{
+    const auto oldest = qMax<qint64>(0, m_txOffset - HISTORY_SIZE);
+    for (qint64 distance = 1; distance <= SEARCH_WINDOW; ++distance)
+    {
+        // Bytes lost, data found later in the stream
+        const auto later = offset + distance;
+        if (later + SYNC_LENGTH <= m_txOffset
+            && compare(data, later, SYNC_LENGTH) <= SYNC_THRESHOLD)
+            return later;
+
+        // Bytes duplicated, data found earlier in the stream
+        const auto earlier = offset - distance;
+        if (earlier >= oldest && compare(data, earlier, SYNC_LENGTH) <= SYNC_THRESHOLD)
+            return earlier;
+    }
+
+    return -1;
+}
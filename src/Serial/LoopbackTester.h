@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SERIAL_LOOPBACK_TESTER_H
+#define SERIAL_LOOPBACK_TESTER_H
+
+#include <QPair>
+#include <QQueue>
+#include <QTimer>
+#include <QObject>
+#include <QJsonObject>
+
+#include <Misc/Histogram.h>
+#include <Serial/PatternGenerator.h>
+
+namespace Serial
+{
+/**
+ * Transmits a test pattern (PRBS-7/15/31 or counter, see @c PatternGenerator) through
+ * the current serial port & verifies the data received back from a loopback plug (or
+ * from a peer that echoes received data).
+ *
+ * Every transmitted byte is kept in a history ring. Received data is compared against
+ * the history 64 bits at a time (XOR + popcount), so that verification keeps up with
+ * the fastest serial adapters. When a word does not match the expected data:
+ *
+ * - If the following bytes are still aligned, the mismatch is a burst of bit errors.
+ * - Otherwise the stream slipped: the following bytes are searched in the history
+ *   around the expected position to count lost (found later) or duplicated (found
+ *   earlier) bytes & the comparison continues from the position found.
+ *
+ * The tester reports bit error rate, lost/duplicated/unmatched bytes, sustained
+ * throughput in both directions & the latency between writing a chunk & receiving its
+ * last byte.
+ */
+class LoopbackTester : public QObject
+{
+    Q_OBJECT
+
+signals:
+    void finished();
+
+public:
+    LoopbackTester(const PatternGenerator::Pattern pattern, QObject *parent = nullptr);
+
+    bool passed() const;
+    QJsonObject toJson() const;
+
+public slots:
+    void start(const int seconds);
+    void stop();
+
+private slots:
+    void transmit();
+    void logProgress();
+    void checkStall();
+    void onDataReceived(const QByteArray &data);
+
+private:
+    void finish();
+    void verify(const qint64 timestamp);
+    quint64 historyWord(const qint64 offset) const;
+    int compare(const quint8 *data, const qint64 offset, const int length) const;
+    qint64 search(const quint8 *data, const qint64 offset) const;
+
+private:
+    PatternGenerator m_generator;
+
+    bool m_running;
+    bool m_draining;
+    QTimer m_txTimer;
+    QTimer m_logTimer;
+    QTimer m_stopTimer;
+    QTimer m_drainTimer;
+
+    QByteArray m_history;
+    QByteArray m_pending;
+    qint64 m_txOffset;
+    qint64 m_expected;
+    QQueue<QPair<qint64, qint64>> m_chunks;
+
+    qint64 m_rxBytes;
+    qint64 m_bitErrors;
+    qint64 m_comparedBytes;
+    qint64 m_lostBytes;
+    qint64 m_duplicatedBytes;
+    qint64 m_unmatchedBytes;
+    qint64 m_resyncs;
+
+    qint64 m_startTime;
+    qint64 m_lastRxTime;
+    qint64 m_stopTime;
+    Misc::Histogram m_latency;
+};
+}
+
+#endif
@@ -20,8 +20,14 @@
  * THE SOFTWARE.
  */
 
+#include <QtConcurrent>
+
 #include <Serial/Manager.h>
+#include <Serial/SerialPortBackend.h>
+#include <Misc/Tracer.h>
 #include <Misc/Utilities.h>
+#include <Misc/LatencyMonitor.h>
+#include <Misc/StartupProfiler.h>
 
 using namespace Serial;
 
@@ -35,6 +41,10 @@ static Manager *INSTANCE = nullptr;
  */
 Manager::Manager()
     : m_port(nullptr)
+    , m_readLimit(-1)
+    , m_readTimestamp(0)
+    , m_scanTimestamp(0)
+    , m_pendingPortIndex(-1)
     , m_portIndex(0)
 {
     // Init serial port configuration variables
@@ -45,9 +55,13 @@ Manager::Manager()
     setBaudRateIndex(baudRateList().indexOf("9600"));
     setFlowControl(flowControlList().indexOf(tr("None")));
 
-    // Refresh serial devices @ 1 Hz
+    // Refresh serial devices @ 1 Hz, ports are scanned in a worker thread (scanning
+    // can take a long time on some systems), the first scan is started now
+    connect(&m_scanWatcher, &QFutureWatcher<QList<QSerialPortInfo>>::finished, this,
+            &Manager::onPortScanFinished);
     connect(&m_refreshTimer, &QTimer::timeout, this, &Manager::refreshSerialDevices);
     m_refreshTimer.start(1000);
+    refreshSerialDevices();
 
     // Log class init
     qDebug() << "Class initialized";
@@ -75,9 +89,9 @@ Manager *Manager::getInstance()
 }
 
 /**
- * Returns the pointer to the current serial port handler
+ * Returns the pointer to the current device backend
  */
-QSerialPort *Manager::port() const
+Backend *Manager::port() const
 {
     return m_port;
 }
@@ -99,7 +113,7 @@ bool Manager::connected() const
 QString Manager::portName() const
 {
     if (port())
-        return port()->portName();
+        return port()->name();
 
     return tr("No Device");
 }
@@ -113,6 +127,32 @@ bool Manager::configurationOk() const
     return portIndex() > 0;
 }
 
+/**
+ * Returns the time at which the last data block was read from the serial device, in
+ * the time base of @c Misc::LatencyMonitor::timestamp().
+ */
+qint64 Manager::readTimestamp() const
+{
+    return m_readTimestamp;
+}
+
+/**
+ * Returns @c true if reading from the device is paused (see @c setReadLimit())
+ */
+bool Manager::readPaused() const
+{
+    return m_readLimit == 0;
+}
+
+/**
+ * Returns the maximum number of bytes read from the device at once, a negative value
+ * means that there is no limit (see @c setReadLimit())
+ */
+qint64 Manager::readLimit() const
+{
+    return m_readLimit;
+}
+
 /**
  * Returns the index of the current serial device selected by the program.
  */
@@ -315,7 +355,7 @@ void Manager::connectDevice()
     // Ignore the first item of the list (Select Port)
     auto ports = validPorts();
     auto portId = portIndex() - 1;
-    if (portId >= 0 && portId < validPorts().count())
+    if (portId >= 0 && portId < ports.count())
     {
         // Update port index variable & disconnect from current serial port
         disconnectDevice();
@@ -323,28 +363,7 @@ void Manager::connectDevice()
         emit portIndexChanged();
 
         // Create new serial port handler
-        m_port = new QSerialPort(ports.at(portId));
-
-        // Configure serial port
-        port()->setParity(parity());
-        port()->setBaudRate(baudRate());
-        port()->setDataBits(dataBits());
-        port()->setStopBits(stopBits());
-        port()->setFlowControl(flowControl());
-
-        // Connect signals/slots
-        connect(port(), &QIODevice::readyRead, this, &Manager::onDataReceived);
-        connect(port(), SIGNAL(errorOccurred(QSerialPort::SerialPortError)), this,
-                SLOT(handleError(QSerialPort::SerialPortError)));
-
-        // Try to open the serial port device
-        if (port()->open(QIODevice::ReadWrite))
-            qDebug() << "Connected to" << portName();
-        else
-            qWarning() << "Serial port connection error";
-
-        // Change serial port connection status
-        emit connectedChanged();
+        openPort(new SerialPortBackend(ports.at(portId)));
     }
 
     // Disconnect serial port
@@ -352,6 +371,62 @@ void Manager::connectDevice()
         disconnectDevice();
 }
 
+/**
+ * Tries to open the serial device with the given @a name (e.g. "COM3", "ttyUSB0" or
+ * "/dev/pts/4") with the current configuration. Unlike @c connectDevice(), this function
+ * also allows opening devices that are not listed by @c QSerialPortInfo, such as
+ * pseudo-terminals & remote serial ports (see @c Backend::create()).
+ */
+void Manager::connectToPort(const QString &name)
+{
+    // Disconnect from current serial port
+    disconnectDevice();
+
+    // Select the port in the UI (if listed)
+    m_portIndex = 0;
+    auto ports = validPorts();
+    for (int i = 0; i < ports.count(); ++i)
+    {
+        if (ports.at(i).portName() == name || ports.at(i).systemLocation() == name)
+        {
+            m_portIndex = i + 1;
+            break;
+        }
+    }
+
+    // Create new device backend
+    emit portIndexChanged();
+    openPort(Backend::create(name));
+}
+
+/**
+ * Limits the number of bytes read from the device at once (a negative @a limit removes
+ * the limit & zero pauses reading). Data that is not read is kept by the device backend
+ * (which, for serial ports, leaves it in the driver once the bounded read buffer fills
+ * up, so that flow control can stop the remote device). This function is used by
+ * @c Dispatcher to slow down the device reader to the pace of consumers that cannot
+ * lose data.
+ *
+ * The read buffer of the device is only bounded while there is a limit, otherwise the
+ * backend buffers as much data as it receives.
+ */
+void Manager::setReadLimit(const qint64 limit)
+{
+    if (m_readLimit == limit)
+        return;
+
+    // Bound the read buffer while a limit is set
+    const bool bounded = limit >= 0;
+    if (port() && bounded != (m_readLimit >= 0))
+        port()->setBoundedReadBuffer(bounded);
+
+    m_readLimit = limit;
+
+    // Read the data received while paused
+    if (limit != 0 && port() && port()->bytesAvailable() > 0)
+        QTimer::singleShot(0, this, &Manager::onDataReceived);
+}
+
 /**
  * Disconnects from the current serial device and clears temp. data
  */
@@ -364,8 +439,7 @@ void Manager::disconnectDevice()
         auto name = portName();
 
         // Disconnect signals/slots
-        port()->disconnect(this, SLOT(onDataReceived()));
-        port()->disconnect(this, SLOT(handleError(QSerialPort::SerialPortError)));
+        port()->disconnect(this);
 
         // Close & delete serial port handler
         port()->close();
@@ -425,6 +499,10 @@ void Manager::setBaudRate(const qint32 rate)
  */
 void Manager::setPortIndex(const quint8 portIndex)
 {
+    // Ports not scanned yet, apply the index when the first scan finishes
+    if (m_scanTimestamp > 0)
+        m_pendingPortIndex = portIndex;
+
     auto portId = portIndex - 1;
     if (portId >= 0 && portId < validPorts().count())
         m_portIndex = portIndex;
@@ -629,24 +707,118 @@ void Manager::setFlowControl(const quint8 flowControlIndex)
  */
 void Manager::onDataReceived()
 {
+    TRACE_SCOPE("Manager::onDataReceived", "serial");
+
     // Verify that device is still valid
     if (!port())
+    {
         disconnectDevice();
+        return;
+    }
+
+    // Data is read when the consumers catch up
+    if (readPaused() || port()->bytesAvailable() <= 0)
+        return;
 
-    // Read data all incoming data from serial port
-    auto data = port()->readAll();
+    // Read data all incoming data from serial port (up to the read limit)
+    m_readTimestamp = Misc::LatencyMonitor::timestamp();
+    QByteArray data;
+    {
+        TRACE_SCOPE("Backend::read", "serial");
+        auto size = port()->bytesAvailable();
+        if (m_readLimit > 0)
+            size = qMin(size, m_readLimit);
+
+        data = port()->read(size);
+    }
 
     // Notify user interface
-    emit dataReceived(data);
-    emit rx();
+    {
+        TRACE_SCOPE("Manager::dataReceived", "signal");
+        emit dataReceived(data);
+        emit rx();
+    }
+
+    // Register time spent reading & dispatching the data
+    auto elapsed = Misc::LatencyMonitor::timestamp() - m_readTimestamp;
+    Misc::LatencyMonitor::getInstance()->record(Misc::LatencyMonitor::Stage::Read, elapsed);
+
+    // Bounded backends do not emit readyRead() again until their buffer is read
+    if (port() && !readPaused() && port()->bytesAvailable() > 0)
+        QTimer::singleShot(0, this, &Manager::onDataReceived);
+}
+
+/**
+ * Configures & opens the given device @a port, which becomes the current device
+ * backend of the class.
+ */
+void Manager::openPort(Backend *port)
+{
+    // Register serial port handler
+    Q_ASSERT(port);
+    m_port = port;
+
+    // Configure serial port
+    port->setParity(parity());
+    port->setBaudRate(baudRate());
+    port->setDataBits(dataBits());
+    port->setStopBits(stopBits());
+    port->setFlowControl(flowControl());
+    port->setBoundedReadBuffer(m_readLimit >= 0);
+
+    // Connect signals/slots
+    connect(port, &QIODevice::readyRead, this, &Manager::onDataReceived);
+    connect(port, &Backend::errorOccurred, this, &Manager::handleError);
+
+    // Try to open the serial port device
+    if (port->open(QIODevice::ReadWrite))
+        qDebug() << "Connected to" << portName();
+    else
+        qWarning() << "Serial port connection error" << port->errorString();
+
+    // Change serial port connection status
+    emit portChanged();
+    emit connectedChanged();
 }
 
 /**
- * Scans for new serial ports available & generates a QStringList with current
- * serial ports.
+ * Starts scanning the available serial ports in a worker thread (unless the previous
+ * scan is still running).
  */
 void Manager::refreshSerialDevices()
 {
+    TRACE_SCOPE("Manager::refreshSerialDevices", "timer");
+
+    if (!m_scanWatcher.isRunning())
+    {
+        if (m_scanTimestamp == 0)
+            m_scanTimestamp = Misc::LatencyMonitor::timestamp();
+
+        m_scanWatcher.setFuture(QtConcurrent::run(&Manager::scanPorts));
+    }
+}
+
+/**
+ * Updates the list of valid serial ports with the results of the last scan &
+ * generates a QStringList with current serial ports.
+ */
+void Manager::onPortScanFinished()
+{
+    TRACE_SCOPE("Manager::onPortScanFinished", "serial");
+
+    // Update valid port list
+    m_validPorts = m_scanWatcher.result();
+
+    // Register the duration of the first scan
+    bool firstScan = false;
+    if (m_scanTimestamp > 0)
+    {
+        Misc::StartupProfiler::getInstance()->record("First port scan", m_scanTimestamp,
+                                                     Misc::LatencyMonitor::timestamp());
+        m_scanTimestamp = -1;
+        firstScan = true;
+    }
+
     // Create device list, starting with dummy header
     // (for a more friendly UI when no devices are attached)
     QStringList ports;
@@ -681,7 +853,7 @@ void Manager::refreshSerialDevices()
         // Update current port index
         if (port())
         {
-            auto name = port()->portName();
+            auto name = port()->name();
             for (int i = 0; i < validPortList.count(); ++i)
             {
                 auto info = validPortList.at(i);
@@ -696,28 +868,37 @@ void Manager::refreshSerialDevices()
         // Update UI
         emit availablePortsChanged();
     }
+
+    // Restore the port selected before the first scan finished
+    if (firstScan && m_pendingPortIndex > 0 && portIndex() == 0)
+        setPortIndex(static_cast<quint8>(m_pendingPortIndex));
 }
 
 /**
- * @brief Serial::handleError
- * @param error
+ * Closes the current device & notifies the user when the backend reports a fatal
+ * @a error
  */
-void Manager::handleError(QSerialPort::SerialPortError error)
+void Manager::handleError(const QString &error)
 {
-    qDebug() << "Serial port error" << port()->error();
+    qDebug() << "Serial port error" << error;
 
-    if (error != QSerialPort::NoError)
-    {
-        auto errorStr = port()->errorString();
-        Manager::getInstance()->disconnectDevice();
-        Misc::Utilities::showMessageBox(tr("Critical serial port error"), errorStr);
-    }
+    disconnectDevice();
+    Misc::Utilities::showMessageBox(tr("Critical serial port error"), error);
 }
 
 /**
- * Returns a list with all the valid serial port objects
+ * Returns a list with all the valid serial port objects found by the last scan
  */
 QList<QSerialPortInfo> Manager::validPorts() const
+{
+    return m_validPorts;
+}
+
+/**
+ * Returns a list with all the valid serial port objects, this function is called from a
+ * worker thread.
+ */
+QList<QSerialPortInfo> Manager::scanPorts()
 {
     // Search for available ports and add them to the lsit
     QList<QSerialPortInfo> ports;
@@ -28,6 +28,9 @@
 #include <QByteArray>
 #include <QStringList>
 #include <QtSerialPort>
+#include <QFutureWatcher>
+
+#include <Serial/Backend.h>
 
 namespace Serial
 {
@@ -116,8 +119,11 @@ public:
 
     bool connected() const;
     QString portName() const;
-    QSerialPort *port() const;
+    Backend *port() const;
     bool configurationOk() const;
+    qint64 readTimestamp() const;
+    bool readPaused() const;
+    qint64 readLimit() const;
 
     quint8 portIndex() const;
     quint8 parityIndex() const;
@@ -145,6 +151,8 @@ public:
 public slots:
     void connectDevice();
     void disconnectDevice();
+    void connectToPort(const QString &name);
+    void setReadLimit(const qint64 limit);
     void toggleConnection();
     void setBaudRate(const qint32 rate);
     void setBaudRateIndex(const int index);
@@ -157,17 +165,26 @@ public slots:
 private slots:
     void onDataReceived();
     void refreshSerialDevices();
-    void handleError(QSerialPort::SerialPortError error);
+    void onPortScanFinished();
+    void handleError(const QString &error);
 
 private:
     Manager();
     ~Manager();
+    void openPort(Backend *port);
     QList<QSerialPortInfo> validPorts() const;
+    static QList<QSerialPortInfo> scanPorts();
 
 private:
-    QSerialPort *m_port;
+    Backend *m_port;
+    qint64 m_readLimit;
+    qint64 m_readTimestamp;
 
     QTimer m_refreshTimer;
+    qint64 m_scanTimestamp;
+    int m_pendingPortIndex;
+    QList<QSerialPortInfo> m_validPorts;
+    QFutureWatcher<QList<QSerialPortInfo>> m_scanWatcher;
 
     qint32 m_baudRate;
     QSettings m_settings;
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Serial/PatternGenerator.h>
+
+using namespace Serial;
+
+/**
+ * Constructor function
+ */
+PatternGenerator::PatternGenerator(const Pattern pattern)
+    : m_pattern(pattern)
+    , m_order(7)
+    , m_tap(6)
+    , m_state(0)
+    , m_bits(0)
+    , m_bitCount(0)
+    , m_counter(0)
+{
+    switch (pattern)
+    {
+        case Pattern::Prbs7:
+            m_order = 7;
+            m_tap = 6;
+            break;
+        case Pattern::Prbs15:
+            m_order = 15;
+            m_tap = 14;
+            break;
+        case Pattern::Prbs31:
+            m_order = 31;
+            m_tap = 28;
+            break;
+        case Pattern::Counter:
+            break;
+    }
+
+    reset();
+}
+
+/**
+ * Returns the pattern generated by this object
+ */
+PatternGenerator::Pattern PatternGenerator::pattern() const
+{
+    return m_pattern;
+}
+
+/**
+ * Returns the name of the pattern generated by this object
+ */
+QString PatternGenerator::patternName() const
+{
+    switch (m_pattern)
+    {
+        case Pattern::Prbs7:
+            return "prbs7";
+        case Pattern::Prbs15:
+            return "prbs15";
+        case Pattern::Prbs31:
+            return "prbs31";
+        case Pattern::Counter:
+            return "counter";
+    }
+
+    return QString();
+}
+
+/**
+ * Obtains the @a pattern that corresponds to the given @a name (prbs7, prbs15, prbs31
+ * or counter).
+ *
+ * @returns @c false if the name is not valid
+ */
+bool PatternGenerator::patternFromName(const QString &name, Pattern &pattern)
+{
+    const auto lower = name.toLower();
+    if (lower == "prbs7")
+        pattern = Pattern::Prbs7;
+    else if (lower == "prbs15")
+        pattern = Pattern::Prbs15;
+    else if (lower == "prbs31")
+        pattern = Pattern::Prbs31;
+    else if (lower == "counter")
+        pattern = Pattern::Counter;
+    else
+        return false;
+
+    return true;
+}
+
+/**
+ * Restarts the sequence (the LFSR is seeded with all ones)
+ */
+void PatternGenerator::reset()
+{
+    m_bits = 0;
+    m_bitCount = 0;
+    m_counter = 0;
+    m_state = (Q_UINT64_C(1) << m_order) - 1;
+}
+
+/**
+ * Returns the next @a size bytes of the pattern
+ */
+QByteArray PatternGenerator::next(const int size)
+{
+    QByteArray data(size, '\0');
+    auto bytes = reinterpret_cast<quint8 *>(data.data());
+    for (int i = 0; i < size; ++i)
+        bytes[i] = nextByte();
+
+    return data;
+}
+
+/**
+ * Returns the next byte of the pattern.
+ *
+ * The LFSR state holds the last n bits of the sequence, the oldest bit in the least
+ * significant position. For x^n + x^m + 1, b[k] = b[k - n] ^ b[k - m], so the next m
+ * bits only depend on bits that are already in the state & can be obtained with a
+ * single shift & XOR.
+ */
+quint8 PatternGenerator::nextByte()
+{
+    // Counter pattern
+    if (m_pattern == Pattern::Counter)
+        return m_counter++;
+
+    // Generate blocks of bits until we have a complete byte
+    while (m_bitCount < 8)
+    {
+        const quint64 mask = (Q_UINT64_C(1) << m_tap) - 1;
+        const quint64 block = (m_state ^ (m_state >> (m_order - m_tap))) & mask;
+
+        m_state = (m_state >> m_tap) | (block << (m_order - m_tap));
+        m_bits |= block << m_bitCount;
+        m_bitCount += m_tap;
+    }
+
+    // Return the oldest 8 bits
+    const auto byte = static_cast<quint8>(m_bits & 0xFF);
+    m_bits >>= 8;
+    m_bitCount -= 8;
+    return byte;
+}
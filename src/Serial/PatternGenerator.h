@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SERIAL_PATTERN_GENERATOR_H
+#define SERIAL_PATTERN_GENERATOR_H
+
+#include <QString>
+#include <QByteArray>
+
+namespace Serial
+{
+/**
+ * Generates the test patterns used by the loopback tester:
+ *
+ * - PRBS-7  (x^7 + x^6 + 1)
+ * - PRBS-15 (x^15 + x^14 + 1)
+ * - PRBS-31 (x^31 + x^28 + 1)
+ * - An 8-bit counter (0x00, 0x01, ... 0xFF, 0x00...)
+ *
+ * PRBS bits are packed LSB first, so that the bit stream on the wire (UARTs send the
+ * least significant bit first) is the PRBS sequence itself. Bits are generated in
+ * blocks as wide as the shortest tap of the polynomial, which keeps generation well
+ * above the maximum data rate of any serial adapter.
+ */
+class PatternGenerator
+{
+public:
+    enum class Pattern
+    {
+        Prbs7,
+        Prbs15,
+        Prbs31,
+        Counter
+    };
+
+    PatternGenerator(const Pattern pattern = Pattern::Prbs7);
+
+    Pattern pattern() const;
+    QString patternName() const;
+    static bool patternFromName(const QString &name, Pattern &pattern);
+
+    void reset();
+    QByteArray next(const int size);
+
+private:
+    quint8 nextByte();
+
+private:
+    Pattern m_pattern;
+
+    int m_order;
+    int m_tap;
+    quint64 m_state;
+    quint64 m_bits;
+    int m_bitCount;
+    quint8 m_counter;
+};
+}
+
+#endif
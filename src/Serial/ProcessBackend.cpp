@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDebug>
+
+#include <Serial/ProcessBackend.h>
+
+using namespace Serial;
+
+/**
+ * Time given to the program to start or to exit (in milliseconds)
+ */
+static const int PROCESS_TIMEOUT = 3000;
+
+/**
+ * Constructor function
+ */
+ProcessBackend::ProcessBackend(const QString &command, QObject *parent)
+    : Backend(parent)
+    , m_command(command)
+{
+    m_process.setProcessChannelMode(QProcess::SeparateChannels);
+    m_process.setReadChannel(QProcess::StandardOutput);
+
+    connect(&m_process, &QProcess::readyReadStandardOutput, this,
+            &ProcessBackend::readyRead);
+    connect(&m_process, &QProcess::readyReadStandardError, this,
+            &ProcessBackend::onStandardError);
+    connect(&m_process, &QProcess::bytesWritten, this, &ProcessBackend::bytesWritten);
+    connect(&m_process, SIGNAL(errorOccurred(QProcess::ProcessError)), this,
+            SLOT(onErrorOccurred(QProcess::ProcessError)));
+    connect(&m_process, SIGNAL(finished(int, QProcess::ExitStatus)), this,
+            SLOT(onFinished(int, QProcess::ExitStatus)));
+}
+
+/**
+ * Returns the device name (exec:command)
+ */
+QString ProcessBackend::name() const
+{
+    return "exec:" + m_command;
+}
+
+/**
+ * Starts the program
+ */
+bool ProcessBackend::open(OpenMode mode)
+{
+    // Run command with the system shell
+#ifdef Q_OS_WIN
+    m_process.start("cmd.exe", QStringList { "/c", m_command });
+#else
+    m_process.start("/bin/sh", QStringList { "-c", m_command });
+#endif
+
+    // Report startup errors
+    if (!m_process.waitForStarted(PROCESS_TIMEOUT))
+    {
+        setErrorString(m_process.errorString());
+        return false;
+    }
+
+    qDebug() << "Started process" << m_command << "with PID" << m_process.processId();
+    return Backend::open(mode | QIODevice::Unbuffered);
+}
+
+/**
+ * Closes the standard input of the program & terminates it if it does not exit
+ */
+void ProcessBackend::close()
+{
+    Backend::close();
+
+    if (m_process.state() != QProcess::NotRunning)
+    {
+        m_process.closeWriteChannel();
+        m_process.terminate();
+        if (!m_process.waitForFinished(PROCESS_TIMEOUT))
+            m_process.kill();
+    }
+}
+
+/**
+ * Returns the number of bytes written by the program to its standard output that have
+ * not been read yet
+ */
+qint64 ProcessBackend::bytesAvailable() const
+{
+    return m_process.bytesAvailable() + Backend::bytesAvailable();
+}
+
+/**
+ * Returns the number of bytes waiting to be written to the standard input of the
+ * program
+ */
+qint64 ProcessBackend::bytesToWrite() const
+{
+    return m_process.bytesToWrite();
+}
+
+/**
+ * Reads up to @a maxSize bytes from the standard output of the program
+ */
+qint64 ProcessBackend::readData(char *data, qint64 maxSize)
+{
+    return m_process.read(data, maxSize);
+}
+
+/**
+ * Writes @a maxSize bytes to the standard input of the program
+ */
+qint64 ProcessBackend::writeData(const char *data, qint64 maxSize)
+{
+    return m_process.write(data, maxSize);
+}
+
+/**
+ * Writes the standard error of the program to the application log
+ */
+void ProcessBackend::onStandardError()
+{
+    const auto lines = m_process.readAllStandardError().split('\n');
+    foreach (auto line, lines)
+    {
+        if (!line.trimmed().isEmpty())
+            qWarning() << m_command << ":" << line.trimmed().constData();
+    }
+}
+
+/**
+ * Reports errors that occur after the program was started
+ */
+void ProcessBackend::onErrorOccurred(QProcess::ProcessError error)
+{
+    if (isOpen() && error != QProcess::Crashed)
+        emit errorOccurred(m_process.errorString());
+}
+
+/**
+ * Reports the end of the output of the program & the program exit as an error, so that
+ * the device is closed
+ */
+void ProcessBackend::onFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    if (!isOpen())
+        return;
+
+    emit readChannelFinished();
+    if (exitStatus == QProcess::CrashExit)
+        emit errorOccurred(tr("%1 crashed").arg(m_command));
+    else
+        emit errorOccurred(tr("%1 exited with code %2").arg(m_command).arg(exitCode));
+}
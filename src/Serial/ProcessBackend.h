@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SERIAL_PROCESS_BACKEND_H
+#define SERIAL_PROCESS_BACKEND_H
+
+#include <QProcess>
+#include <Serial/Backend.h>
+
+namespace Serial
+{
+/**
+ * Runs a local program (e.g. a firmware simulator or a protocol emulator) as if it was
+ * a serial device: data written by the program to its standard output is received &
+ * transmitted data is written to its standard input. Device names have the form
+ * @c exec:command, the command is run by the system shell (@c /bin/sh or @c cmd.exe).
+ *
+ * The standard error of the program is written to the application log & the device is
+ * closed when the program exits. Use @c PtyProcessBackend for programs that need a
+ * terminal.
+ */
+class ProcessBackend : public Backend
+{
+    Q_OBJECT
+
+public:
+    ProcessBackend(const QString &command, QObject *parent = nullptr);
+
+    QString name() const override;
+
+    bool open(OpenMode mode) override;
+    void close() override;
+
+    qint64 bytesAvailable() const override;
+    qint64 bytesToWrite() const override;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private slots:
+    void onStandardError();
+    void onErrorOccurred(QProcess::ProcessError error);
+    void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private:
+    QString m_command;
+    QProcess m_process;
+};
+}
+
+#endif
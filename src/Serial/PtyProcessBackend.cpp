@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/wait.h>
+#include <sys/ioctl.h>
+
+#include <QDebug>
+#include <QThread>
+#include <QSocketNotifier>
+
+#include <Serial/PtyProcessBackend.h>
+
+using namespace Serial;
+
+/**
+ * Size of each read from the pseudo-terminal
+ */
+static const int READ_CHUNK_SIZE = 64 * 1024;
+
+/**
+ * Time given to the program to exit after @c SIGHUP (in milliseconds)
+ */
+static const int EXIT_TIMEOUT = 1000;
+
+/**
+ * Constructor function
+ */
+PtyProcessBackend::PtyProcessBackend(const QString &command, QObject *parent)
+    : Backend(parent)
+    , m_command(command)
+    , m_master(-1)
+    , m_pid(-1)
+    , m_readNotifier(nullptr)
+    , m_writeNotifier(nullptr)
+{
+}
+
+/**
+ * Destructor function, terminates the program
+ */
+PtyProcessBackend::~PtyProcessBackend()
+{
+    stopProcess();
+}
+
+/**
+ * Returns the device name (pty:command)
+ */
+QString PtyProcessBackend::name() const
+{
+    return "pty:" + m_command;
+}
+
+/**
+ * Creates the pseudo-terminal & starts the program
+ */
+bool PtyProcessBackend::open(OpenMode mode)
+{
+    // Create pseudo-terminal
+    m_master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (m_master < 0 || grantpt(m_master) != 0 || unlockpt(m_master) != 0
+        || !ptsname(m_master))
+    {
+        setErrorString(QString::fromLocal8Bit(strerror(errno)));
+        stopProcess();
+        return false;
+    }
+
+    // Copy slave name & command before forking (no allocations in the child)
+    const QByteArray slave(ptsname(m_master));
+    const auto command = m_command.toLocal8Bit();
+
+    // Start program
+    m_pid = fork();
+    if (m_pid < 0)
+    {
+        setErrorString(QString::fromLocal8Bit(strerror(errno)));
+        stopProcess();
+        return false;
+    }
+
+    // Child process: attach to the slave side & run the command
+    if (m_pid == 0)
+    {
+        setsid();
+        auto fd = ::open(slave.constData(), O_RDWR);
+        if (fd < 0)
+            _exit(127);
+
+        ioctl(fd, TIOCSCTTY, 0);
+
+        struct termios tio;
+        if (tcgetattr(fd, &tio) == 0)
+        {
+            cfmakeraw(&tio);
+            tcsetattr(fd, TCSANOW, &tio);
+        }
+
+        dup2(fd, STDIN_FILENO);
+        dup2(fd, STDOUT_FILENO);
+        dup2(fd, STDERR_FILENO);
+        if (fd > STDERR_FILENO)
+            ::close(fd);
+
+        execl("/bin/sh", "sh", "-c", command.constData(), static_cast<char *>(nullptr));
+        _exit(127);
+    }
+
+    // Use non-blocking I/O on the master side
+    fcntl(m_master, F_SETFL, fcntl(m_master, F_GETFL) | O_NONBLOCK);
+    fcntl(m_master, F_SETFD, FD_CLOEXEC);
+
+    // Watch the master side
+    m_readNotifier = new QSocketNotifier(m_master, QSocketNotifier::Read, this);
+    m_writeNotifier = new QSocketNotifier(m_master, QSocketNotifier::Write, this);
+    m_writeNotifier->setEnabled(false);
+    connect(m_readNotifier, &QSocketNotifier::activated, this,
+            &PtyProcessBackend::onReadActivated);
+    connect(m_writeNotifier, &QSocketNotifier::activated, this,
+            &PtyProcessBackend::onWriteActivated);
+
+    qDebug() << "Started process" << m_command << "on" << slave.constData()
+             << "with PID" << m_pid;
+    return Backend::open(mode | QIODevice::Unbuffered);
+}
+
+/**
+ * Terminates the program & closes the pseudo-terminal
+ */
+void PtyProcessBackend::close()
+{
+    Backend::close();
+    stopProcess();
+}
+
+/**
+ * Returns the number of bytes written by the program that have not been read yet
+ */
+qint64 PtyProcessBackend::bytesAvailable() const
+{
+    return m_readBuffer.size() + Backend::bytesAvailable();
+}
+
+/**
+ * Returns the number of bytes waiting to be written to the program
+ */
+qint64 PtyProcessBackend::bytesToWrite() const
+{
+    return m_writeBuffer.size();
+}
+
+/**
+ * Reads up to @a maxSize bytes written by the program
+ */
+qint64 PtyProcessBackend::readData(char *data, qint64 maxSize)
+{
+    const auto size = qMin<qint64>(maxSize, m_readBuffer.size());
+    memcpy(data, m_readBuffer.constData(), static_cast<size_t>(size));
+    m_readBuffer.remove(0, static_cast<int>(size));
+    return size;
+}
+
+/**
+ * Writes @a maxSize bytes to the program, data that cannot be written immediately is
+ * buffered & written when the pseudo-terminal is writable again
+ */
+qint64 PtyProcessBackend::writeData(const char *data, qint64 maxSize)
+{
+    if (m_master < 0)
+        return -1;
+
+    m_writeBuffer.append(data, static_cast<int>(maxSize));
+    flushWriteBuffer();
+    return maxSize;
+}
+
+/**
+ * Reads all the data available in the pseudo-terminal
+ */
+void PtyProcessBackend::onReadActivated()
+{
+    const int previousSize = m_readBuffer.size();
+    while (true)
+    {
+        // Read directly into the read buffer
+        const int offset = m_readBuffer.size();
+        m_readBuffer.resize(offset + READ_CHUNK_SIZE);
+        auto bytes = ::read(m_master, m_readBuffer.data() + offset, READ_CHUNK_SIZE);
+        m_readBuffer.resize(offset + static_cast<int>(qMax<ssize_t>(0, bytes)));
+
+        // Stop when there is no more data
+        if (bytes > 0)
+            continue;
+        if (bytes < 0 && errno == EINTR)
+            continue;
+        if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+
+        // The program exited (EIO) or closed the terminal
+        m_readNotifier->setEnabled(false);
+        if (m_readBuffer.size() > previousSize)
+            emit readyRead();
+        if (isOpen())
+        {
+            emit readChannelFinished();
+            emit errorOccurred(tr("%1 exited").arg(m_command));
+        }
+
+        return;
+    }
+
+    if (m_readBuffer.size() > previousSize)
+        emit readyRead();
+}
+
+/**
+ * Writes pending data once the pseudo-terminal is writable
+ */
+void PtyProcessBackend::onWriteActivated()
+{
+    flushWriteBuffer();
+}
+
+/**
+ * Terminates the program (if running) & closes the pseudo-terminal
+ */
+void PtyProcessBackend::stopProcess()
+{
+    // Stop watching the pseudo-terminal
+    delete m_readNotifier;
+    delete m_writeNotifier;
+    m_readNotifier = nullptr;
+    m_writeNotifier = nullptr;
+
+    // Close the master side (the program receives SIGHUP)
+    if (m_master >= 0)
+    {
+        ::close(m_master);
+        m_master = -1;
+    }
+
+    // Wait for the program to exit & kill it if it does not
+    if (m_pid > 0)
+    {
+        kill(m_pid, SIGHUP);
+        int elapsed = 0;
+        while (waitpid(m_pid, nullptr, WNOHANG) == 0 && elapsed < EXIT_TIMEOUT)
+        {
+            QThread::msleep(10);
+            elapsed += 10;
+        }
+
+        if (elapsed >= EXIT_TIMEOUT)
+        {
+            kill(m_pid, SIGKILL);
+            waitpid(m_pid, nullptr, 0);
+        }
+
+        m_pid = -1;
+    }
+
+    m_writeBuffer.clear();
+}
+
+/**
+ * Writes as much pending data as possible & watches the pseudo-terminal until the
+ * remaining data can be written
+ */
+void PtyProcessBackend::flushWriteBuffer()
+{
+    qint64 written = 0;
+    while (written < m_writeBuffer.size())
+    {
+        auto bytes = ::write(m_master, m_writeBuffer.constData() + written,
+                             static_cast<size_t>(m_writeBuffer.size() - written));
+        if (bytes < 0 && errno == EINTR)
+            continue;
+        if (bytes <= 0)
+            break;
+
+        written += bytes;
+    }
+
+    // Remove written data
+    m_writeBuffer.remove(0, static_cast<int>(written));
+    if (m_writeNotifier)
+        m_writeNotifier->setEnabled(!m_writeBuffer.isEmpty());
+
+    // Notify application
+    if (written > 0)
+        emit bytesWritten(written);
+}
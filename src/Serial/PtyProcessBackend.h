@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SERIAL_PTY_PROCESS_BACKEND_H
+#define SERIAL_PTY_PROCESS_BACKEND_H
+
+#include <sys/types.h>
+
+#include <Serial/Backend.h>
+
+class QSocketNotifier;
+
+namespace Serial
+{
+/**
+ * Runs a local program attached to a new pseudo-terminal, for programs that only work
+ * with a terminal (e.g. programs that check @c isatty() or that expect line
+ * discipline signals). Device names have the form @c pty:command, the command is run
+ * by @c /bin/sh.
+ *
+ * The terminal is set to raw mode, so that data is transmitted as-is in both
+ * directions. Reads & writes are done in non-blocking mode with large buffers & the
+ * device is closed when the program exits.
+ */
+class PtyProcessBackend : public Backend
+{
+    Q_OBJECT
+
+public:
+    PtyProcessBackend(const QString &command, QObject *parent = nullptr);
+    ~PtyProcessBackend();
+
+    QString name() const override;
+
+    bool open(OpenMode mode) override;
+    void close() override;
+
+    qint64 bytesAvailable() const override;
+    qint64 bytesToWrite() const override;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private slots:
+    void onReadActivated();
+    void onWriteActivated();
+
+private:
+    void stopProcess();
+    void flushWriteBuffer();
+
+private:
+    QString m_command;
+
+    int m_master;
+    pid_t m_pid;
+
+    QByteArray m_readBuffer;
+    QByteArray m_writeBuffer;
+    QSocketNotifier *m_readNotifier;
+    QSocketNotifier *m_writeNotifier;
+};
+}
+
+#endif
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Serial/SerialPortBackend.h>
+
+using namespace Serial;
+
+/**
+ * Maximum number of bytes buffered by the serial port object while the read buffer is
+ * bounded. When the buffer is full (e.g. reading is paused by @c Manager), received
+ * data is kept by the driver, which allows hardware/software flow control to stop the
+ * remote device.
+ */
+static const qint64 READ_BUFFER_SIZE = 64 * 1024;
+
+/**
+ * Creates a backend for the serial port with the given @a name
+ */
+SerialPortBackend::SerialPortBackend(const QString &name, QObject *parent)
+    : Backend(parent)
+    , m_port(new QSerialPort(name, this))
+{
+    init();
+}
+
+/**
+ * Creates a backend for the serial port described by the given @a info
+ */
+SerialPortBackend::SerialPortBackend(const QSerialPortInfo &info, QObject *parent)
+    : Backend(parent)
+    , m_port(new QSerialPort(info, this))
+{
+    init();
+}
+
+/**
+ * Returns the name of the serial port
+ */
+QString SerialPortBackend::name() const
+{
+    return m_port->portName();
+}
+
+/**
+ * Returns the serial port object used by the backend
+ */
+QSerialPort *SerialPortBackend::serialPort() const
+{
+    return m_port;
+}
+
+/**
+ * Configures & opens the serial port
+ */
+bool SerialPortBackend::open(OpenMode mode)
+{
+    // Configure serial port
+    m_port->setParity(parity());
+    m_port->setBaudRate(baudRate());
+    m_port->setDataBits(dataBits());
+    m_port->setStopBits(stopBits());
+    m_port->setFlowControl(flowControl());
+    m_port->setReadBufferSize(boundedReadBuffer() ? READ_BUFFER_SIZE : 0);
+
+    // Open serial port
+    if (!m_port->open(mode))
+    {
+        setErrorString(m_port->errorString());
+        return false;
+    }
+
+    // Data is buffered by the serial port object
+    return Backend::open(mode | QIODevice::Unbuffered);
+}
+
+/**
+ * Closes the serial port
+ */
+void SerialPortBackend::close()
+{
+    m_port->close();
+    Backend::close();
+}
+
+/**
+ * Returns the number of bytes stored in the read buffer of the serial port
+ */
+qint64 SerialPortBackend::bytesAvailable() const
+{
+    return m_port->bytesAvailable() + Backend::bytesAvailable();
+}
+
+/**
+ * Returns the number of bytes waiting to be written to the serial port
+ */
+qint64 SerialPortBackend::bytesToWrite() const
+{
+    return m_port->bytesToWrite();
+}
+
+/**
+ * Writes as much buffered data as possible to the serial port without blocking
+ */
+bool SerialPortBackend::flush()
+{
+    return m_port->flush();
+}
+
+/**
+ * Changes the baud rate of the serial port
+ */
+void SerialPortBackend::setBaudRate(const qint32 rate)
+{
+    Backend::setBaudRate(rate);
+    m_port->setBaudRate(rate);
+}
+
+/**
+ * Changes the parity of the serial port
+ */
+void SerialPortBackend::setParity(const QSerialPort::Parity parity)
+{
+    Backend::setParity(parity);
+    m_port->setParity(parity);
+}
+
+/**
+ * Changes the number of data bits of the serial port
+ */
+void SerialPortBackend::setDataBits(const QSerialPort::DataBits dataBits)
+{
+    Backend::setDataBits(dataBits);
+    m_port->setDataBits(dataBits);
+}
+
+/**
+ * Changes the number of stop bits of the serial port
+ */
+void SerialPortBackend::setStopBits(const QSerialPort::StopBits stopBits)
+{
+    Backend::setStopBits(stopBits);
+    m_port->setStopBits(stopBits);
+}
+
+/**
+ * Changes the flow control mode of the serial port
+ */
+void SerialPortBackend::setFlowControl(const QSerialPort::FlowControl flowControl)
+{
+    Backend::setFlowControl(flowControl);
+    m_port->setFlowControl(flowControl);
+}
+
+/**
+ * Bounds the read buffer of the serial port to @c READ_BUFFER_SIZE bytes, or makes it
+ * unlimited again if @a bounded is @c false
+ */
+void SerialPortBackend::setBoundedReadBuffer(const bool bounded)
+{
+    Backend::setBoundedReadBuffer(bounded);
+    m_port->setReadBufferSize(bounded ? READ_BUFFER_SIZE : 0);
+}
+
+/**
+ * Reads up to @a maxSize bytes from the read buffer of the serial port
+ */
+qint64 SerialPortBackend::readData(char *data, qint64 maxSize)
+{
+    return m_port->read(data, maxSize);
+}
+
+/**
+ * Writes @a maxSize bytes to the write buffer of the serial port
+ */
+qint64 SerialPortBackend::writeData(const char *data, qint64 maxSize)
+{
+    return m_port->write(data, maxSize);
+}
+
+/**
+ * Forwards serial port errors as backend errors
+ */
+void SerialPortBackend::onErrorOccurred(QSerialPort::SerialPortError error)
+{
+    if (error != QSerialPort::NoError)
+        emit errorOccurred(m_port->errorString());
+}
+
+/**
+ * Forwards the signals of the serial port object
+ */
+void SerialPortBackend::init()
+{
+    connect(m_port, &QSerialPort::readyRead, this, &SerialPortBackend::readyRead);
+    connect(m_port, &QSerialPort::bytesWritten, this, &SerialPortBackend::bytesWritten);
+    connect(m_port, SIGNAL(errorOccurred(QSerialPort::SerialPortError)), this,
+            SLOT(onErrorOccurred(QSerialPort::SerialPortError)));
+}
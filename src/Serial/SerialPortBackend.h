@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SERIAL_SERIAL_PORT_BACKEND_H
+#define SERIAL_SERIAL_PORT_BACKEND_H
+
+#include <QSerialPort>
+#include <QSerialPortInfo>
+#include <Serial/Backend.h>
+
+namespace Serial
+{
+/**
+ * Backend for local serial ports (implemented with @c QSerialPort). The device is
+ * opened in unbuffered mode, reads & writes go directly to the buffers of the
+ * @c QSerialPort object.
+ */
+class SerialPortBackend : public Backend
+{
+    Q_OBJECT
+
+public:
+    SerialPortBackend(const QString &name, QObject *parent = nullptr);
+    SerialPortBackend(const QSerialPortInfo &info, QObject *parent = nullptr);
+
+    QString name() const override;
+    QSerialPort *serialPort() const override;
+
+    bool open(OpenMode mode) override;
+    void close() override;
+
+    qint64 bytesAvailable() const override;
+    qint64 bytesToWrite() const override;
+    bool flush() override;
+
+    void setBaudRate(const qint32 rate) override;
+    void setParity(const QSerialPort::Parity parity) override;
+    void setDataBits(const QSerialPort::DataBits dataBits) override;
+    void setStopBits(const QSerialPort::StopBits stopBits) override;
+    void setFlowControl(const QSerialPort::FlowControl flowControl) override;
+    void setBoundedReadBuffer(const bool bounded) override;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private slots:
+    void onErrorOccurred(QSerialPort::SerialPortError error);
+
+private:
+    void init();
+
+private:
+    QSerialPort *m_port;
+};
+}
+
+#endif
@@ -0,0 +1,462 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Serial/Manager.h>
+#include <Serial/Statistics.h>
+
+#ifdef Q_OS_LINUX
+#    include <sys/ioctl.h>
+#    include <linux/serial.h>
+#endif
+
+using namespace Serial;
+
+/**
+ * Pointer to the only instance of the class
+ */
+static Statistics *INSTANCE = nullptr;
+
+/**
+ * Length (in seconds) of the largest sliding window used to calculate rates
+ */
+static const int MAX_WINDOW = 60;
+
+/**
+ * Indexes of the driver counters
+ */
+enum DriverCounter
+{
+    Parity,
+    Framing,
+    Overrun,
+    BufferOverrun,
+    Break,
+    DriverCounterCount
+};
+
+/**
+ * Constructor function
+ */
+Statistics::Statistics()
+    : m_samples(0)
+    , m_rxSamples(MAX_WINDOW + 1, 0)
+    , m_txSamples(MAX_WINDOW + 1, 0)
+    , m_driverCountersBaseValid(false)
+    , m_driverCountersBase(DriverCounterCount, 0)
+{
+    reset();
+
+    // Connect signals/slots
+    auto manager = Manager::getInstance();
+    connect(manager, &Manager::dataSent, this, &Statistics::onDataSent);
+    connect(manager, &Manager::portChanged, this, &Statistics::onPortChanged);
+    connect(manager, &Manager::dataReceived, this, &Statistics::onDataReceived);
+
+    // Update values @ 1 Hz
+    connect(&m_timer, &QTimer::timeout, this, &Statistics::update);
+    m_timer.start(1000);
+}
+
+/**
+ * Returns the only instance of the class
+ */
+Statistics *Statistics::getInstance()
+{
+    if (!INSTANCE)
+        INSTANCE = new Statistics;
+
+    return INSTANCE;
+}
+
+/**
+ * Returns the name of the serial port to which the counters belong
+ */
+QString Statistics::portName() const
+{
+    return m_portName;
+}
+
+/**
+ * Returns the number of bytes received from the serial port
+ */
+qint64 Statistics::rxBytes() const
+{
+    return m_rxBytes;
+}
+
+/**
+ * Returns the number of bytes written to the serial port device
+ */
+qint64 Statistics::txBytes() const
+{
+    return m_txBytes;
+}
+
+/**
+ * Returns the number of times that data has been read from the serial port
+ */
+qint64 Statistics::readCalls() const
+{
+    return m_readCalls;
+}
+
+/**
+ * Returns the number of times that data has been queued for transmission
+ */
+qint64 Statistics::writeCalls() const
+{
+    return m_writeCalls;
+}
+
+/**
+ * Returns the number of parity errors detected by the serial driver
+ */
+qint64 Statistics::parityErrors() const
+{
+    return m_parityErrors;
+}
+
+/**
+ * Returns the number of framing errors detected by the serial driver
+ */
+qint64 Statistics::framingErrors() const
+{
+    return m_framingErrors;
+}
+
+/**
+ * Returns the number of hardware overruns (the UART FIFO was full) detected by the
+ * serial driver
+ */
+qint64 Statistics::overrunErrors() const
+{
+    return m_overrunErrors;
+}
+
+/**
+ * Returns the number of buffer overruns (the driver buffer was full) detected by the
+ * serial driver
+ */
+qint64 Statistics::bufferOverruns() const
+{
+    return m_bufferOverruns;
+}
+
+/**
+ * Returns the number of break conditions detected by the serial driver
+ */
+qint64 Statistics::breakEvents() const
+{
+    return m_breakEvents;
+}
+
+/**
+ * Returns the number of errors reported by @c QSerialPort
+ */
+qint64 Statistics::portErrors() const
+{
+    return m_portErrors;
+}
+
+/**
+ * Returns the size of the largest chunk of data read from the serial port
+ */
+qint64 Statistics::readHighWaterMark() const
+{
+    return m_readHighWaterMark;
+}
+
+/**
+ * Returns the maximum number of bytes that were waiting to be written to the device
+ */
+qint64 Statistics::writeHighWaterMark() const
+{
+    return m_writeHighWaterMark;
+}
+
+/**
+ * Returns the receive rate (bytes/s) during the last second
+ */
+double Statistics::rxRate1s() const
+{
+    return rate(m_rxSamples, 1);
+}
+
+/**
+ * Returns the receive rate (bytes/s) during the last 10 seconds
+ */
+double Statistics::rxRate10s() const
+{
+    return rate(m_rxSamples, 10);
+}
+
+/**
+ * Returns the receive rate (bytes/s) during the last 60 seconds
+ */
+double Statistics::rxRate60s() const
+{
+    return rate(m_rxSamples, 60);
+}
+
+/**
+ * Returns the transmit rate (bytes/s) during the last second
+ */
+double Statistics::txRate1s() const
+{
+    return rate(m_txSamples, 1);
+}
+
+/**
+ * Returns the transmit rate (bytes/s) during the last 10 seconds
+ */
+double Statistics::txRate10s() const
+{
+    return rate(m_txSamples, 10);
+}
+
+/**
+ * Returns the transmit rate (bytes/s) during the last 60 seconds
+ */
+double Statistics::txRate60s() const
+{
+    return rate(m_txSamples, 60);
+}
+
+/**
+ * Returns all the statistics as a JSON object
+ */
+QJsonObject Statistics::toJson() const
+{
+    QJsonObject object;
+    object.insert("port", portName());
+    object.insert("connected", Manager::getInstance()->connected());
+    object.insert("rxBytes", rxBytes());
+    object.insert("txBytes", txBytes());
+    object.insert("readCalls", readCalls());
+    object.insert("writeCalls", writeCalls());
+    object.insert("parityErrors", parityErrors());
+    object.insert("framingErrors", framingErrors());
+    object.insert("overrunErrors", overrunErrors());
+    object.insert("bufferOverruns", bufferOverruns());
+    object.insert("breakEvents", breakEvents());
+    object.insert("portErrors", portErrors());
+    object.insert("readHighWaterMark", readHighWaterMark());
+    object.insert("writeHighWaterMark", writeHighWaterMark());
+    object.insert("rxRate1s", rxRate1s());
+    object.insert("rxRate10s", rxRate10s());
+    object.insert("rxRate60s", rxRate60s());
+    object.insert("txRate1s", txRate1s());
+    object.insert("txRate10s", txRate10s());
+    object.insert("txRate60s", txRate60s());
+    return object;
+}
+
+/**
+ * Resets all the counters & rates, the current driver counters become the reference
+ * values of the parity, framing, overrun & break counters
+ */
+void Statistics::reset()
+{
+    m_rxBytes = 0;
+    m_txBytes = 0;
+    m_readCalls = 0;
+    m_writeCalls = 0;
+    m_parityErrors = 0;
+    m_framingErrors = 0;
+    m_overrunErrors = 0;
+    m_bufferOverruns = 0;
+    m_breakEvents = 0;
+    m_portErrors = 0;
+    m_readHighWaterMark = 0;
+    m_writeHighWaterMark = 0;
+
+    m_samples = 0;
+    m_rxSamples.fill(0);
+    m_txSamples.fill(0);
+
+    // Use the current driver counters as the reference values
+    m_driverCountersBaseValid = driverCounters(m_driverCountersBase);
+
+    emit updated();
+}
+
+/**
+ * Reads the driver counters & registers the byte counters in the sliding windows
+ */
+void Statistics::update()
+{
+    readDriverCounters();
+
+    const int index = m_samples % m_rxSamples.size();
+    m_rxSamples[index] = m_rxBytes;
+    m_txSamples[index] = m_txBytes;
+    ++m_samples;
+
+    emit updated();
+}
+
+/**
+ * Resets the counters when a new serial port is opened & connects the signals of the
+ * serial port object that are not forwarded by @c Manager.
+ */
+void Statistics::onPortChanged()
+{
+    auto port = Manager::getInstance()->port();
+    if (!port || port == m_port)
+        return;
+
+    // Reset the counters (the driver counters are read as soon as the port is opened,
+    // so that errors detected before the first update are reported)
+    m_port = port;
+    m_portName = port->name();
+    reset();
+
+    // clang-format off
+    connect(port, &QIODevice::bytesWritten,
+            this, &Statistics::onBytesWritten, Qt::UniqueConnection);
+    connect(port, &Backend::lineError,
+            this, &Statistics::onLineError, Qt::UniqueConnection);
+    connect(port, &Backend::errorOccurred,
+            this, &Statistics::onErrorOccurred, Qt::UniqueConnection);
+    // clang-format on
+}
+
+/**
+ * Registers the number of @a bytes written to the serial port device
+ */
+void Statistics::onBytesWritten(qint64 bytes)
+{
+    m_txBytes += bytes;
+}
+
+/**
+ * Registers a write call & updates the write queue high-water mark
+ */
+void Statistics::onDataSent(const QByteArray &data)
+{
+    Q_UNUSED(data);
+
+    ++m_writeCalls;
+    if (m_port)
+        m_writeHighWaterMark = qMax(m_writeHighWaterMark, m_port->bytesToWrite());
+}
+
+/**
+ * Registers a read call & updates the read high-water mark
+ */
+void Statistics::onDataReceived(const QByteArray &data)
+{
+    ++m_readCalls;
+    m_rxBytes += data.size();
+    m_readHighWaterMark = qMax<qint64>(m_readHighWaterMark, data.size());
+}
+
+/**
+ * Counts the line @a errors reported by the backend (for devices whose driver counters
+ * cannot be read directly)
+ */
+void Statistics::onLineError(const int errors)
+{
+    if (errors & Backend::ParityError)
+        ++m_parityErrors;
+    if (errors & Backend::FramingError)
+        ++m_framingErrors;
+    if (errors & Backend::OverrunError)
+        ++m_overrunErrors;
+    if (errors & Backend::BreakError)
+        ++m_breakEvents;
+}
+
+/**
+ * Counts the errors reported by the backend
+ */
+void Statistics::onErrorOccurred(const QString &error)
+{
+    Q_UNUSED(error);
+    ++m_portErrors;
+}
+
+/**
+ * Obtains the parity, framing, overrun & break @a counters from the serial driver.
+ *
+ * @returns @c false if the counters are not available (port closed, not a local serial
+ *          port or driver without @c TIOCGICOUNT support)
+ */
+bool Statistics::driverCounters(QVector<qint64> &counters) const
+{
+#ifdef Q_OS_LINUX
+    // Serial port not open (or not a local serial port)
+    if (!m_port || !m_port->isOpen() || !m_port->serialPort())
+        return false;
+
+    // Driver does not support TIOCGICOUNT
+    struct serial_icounter_struct icount;
+    if (::ioctl(m_port->serialPort()->handle(), TIOCGICOUNT, &icount) != 0)
+        return false;
+
+    // Get counters
+    counters = QVector<qint64>(DriverCounterCount, 0);
+    counters[Parity] = icount.parity;
+    counters[Framing] = icount.frame;
+    counters[Overrun] = icount.overrun;
+    counters[BufferOverrun] = icount.buf_overrun;
+    counters[Break] = icount.brk;
+    return true;
+#else
+    Q_UNUSED(counters);
+    return false;
+#endif
+}
+
+/**
+ * Updates the parity, framing, overrun & break counters with the values of the serial
+ * driver. The driver counters are not reset when the port is opened, so the values
+ * read when the port is opened are used as a reference.
+ */
+void Statistics::readDriverCounters()
+{
+    QVector<qint64> counters;
+    if (!m_driverCountersBaseValid || !driverCounters(counters))
+        return;
+
+    m_parityErrors = counters[Parity] - m_driverCountersBase[Parity];
+    m_framingErrors = counters[Framing] - m_driverCountersBase[Framing];
+    m_overrunErrors = counters[Overrun] - m_driverCountersBase[Overrun];
+    m_bufferOverruns = counters[BufferOverrun] - m_driverCountersBase[BufferOverrun];
+    m_breakEvents = counters[Break] - m_driverCountersBase[Break];
+}
+
+/**
+ * Returns the average rate (bytes/s) of the given cumulative @a samples during the last
+ * number of @a seconds (or since the port was opened if it was opened later).
+ */
+double Statistics::rate(const QVector<qint64> &samples, const int seconds) const
+{
+    if (m_samples < 2)
+        return 0;
+
+    const int size = samples.size();
+    const int window = qMin(seconds, qMin(m_samples - 1, size - 1));
+    const auto newest = samples.at((m_samples - 1) % size);
+    const auto oldest = samples.at((m_samples - 1 - window) % size);
+    return static_cast<double>(newest - oldest) / window;
+}
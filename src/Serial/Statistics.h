@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SERIAL_STATISTICS_H
+#define SERIAL_STATISTICS_H
+
+#include <QTimer>
+#include <QVector>
+#include <QObject>
+#include <QPointer>
+#include <QJsonObject>
+#include <QtSerialPort>
+
+#include <Serial/Backend.h>
+
+namespace Serial
+{
+/**
+ * Link statistics of the current serial port:
+ *
+ * - Received & transmitted bytes, number of read & write calls
+ * - Parity, framing, overrun & break events (obtained from the serial driver with the
+ *   @c TIOCGICOUNT ioctl on GNU/Linux for local serial ports, or from the line state
+ *   notifications of backends that report them) & errors reported by the backend
+ * - High-water marks of the read chunks & of the write queue
+ * - Receive & transmit rates over sliding windows of 1, 10 & 60 seconds
+ *
+ * Counters are reset when a new serial port is opened and kept after the port is
+ * closed, so that they can still be inspected. Values are updated every second.
+ */
+class Statistics : public QObject
+{
+    // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(QString portName
+               READ portName
+               NOTIFY updated)
+    Q_PROPERTY(qint64 rxBytes
+               READ rxBytes
+               NOTIFY updated)
+    Q_PROPERTY(qint64 txBytes
+               READ txBytes
+               NOTIFY updated)
+    Q_PROPERTY(qint64 readCalls
+               READ readCalls
+               NOTIFY updated)
+    Q_PROPERTY(qint64 writeCalls
+               READ writeCalls
+               NOTIFY updated)
+    Q_PROPERTY(qint64 parityErrors
+               READ parityErrors
+               NOTIFY updated)
+    Q_PROPERTY(qint64 framingErrors
+               READ framingErrors
+               NOTIFY updated)
+    Q_PROPERTY(qint64 overrunErrors
+               READ overrunErrors
+               NOTIFY updated)
+    Q_PROPERTY(qint64 bufferOverruns
+               READ bufferOverruns
+               NOTIFY updated)
+    Q_PROPERTY(qint64 breakEvents
+               READ breakEvents
+               NOTIFY updated)
+    Q_PROPERTY(qint64 portErrors
+               READ portErrors
+               NOTIFY updated)
+    Q_PROPERTY(qint64 readHighWaterMark
+               READ readHighWaterMark
+               NOTIFY updated)
+    Q_PROPERTY(qint64 writeHighWaterMark
+               READ writeHighWaterMark
+               NOTIFY updated)
+    Q_PROPERTY(double rxRate1s
+               READ rxRate1s
+               NOTIFY updated)
+    Q_PROPERTY(double rxRate10s
+               READ rxRate10s
+               NOTIFY updated)
+    Q_PROPERTY(double rxRate60s
+               READ rxRate60s
+               NOTIFY updated)
+    Q_PROPERTY(double txRate1s
+               READ txRate1s
+               NOTIFY updated)
+    Q_PROPERTY(double txRate10s
+               READ txRate10s
+               NOTIFY updated)
+    Q_PROPERTY(double txRate60s
+               READ txRate60s
+               NOTIFY updated)
+    // clang-format on
+
+signals:
+    void updated();
+
+public:
+    static Statistics *getInstance();
+
+    QString portName() const;
+
+    qint64 rxBytes() const;
+    qint64 txBytes() const;
+    qint64 readCalls() const;
+    qint64 writeCalls() const;
+
+    qint64 parityErrors() const;
+    qint64 framingErrors() const;
+    qint64 overrunErrors() const;
+    qint64 bufferOverruns() const;
+    qint64 breakEvents() const;
+    qint64 portErrors() const;
+
+    qint64 readHighWaterMark() const;
+    qint64 writeHighWaterMark() const;
+
+    double rxRate1s() const;
+    double rxRate10s() const;
+    double rxRate60s() const;
+    double txRate1s() const;
+    double txRate10s() const;
+    double txRate60s() const;
+
+    Q_INVOKABLE QJsonObject toJson() const;
+
+public slots:
+    void reset();
+
+private slots:
+    void update();
+    void onPortChanged();
+    void onBytesWritten(qint64 bytes);
+    void onDataSent(const QByteArray &data);
+    void onDataReceived(const QByteArray &data);
+    void onLineError(const int errors);
+    void onErrorOccurred(const QString &error);
+
+private:
+    Statistics();
+    void readDriverCounters();
+    bool driverCounters(QVector<qint64> &counters) const;
+    double rate(const QVector<qint64> &samples, const int seconds) const;
+
+private:
+    QTimer m_timer;
+    QString m_portName;
+    QPointer<Backend> m_port;
+
+    qint64 m_rxBytes;
+    qint64 m_txBytes;
+    qint64 m_readCalls;
+    qint64 m_writeCalls;
+
+    qint64 m_parityErrors;
+    qint64 m_framingErrors;
+    qint64 m_overrunErrors;
+    qint64 m_bufferOverruns;
+    qint64 m_breakEvents;
+    qint64 m_portErrors;
+
+    qint64 m_readHighWaterMark;
+    qint64 m_writeHighWaterMark;
+
+    int m_samples;
+    QVector<qint64> m_rxSamples;
+    QVector<qint64> m_txSamples;
+
+    bool m_driverCountersBaseValid;
+    QVector<qint64> m_driverCountersBase;
+};
+}
+
+#endif
@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Serial/Dispatcher.h>
+#include <Serial/Subscription.h>
+
+using namespace Serial;
+
+/**
+ * Creates a subscription with the given @a name (used in the statistics), @a policy &
+ * @a capacity (in bytes) & registers it in the dispatcher
+ */
+Subscription::Subscription(const QString &name, const Policy policy,
+                           const qint64 capacity, QObject *parent)
+    : QObject(parent)
+    , m_name(name)
+    , m_policy(policy)
+    , m_capacity(qMax<qint64>(1, capacity))
+    , m_overflowed(false)
+    , m_queuedBytes(0)
+    , m_deliveredBytes(0)
+    , m_droppedBytes(0)
+    , m_droppedChunks(0)
+    , m_highWaterMark(0)
+{
+    Dispatcher::getInstance()->add(this);
+}
+
+/**
+ * Unregisters the subscription from the dispatcher
+ */
+Subscription::~Subscription()
+{
+    Dispatcher::getInstance()->remove(this);
+}
+
+/**
+ * Returns the name of the given @a policy
+ */
+QString Subscription::policyName(const Policy policy)
+{
+    switch (policy)
+    {
+        case Policy::Block:
+            return "block";
+        case Policy::DropOldest:
+            return "drop-oldest";
+        case Policy::DropNewest:
+            return "drop-newest";
+        case Policy::Disconnect:
+            return "disconnect";
+    }
+
+    return QString();
+}
+
+/**
+ * Obtains the @a policy with the given @a name
+ *
+ * @returns @c false if the name is not valid
+ */
+bool Subscription::policyFromName(const QString &name, Policy &policy)
+{
+    const Policy policies[]
+        = { Policy::Block, Policy::DropOldest, Policy::DropNewest, Policy::Disconnect };
+
+    for (auto candidate : policies)
+    {
+        if (policyName(candidate) == name.toLower())
+        {
+            policy = candidate;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Returns the name of the subscription
+ */
+QString Subscription::name() const
+{
+    return m_name;
+}
+
+/**
+ * Returns the policy applied when the queue is full
+ */
+Subscription::Policy Subscription::policy() const
+{
+    return m_policy;
+}
+
+/**
+ * Returns the maximum number of queued bytes
+ */
+qint64 Subscription::capacity() const
+{
+    return m_capacity;
+}
+
+/**
+ * Returns @c true if the queue is full
+ */
+bool Subscription::isFull() const
+{
+    return m_queuedBytes >= m_capacity;
+}
+
+/**
+ * Returns the number of bytes that can be queued before the queue is full
+ */
+qint64 Subscription::freeSpace() const
+{
+    return qMax<qint64>(0, m_capacity - m_queuedBytes);
+}
+
+/**
+ * Returns @c true if there is no queued data
+ */
+bool Subscription::isEmpty() const
+{
+    return m_queue.isEmpty();
+}
+
+/**
+ * Returns @c true if the queue overflowed with the @c Disconnect policy, no more data
+ * is queued afterwards
+ */
+bool Subscription::isOverflowed() const
+{
+    return m_overflowed;
+}
+
+/**
+ * Returns the number of queued bytes
+ */
+qint64 Subscription::queuedBytes() const
+{
+    return m_queuedBytes;
+}
+
+/**
+ * Returns the number of bytes taken by the consumer
+ */
+qint64 Subscription::deliveredBytes() const
+{
+    return m_deliveredBytes;
+}
+
+/**
+ * Returns the number of discarded bytes
+ */
+qint64 Subscription::droppedBytes() const
+{
+    return m_droppedBytes;
+}
+
+/**
+ * Returns the number of discarded (or truncated) data blocks
+ */
+qint64 Subscription::droppedChunks() const
+{
+    return m_droppedChunks;
+}
+
+/**
+ * Returns the maximum number of queued bytes
+ */
+qint64 Subscription::highWaterMark() const
+{
+    return m_highWaterMark;
+}
+
+/**
+ * Returns the state & the counters of the subscription
+ */
+QJsonObject Subscription::toJson() const
+{
+    QJsonObject json;
+    json.insert("name", name());
+    json.insert("policy", policyName(policy()));
+    json.insert("capacity", capacity());
+    json.insert("queuedBytes", queuedBytes());
+    json.insert("deliveredBytes", deliveredBytes());
+    json.insert("droppedBytes", droppedBytes());
+    json.insert("droppedChunks", droppedChunks());
+    json.insert("highWaterMark", highWaterMark());
+    json.insert("overflowed", isOverflowed());
+    return json;
+}
+
+/**
+ * Appends the given @a data to the queue, applying the policy of the subscription if
+ * the queue is full. The data is shared with the other subscriptions (not copied).
+ */
+void Subscription::push(const QByteArray &data)
+{
+    if (data.isEmpty() || m_overflowed)
+        return;
+
+    // Apply policy
+    if (m_queuedBytes + data.size() > m_capacity)
+    {
+        switch (m_policy)
+        {
+            case Policy::Block:
+                // Reads are limited to the free space of the queue (see
+                // Dispatcher::updateReadState()), keep the data that fits
+                if (isFull())
+                {
+                    drop(data.size());
+                    return;
+                }
+
+                drop(m_queuedBytes + data.size() - m_capacity);
+                push(data.left(static_cast<int>(m_capacity - m_queuedBytes)));
+                return;
+            case Policy::DropNewest:
+                drop(data.size());
+                return;
+            case Policy::Disconnect:
+                drop(m_queuedBytes + data.size());
+                m_queue.clear();
+                m_queuedBytes = 0;
+                m_overflowed = true;
+                emit overflowed();
+                return;
+            case Policy::DropOldest:
+                // Discard complete blocks first
+                while (!m_queue.isEmpty() && m_queuedBytes + data.size() > m_capacity)
+                {
+                    m_queuedBytes -= m_queue.head().size();
+                    drop(m_queue.dequeue().size());
+                }
+
+                // Keep the end of blocks that are larger than the queue
+                if (data.size() > m_capacity)
+                {
+                    drop(data.size() - m_capacity);
+                    m_queue.enqueue(data.right(static_cast<int>(m_capacity)));
+                    m_queuedBytes = m_capacity;
+                    m_highWaterMark = qMax(m_highWaterMark, m_queuedBytes);
+                    emit dataAvailable();
+                    return;
+                }
+                break;
+        }
+    }
+
+    // Queue data
+    const bool wasEmpty = m_queue.isEmpty();
+    m_queue.enqueue(data);
+    m_queuedBytes += data.size();
+    m_highWaterMark = qMax(m_highWaterMark, m_queuedBytes);
+
+    // Notify consumer
+    if (wasEmpty)
+        emit dataAvailable();
+}
+
+/**
+ * Removes the oldest data block from the queue, the block is returned without copying
+ * it (it is shared with the other subscriptions)
+ */
+QByteArray Subscription::takeChunk()
+{
+    if (m_queue.isEmpty())
+        return QByteArray();
+
+    const bool wasFull = isFull();
+    auto data = m_queue.dequeue();
+    taken(data.size(), wasFull);
+    return data;
+}
+
+/**
+ * Removes up to @a maxSize bytes from the queue (all the queued data if @a maxSize is
+ * negative). Queued blocks are returned without copying them when possible.
+ */
+QByteArray Subscription::take(const qint64 maxSize)
+{
+    const bool wasFull = isFull();
+
+    // Take data
+    QByteArray data;
+    if (maxSize < 0 && m_queue.size() == 1)
+        data = m_queue.dequeue();
+    else
+    {
+        const auto limit = maxSize < 0 ? m_queuedBytes : qMin(maxSize, m_queuedBytes);
+        data.reserve(static_cast<int>(limit));
+        while (!m_queue.isEmpty() && data.size() < limit)
+        {
+            auto &head = m_queue.head();
+            const auto count = qMin<qint64>(head.size(), limit - data.size());
+            if (count == head.size())
+                data.append(m_queue.dequeue());
+            else
+            {
+                data.append(head.constData(), static_cast<int>(count));
+                head.remove(0, static_cast<int>(count));
+            }
+        }
+    }
+
+    taken(data.size(), wasFull);
+    return data;
+}
+
+/**
+ * Updates the counters after the consumer takes the given number of @a bytes & notifies
+ * the producer if the queue is no longer full
+ */
+void Subscription::taken(const qint64 bytes, const bool wasFull)
+{
+    m_queuedBytes -= bytes;
+    m_deliveredBytes += bytes;
+
+    if (wasFull && !isFull())
+        emit spaceAvailable();
+}
+
+/**
+ * Registers the given number of discarded @a bytes
+ */
+void Subscription::drop(const qint64 bytes)
+{
+    m_droppedBytes += bytes;
+    ++m_droppedChunks;
+}
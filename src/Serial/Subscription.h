@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SERIAL_SUBSCRIPTION_H
+#define SERIAL_SUBSCRIPTION_H
+
+#include <QQueue>
+#include <QObject>
+#include <QByteArray>
+#include <QJsonObject>
+
+namespace Serial
+{
+/**
+ * Bounded queue of received data used by a single consumer (a bridge client, a
+ * control socket client, etc). Subscriptions are registered in @c Dispatcher when
+ * created, which appends the data received by @c Manager to every subscription.
+ *
+ * Consumers take data from the queue at their own pace. When the queue is full, the
+ * subscription applies its policy:
+ *
+ * - @c Block: reading from the device is limited to the free space of the queue &
+ *   paused until the consumer takes data from the queue (no data is lost, but all the
+ *   consumers are slowed down to the pace of this consumer, data that is not read is
+ *   kept by the device, which may apply flow control)
+ * - @c DropOldest: the oldest queued data is discarded
+ * - @c DropNewest: the new data is discarded
+ * - @c Disconnect: the queue is cleared & the @c overflowed() signal is emitted, the
+ *   consumer is expected to close its connection
+ *
+ * Discarded data is counted per subscription.
+ */
+class Subscription : public QObject
+{
+    Q_OBJECT
+
+signals:
+    void overflowed();
+    void dataAvailable();
+    void spaceAvailable();
+
+public:
+    enum class Policy
+    {
+        Block,
+        DropOldest,
+        DropNewest,
+        Disconnect
+    };
+
+    Subscription(const QString &name, const Policy policy, const qint64 capacity,
+                 QObject *parent = nullptr);
+    ~Subscription();
+
+    static QString policyName(const Policy policy);
+    static bool policyFromName(const QString &name, Policy &policy);
+
+    QString name() const;
+    Policy policy() const;
+    qint64 capacity() const;
+    qint64 freeSpace() const;
+
+    bool isFull() const;
+    bool isEmpty() const;
+    bool isOverflowed() const;
+
+    qint64 queuedBytes() const;
+    qint64 deliveredBytes() const;
+    qint64 droppedBytes() const;
+    qint64 droppedChunks() const;
+    qint64 highWaterMark() const;
+
+    QJsonObject toJson() const;
+
+    void push(const QByteArray &data);
+    QByteArray takeChunk();
+    QByteArray take(const qint64 maxSize = -1);
+
+private:
+    void drop(const qint64 bytes);
+    void taken(const qint64 bytes, const bool wasFull);
+
+private:
+    QString m_name;
+    Policy m_policy;
+    qint64 m_capacity;
+    bool m_overflowed;
+
+    QQueue<QByteArray> m_queue;
+    qint64 m_queuedBytes;
+    qint64 m_deliveredBytes;
+    qint64 m_droppedBytes;
+    qint64 m_droppedChunks;
+    qint64 m_highWaterMark;
+};
+}
+
+#endif
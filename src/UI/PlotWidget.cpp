@@ -0,0 +1,512 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cmath>
+#include <limits>
+
+#include <QPainter>
+#include <QWheelEvent>
+#include <QMouseEvent>
+
+#include <Misc/Tracer.h>
+#include <Plot/Dataset.h>
+#include <UI/PlotWidget.h>
+
+using namespace UI;
+
+/**
+ * Space reserved at the left of the plot for the labels of the vertical axis
+ */
+static const qreal LABEL_WIDTH = 64;
+
+/**
+ * Space reserved below the plot for the labels of the horizontal axis
+ */
+static const qreal AXIS_HEIGHT = 20;
+
+/**
+ * Space between the plot area & the borders of the widget
+ */
+static const qreal MARGIN = 8;
+
+/**
+ * Number of horizontal grid lines
+ */
+static const int GRID_LINES = 5;
+
+/**
+ * Range of the number of visible samples
+ */
+static const int MIN_VISIBLE_SAMPLES = 10;
+static const int MAX_VISIBLE_SAMPLES = 1000 * 1000 * 1000;
+
+/**
+ * Zoom factor applied for each step of the mouse wheel
+ */
+static const double ZOOM_STEP = 1.25;
+
+/**
+ * Constructor function
+ */
+PlotWidget::PlotWidget(QQuickItem *parent)
+    : QQuickPaintedItem(parent)
+    , m_following(true)
+    , m_visibleSamples(1000)
+    , m_lastSample(0)
+    , m_dragX(0)
+    , m_dragLast(0)
+    , m_gridColor(QColor(255, 255, 255, 32))
+    , m_textColor(Qt::lightGray)
+    , m_backgroundColor(Qt::black)
+{
+    setFlag(ItemHasContents, true);
+    setOpaquePainting(true);
+    setAcceptedMouseButtons(Qt::LeftButton);
+
+    // Redraw the plot when new samples are parsed (at most once per frame)
+    connect(Plot::Dataset::getInstance(), &Plot::Dataset::updated, this,
+            [=]() { update(); });
+}
+
+/**
+ * Draws the grid & the visible samples of every channel
+ */
+void PlotWidget::paint(QPainter *painter)
+{
+    TRACE_SCOPE("PlotWidget::paint", "ui");
+
+    // Draw background
+    painter->fillRect(boundingRect(), m_backgroundColor);
+
+    // Nothing to draw
+    auto dataset = Plot::Dataset::getInstance();
+    const int channels = dataset->channelCount();
+    if (dataset->sampleCount() <= dataset->firstSample() || channels == 0)
+    {
+        painter->setPen(m_textColor);
+        painter->drawText(boundingRect(), Qt::AlignCenter,
+                          tr("Waiting for numeric data..."));
+        return;
+    }
+
+    // Get plot area & visible interval
+    const QRectF area = plotArea();
+    if (area.width() <= 0 || area.height() <= 0)
+        return;
+
+    const qint64 last = viewEnd();
+    const qint64 first = last - m_visibleSamples;
+    const int columns = qMax(1, static_cast<int>(area.width()));
+    const bool joinSamples = m_visibleSamples <= columns * 2;
+
+    // Get the range of the visible values (from the min/max columns if there are more
+    // samples than pixels, so that each summary is only read once per frame)
+    double min = std::numeric_limits<double>::max();
+    double max = std::numeric_limits<double>::lowest();
+    if (joinSamples)
+    {
+        for (int i = 0; i < channels; ++i)
+        {
+            float lo, hi;
+            if (dataset->channel(i)->range(first, last, lo, hi))
+            {
+                min = qMin(min, static_cast<double>(lo));
+                max = qMax(max, static_cast<double>(hi));
+            }
+        }
+    }
+    else
+    {
+        m_lows.resize(channels * columns);
+        m_highs.resize(channels * columns);
+        for (int i = 0; i < channels; ++i)
+        {
+            float *lows = m_lows.data() + i * columns;
+            float *highs = m_highs.data() + i * columns;
+            dataset->channel(i)->columns(first, last, columns, lows, highs);
+            for (int j = 0; j < columns; ++j)
+            {
+                if (lows[j] <= highs[j])
+                {
+                    min = qMin(min, static_cast<double>(lows[j]));
+                    max = qMax(max, static_cast<double>(highs[j]));
+                }
+            }
+        }
+    }
+
+    // Ignore infinite values
+    if (!std::isfinite(min) || !std::isfinite(max))
+    {
+        min = qMax(min, -static_cast<double>(std::numeric_limits<float>::max()));
+        max = qMin(max, static_cast<double>(std::numeric_limits<float>::max()));
+    }
+
+    // Add some space above & below the values
+    if (min > max)
+    {
+        min = -1;
+        max = 1;
+    }
+    else if (min == max)
+    {
+        min -= 1;
+        max += 1;
+    }
+    else
+    {
+        const double padding = (max - min) * 0.05;
+        min -= padding;
+        max += padding;
+    }
+
+    // Draw grid & channels
+    drawGrid(painter, area, min, max, first, last);
+    painter->setClipRect(area);
+    for (int i = 0; i < channels; ++i)
+    {
+        painter->setPen(QPen(channelColor(i), 1));
+        if (joinSamples)
+            drawSamples(painter, area, dataset->channel(i), first, last, min, max);
+        else
+            drawColumns(painter, area, m_lows.constData() + i * columns,
+                        m_highs.constData() + i * columns, columns, min, max);
+    }
+}
+
+/**
+ * Returns @c true if the plot scrolls to show the newest samples
+ */
+bool PlotWidget::following() const
+{
+    return m_following;
+}
+
+/**
+ * Returns the number of samples shown in the plot
+ */
+int PlotWidget::visibleSamples() const
+{
+    return m_visibleSamples;
+}
+
+/**
+ * Returns the color of the grid lines
+ */
+QColor PlotWidget::gridColor() const
+{
+    return m_gridColor;
+}
+
+/**
+ * Returns the color of the axis labels
+ */
+QColor PlotWidget::textColor() const
+{
+    return m_textColor;
+}
+
+/**
+ * Returns the background color of the plot
+ */
+QColor PlotWidget::backgroundColor() const
+{
+    return m_backgroundColor;
+}
+
+/**
+ * Returns the color used to draw the given @a channel, hues are spread with the golden
+ * angle so that neighbouring channels always have different colors
+ */
+QColor PlotWidget::channelColor(const int channel)
+{
+    return QColor::fromHsv((channel * 137) % 360, 180, 240);
+}
+
+/**
+ * Enables or disables scrolling the plot to show the newest samples
+ */
+void PlotWidget::setFollowing(const bool following)
+{
+    if (m_following != following)
+    {
+        m_following = following;
+        emit followingChanged();
+        update();
+    }
+}
+
+/**
+ * Changes the number of samples shown in the plot
+ */
+void PlotWidget::setVisibleSamples(const int samples)
+{
+    const int value = qBound(MIN_VISIBLE_SAMPLES, samples, MAX_VISIBLE_SAMPLES);
+    if (m_visibleSamples != value)
+    {
+        m_visibleSamples = value;
+        emit visibleSamplesChanged();
+        update();
+    }
+}
+
+/**
+ * Changes the color of the grid lines
+ */
+void PlotWidget::setGridColor(const QColor &color)
+{
+    m_gridColor = color;
+    emit colorsChanged();
+    update();
+}
+
+/**
+ * Changes the color of the axis labels
+ */
+void PlotWidget::setTextColor(const QColor &color)
+{
+    m_textColor = color;
+    emit colorsChanged();
+    update();
+}
+
+/**
+ * Changes the background color of the plot
+ */
+void PlotWidget::setBackgroundColor(const QColor &color)
+{
+    m_backgroundColor = color;
+    emit colorsChanged();
+    update();
+}
+
+/**
+ * Zooms in or out around the sample under the cursor
+ */
+void PlotWidget::wheelEvent(QWheelEvent *event)
+{
+    const int delta = event->angleDelta().y();
+    const QRectF area = plotArea();
+    if (delta == 0 || area.width() <= 0)
+    {
+        event->ignore();
+        return;
+    }
+
+    // Get the sample under the cursor
+    const qint64 last = viewEnd();
+    const double x = (event->position().x() - area.left()) / area.width();
+    const double position = qBound(0.0, x, 1.0);
+    const double anchor = last - m_visibleSamples * (1 - position);
+
+    // Change the number of visible samples & keep the anchor under the cursor
+    const double factor = std::pow(ZOOM_STEP, -delta / 120.0);
+    const double samples = qBound<double>(MIN_VISIBLE_SAMPLES, m_visibleSamples * factor,
+                                          MAX_VISIBLE_SAMPLES);
+    setVisibleSamples(static_cast<int>(samples));
+    if (position < 1)
+        setViewEnd(static_cast<qint64>(anchor + m_visibleSamples * (1 - position)));
+
+    event->accept();
+}
+
+/**
+ * Registers the start of a drag operation
+ */
+void PlotWidget::mousePressEvent(QMouseEvent *event)
+{
+    m_dragX = event->localPos().x();
+    m_dragLast = viewEnd();
+    event->accept();
+}
+
+/**
+ * Pans the view while the mouse is dragged
+ */
+void PlotWidget::mouseMoveEvent(QMouseEvent *event)
+{
+    const QRectF area = plotArea();
+    if (area.width() <= 0)
+        return;
+
+    const double samplesPerPixel = m_visibleSamples / area.width();
+    const double offset = (event->localPos().x() - m_dragX) * samplesPerPixel;
+    setViewEnd(m_dragLast - static_cast<qint64>(offset));
+    event->accept();
+}
+
+/**
+ * Resumes following the newest samples
+ */
+void PlotWidget::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    setFollowing(true);
+    event->accept();
+}
+
+/**
+ * Returns the area in which the samples are drawn
+ */
+QRectF PlotWidget::plotArea() const
+{
+    return QRectF(LABEL_WIDTH, MARGIN, width() - LABEL_WIDTH - MARGIN,
+                  height() - MARGIN - AXIS_HEIGHT);
+}
+
+/**
+ * Returns the index after the last visible sample
+ */
+qint64 PlotWidget::viewEnd() const
+{
+    const qint64 count = Plot::Dataset::getInstance()->sampleCount();
+    if (m_following)
+        return count;
+
+    return qMin(m_lastSample, count);
+}
+
+/**
+ * Moves the view so that it ends at the given sample index, the plot follows new
+ * samples again if the view is moved past the newest sample
+ */
+void PlotWidget::setViewEnd(const qint64 last)
+{
+    auto dataset = Plot::Dataset::getInstance();
+    if (last >= dataset->sampleCount())
+        setFollowing(true);
+
+    else
+    {
+        const qint64 minimum = dataset->firstSample() + MIN_VISIBLE_SAMPLES;
+        m_lastSample = qMax(last, minimum);
+        setFollowing(false);
+        update();
+    }
+}
+
+/**
+ * Draws the horizontal grid lines, the labels of the vertical axis & the indexes of
+ * the first & last visible samples
+ */
+void PlotWidget::drawGrid(QPainter *painter, const QRectF &area, const double min,
+                          const double max, const qint64 first, const qint64 last)
+{
+    for (int i = 0; i <= GRID_LINES; ++i)
+    {
+        const qreal y = area.bottom() - area.height() * i / GRID_LINES;
+        const double value = min + (max - min) * i / GRID_LINES;
+
+        painter->setPen(m_gridColor);
+        painter->drawLine(QPointF(area.left(), y), QPointF(area.right(), y));
+
+        painter->setPen(m_textColor);
+        painter->drawText(QRectF(0, y - 10, LABEL_WIDTH - MARGIN, 20),
+                          Qt::AlignRight | Qt::AlignVCenter,
+                          QString::number(value, 'g', 5));
+    }
+
+    const QRectF axis(area.left(), area.bottom(), area.width(), AXIS_HEIGHT);
+    painter->drawText(axis, Qt::AlignLeft | Qt::AlignVCenter, QString::number(first));
+    painter->drawText(axis, Qt::AlignRight | Qt::AlignVCenter,
+                      m_following ? tr("%1 (live)").arg(last) : QString::number(last));
+}
+
+/**
+ * Joins the samples of the [@a first, @a last) interval of the given channel with
+ * lines, used when there are less than two samples per pixel column
+ */
+void PlotWidget::drawSamples(QPainter *painter, const QRectF &area,
+                             const Plot::Pyramid *data, const qint64 first,
+                             const qint64 last, const double min, const double max)
+{
+    const double scale = area.height() / (max - min);
+    auto mapY = [&](const double value) {
+        return area.bottom() - (value - min) * scale;
+    };
+
+    m_lines.clear();
+    const qreal dx = area.width() / qMax<qint64>(1, last - first - 1);
+    float previous = data->at(first);
+    for (qint64 i = first + 1; i < last; ++i)
+    {
+        const float value = data->at(i);
+        if (std::isfinite(previous) && std::isfinite(value))
+        {
+            m_lines.append(QLineF(area.left() + dx * (i - 1 - first), mapY(previous),
+                                  area.left() + dx * (i - first), mapY(value)));
+        }
+
+        previous = value;
+    }
+
+    painter->drawLines(m_lines);
+}
+
+/**
+ * Draws one vertical segment for each pixel column between the @a lows & @a highs
+ * values of the column. Each segment is extended to reach the range of the previous
+ * column, so that the trace stays continuous with a single segment per column.
+ */
+void PlotWidget::drawColumns(QPainter *painter, const QRectF &area, const float *lows,
+                             const float *highs, const int columns, const double min,
+                             const double max)
+{
+    const double scale = area.height() / (max - min);
+    auto mapY = [&](const double value) {
+        return area.bottom() - (value - min) * scale;
+    };
+
+    m_lines.clear();
+    bool connected = false;
+    float previousLow = 0;
+    float previousHigh = 0;
+    for (int column = 0; column < columns; ++column)
+    {
+        // No values in this column
+        float lo = lows[column];
+        float hi = highs[column];
+        if (lo > hi)
+        {
+            connected = false;
+            continue;
+        }
+
+        // Join the column with the previous column
+        const float columnLow = lo;
+        const float columnHigh = hi;
+        if (connected)
+        {
+            lo = qMin(lo, previousHigh);
+            hi = qMax(hi, previousLow);
+        }
+
+        // Add column segment
+        const qreal x = area.left() + column + 0.5;
+        m_lines.append(QLineF(x, mapY(lo), x, mapY(hi)));
+
+        connected = true;
+        previousLow = columnLow;
+        previousHigh = columnHigh;
+    }
+
+    painter->drawLines(m_lines);
+}
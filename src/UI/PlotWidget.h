@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef UI_PLOT_WIDGET_H
+#define UI_PLOT_WIDGET_H
+
+#include <QColor>
+#include <QVector>
+#include <QLineF>
+#include <QQuickPaintedItem>
+
+#include <Plot/Pyramid.h>
+
+namespace UI
+{
+/**
+ * Draws the channels of @c Plot::Dataset as line series. The widget shows
+ * @c visibleSamples samples & scales the vertical axis to the range of the visible
+ * values. While @c following is set, the view scrolls as new samples are received.
+ *
+ * The mouse wheel zooms around the cursor, dragging pans the view (which stops
+ * following new samples) & a double click resumes following the newest samples.
+ *
+ * When there are more than two samples per horizontal pixel, the min/max values of
+ * each pixel column are read from the pyramid of the channel & drawn as one vertical
+ * segment, so that spikes are never hidden & the number of drawn segments is bounded
+ * by twice the width of the plot at any zoom level.
+ */
+class PlotWidget : public QQuickPaintedItem
+{
+    // clang-format off
+    Q_OBJECT
+    QML_ELEMENT
+    Q_PROPERTY(int visibleSamples
+               READ visibleSamples
+               WRITE setVisibleSamples
+               NOTIFY visibleSamplesChanged)
+    Q_PROPERTY(bool following
+               READ following
+               WRITE setFollowing
+               NOTIFY followingChanged)
+    Q_PROPERTY(QColor backgroundColor
+               READ backgroundColor
+               WRITE setBackgroundColor
+               NOTIFY colorsChanged)
+    Q_PROPERTY(QColor gridColor
+               READ gridColor
+               WRITE setGridColor
+               NOTIFY colorsChanged)
+    Q_PROPERTY(QColor textColor
+               READ textColor
+               WRITE setTextColor
+               NOTIFY colorsChanged)
+    // clang-format on
+
+signals:
+    void colorsChanged();
+    void followingChanged();
+    void visibleSamplesChanged();
+
+public:
+    PlotWidget(QQuickItem *parent = 0);
+
+    virtual void paint(QPainter *painter) override;
+
+    bool following() const;
+    int visibleSamples() const;
+    QColor gridColor() const;
+    QColor textColor() const;
+    QColor backgroundColor() const;
+
+    static QColor channelColor(const int channel);
+
+public slots:
+    void setFollowing(const bool following);
+    void setVisibleSamples(const int samples);
+    void setGridColor(const QColor &color);
+    void setTextColor(const QColor &color);
+    void setBackgroundColor(const QColor &color);
+
+protected:
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+private:
+    QRectF plotArea() const;
+    qint64 viewEnd() const;
+    void setViewEnd(const qint64 last);
+
+    void drawGrid(QPainter *painter, const QRectF &area, const double min,
+                  const double max, const qint64 first, const qint64 last);
+    void drawSamples(QPainter *painter, const QRectF &area, const Plot::Pyramid *data,
+                     const qint64 first, const qint64 last, const double min,
+                     const double max);
+    void drawColumns(QPainter *painter, const QRectF &area, const float *lows,
+                     const float *highs, const int columns, const double min,
+                     const double max);
+
+private:
+    bool m_following;
+    int m_visibleSamples;
+    qint64 m_lastSample;
+
+    qreal m_dragX;
+    qint64 m_dragLast;
+
+    QVector<float> m_lows;
+    QVector<float> m_highs;
+
+    QColor m_gridColor;
+    QColor m_textColor;
+    QColor m_backgroundColor;
+    QVector<QLineF> m_lines;
+};
+}
+
+#endif
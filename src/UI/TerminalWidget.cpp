@@ -24,7 +24,10 @@
 #include <QScrollBar>
 #include <QApplication>
 #include <Serial/Console.h>
+#include <Misc/Tracer.h>
+#include <Misc/MemoryMonitor.h>
 #include <UI/TerminalWidget.h>
+#include <Misc/LatencyMonitor.h>
 
 using namespace UI;
 
@@ -53,6 +56,7 @@ TerminalWidget::TerminalWidget(QQuickItem *parent)
     , m_copyAvailable(false)
     , m_textEdit(new QPlainTextEdit)
     , m_terminalState(VT100_Text)
+    , m_commitTimestamp(0)
 {
     // Set item flags
     setFlag(ItemHasContents, true);
@@ -87,6 +91,9 @@ TerminalWidget::TerminalWidget(QQuickItem *parent)
 
     // React to widget events
     connect(textEdit(), SIGNAL(copyAvailable(bool)), this, SLOT(setCopyAvailable(bool)));
+
+    // Include the text document in the memory usage reports
+    Misc::MemoryMonitor::getInstance()->registerDocument(document());
 }
 
 /**
@@ -131,8 +138,21 @@ bool TerminalWidget::event(QEvent *event)
  */
 void TerminalWidget::paint(QPainter *painter)
 {
+    TRACE_SCOPE("TerminalWidget::paint", "ui");
+
     if (m_textEdit && painter)
+    {
         textEdit()->render(painter);
+
+        // Register the time needed to render received data
+        auto readTimestamp = m_commitTimestamp.exchange(0);
+        if (readTimestamp > 0)
+        {
+            auto elapsed = Misc::LatencyMonitor::timestamp() - readTimestamp;
+            Misc::LatencyMonitor::getInstance()->record(
+                Misc::LatencyMonitor::Stage::Commit, elapsed);
+        }
+    }
 }
 
 /**
@@ -500,6 +520,20 @@ void TerminalWidget::setAutoscroll(const bool enabled)
 void TerminalWidget::insertText(const QString &text)
 {
     addText(text, vt100emulation());
+
+    // Register the time needed to insert received data, the read timestamp is kept
+    // until the text is rendered (if several blocks are inserted between two frames,
+    // we keep the oldest one)
+    auto readTimestamp = Serial::Console::getInstance()->displayTimestamp();
+    if (readTimestamp > 0)
+    {
+        auto elapsed = Misc::LatencyMonitor::timestamp() - readTimestamp;
+        Misc::LatencyMonitor::getInstance()->record(Misc::LatencyMonitor::Stage::Insert,
+                                                    elapsed);
+
+        qint64 expected = 0;
+        m_commitTimestamp.compare_exchange_strong(expected, readTimestamp);
+    }
 }
 
 /**
@@ -532,8 +566,8 @@ void TerminalWidget::setCenterOnScroll(const bool enabled)
 
 /**
  * Enables/disables interpretation of VT-100 escape secuences. This can be useful when
- * interfacing through network ports or interfacing with a MCU that implements some
- * kind of shell.
+ * interfacing through network ports (see @c Serial::Backend::create()) or interfacing
+ * with a MCU that implements some kind of shell.
  */
 void TerminalWidget::setVt100Emulation(const bool enabled)
 {
@@ -654,17 +688,22 @@ void TerminalWidget::setCopyAvailable(const bool yes)
  */
 void TerminalWidget::addText(const QString &text, const bool enableVt100)
 {
+    TRACE_SCOPE("TerminalWidget::addText", "ui");
+
     // Get text to insert
     QString textToInsert = text;
     if (enableVt100)
         textToInsert = vt100Processing(text);
 
     // Add text at the end of the text document
-    QTextCursor cursor(textEdit()->document());
-    cursor.beginEditBlock();
-    cursor.movePosition(QTextCursor::End);
-    cursor.insertText(textToInsert);
-    cursor.endEditBlock();
+    {
+        TRACE_SCOPE("QTextDocument::insert", "ui");
+        QTextCursor cursor(textEdit()->document());
+        cursor.beginEditBlock();
+        cursor.movePosition(QTextCursor::End);
+        cursor.insertText(textToInsert);
+        cursor.endEditBlock();
+    }
 
     // Autoscroll to bottom (if needed)
     updateScrollbarVisibility();
@@ -759,6 +798,32 @@ void TerminalWidget::processWheelEvents(QWheelEvent *event)
     }
 }
 
+/**
+ * Removes the last line (and the line break that precedes it) of the terminal. The
+ * pending @a text that has not been inserted in the document yet is modified first,
+ * the document is only modified if @a text does not contain any line break.
+ */
+void TerminalWidget::clearLastLine(QString &text)
+{
+    // The last line is contained in the pending text
+    auto lineBreak = text.lastIndexOf('\n');
+    if (lineBreak >= 0)
+    {
+        text.truncate(lineBreak);
+        return;
+    }
+
+    // Remove the last block of the document
+    text.clear();
+    QTextCursor cursor(textEdit()->document());
+    cursor.beginEditBlock();
+    cursor.movePosition(QTextCursor::End);
+    cursor.movePosition(QTextCursor::StartOfBlock, QTextCursor::KeepAnchor);
+    cursor.removeSelectedText();
+    cursor.deletePreviousChar();
+    cursor.endEditBlock();
+}
+
 /**
  * Processes the given @a data to remove the escape sequences from the text. Colors and
  * text format is not processed.
@@ -768,6 +833,10 @@ void TerminalWidget::processWheelEvents(QWheelEvent *event)
  *
  * I did the necessary stuff to be able to watch ASCII Star Wars from Serial Studio.
  * If you want/need to do more stuff, please make a PR.
+ *
+ * Text is accumulated and returned to the caller, which inserts it in a single step.
+ * The text document is only modified when a command needs to (clear screen & clear
+ * line), so that the processing time stays linear with the size of the input.
  */
 QString TerminalWidget::vt100Processing(const QString &data)
 {
@@ -776,39 +845,29 @@ QString TerminalWidget::vt100Processing(const QString &data)
     bool hasNumbers = false;
     bool hasCommand = false;
 
+    text.reserve(data.length());
     for (int i = 0; i < data.length(); ++i)
     {
-        QChar c = data.at(i);
+        const QChar c = data.at(i);
         switch (m_terminalState)
         {
             case VT100_Text:
-                if (c == 0x1B)
-                {
-                    addText(text, false);
-                    text.clear();
+                if (c == QChar(0x1B))
                     m_terminalState = VT100_Escape;
-                }
-
-                else if (c == "\n")
-                {
-                    addText(text + "\n", false);
-                    text.clear();
-                }
-
                 else
                     text.append(c);
 
                 break;
             case VT100_Escape:
                 command.clear();
-                if (c == "[")
+                if (c == '[')
                     m_terminalState = VT100_Command;
-                else if (c == "(")
+                else if (c == '(')
                     m_terminalState = VT100_ResetFont;
                 break;
             case VT100_Command:
                 // Go to escape sequence
-                if (c == 0x1B)
+                if (c == QChar(0x1B))
                 {
                     m_terminalState = VT100_Escape;
                     break;
@@ -826,32 +885,26 @@ QString TerminalWidget::vt100Processing(const QString &data)
                 // Construct command
                 command.append(c);
 
-                // Clear screen
-                if (command == "2J")
+                // Clear screen (pending text is discarded too)
+                if (command == QLatin1String("2J"))
                 {
+                    text.clear();
                     textEdit()->clear();
                     m_terminalState = VT100_Text;
                 }
 
                 // Move cursor to upper left corner (ugly implementation)
-                else if (command == "H")
+                else if (command == QLatin1String("H"))
                 {
+                    text.clear();
                     textEdit()->clear();
                     m_terminalState = VT100_Text;
                 }
 
-                // Clear line
-                else if (command == "2K")
+                // Clear line, remove the last line together with its line break
+                else if (command == QLatin1String("2K"))
                 {
-                    textEdit()->setFocus();
-                    auto storedCursor = textEdit()->textCursor();
-                    textEdit()->moveCursor(QTextCursor::End, QTextCursor::MoveAnchor);
-                    textEdit()->moveCursor(QTextCursor::StartOfLine,
-                                           QTextCursor::MoveAnchor);
-                    textEdit()->moveCursor(QTextCursor::End, QTextCursor::KeepAnchor);
-                    textEdit()->textCursor().removeSelectedText();
-                    textEdit()->textCursor().deletePreviousChar();
-                    textEdit()->setTextCursor(storedCursor);
+                    clearLastLine(text);
                     m_terminalState = VT100_Text;
                 }
 
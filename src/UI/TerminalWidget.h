@@ -23,10 +23,16 @@
 #ifndef UI_QML_PLAINTEXTEDIT_H
 #define UI_QML_PLAINTEXTEDIT_H
 
+#include <atomic>
 #include <QPainter>
 #include <QPlainTextEdit>
 #include <QQuickPaintedItem>
 
+namespace Benchmark
+{
+class FuzzBenchmark;
+}
+
 namespace UI
 {
 class TerminalWidget : public QQuickPaintedItem
@@ -187,6 +193,9 @@ protected:
     void processWheelEvents(QWheelEvent *event);
 
 private:
+    friend class Benchmark::FuzzBenchmark;
+
+    void clearLastLine(QString &text);
     QString vt100Processing(const QString &data);
 
 private:
@@ -196,6 +205,7 @@ private:
     bool m_copyAvailable;
     QPlainTextEdit *m_textEdit;
     VT100_State m_terminalState;
+    std::atomic<qint64> m_commitTimestamp;
 };
 }
 
@@ -23,21 +23,95 @@
 #include <QtQml>
 #include <QSysInfo>
 #include <QQuickStyle>
+#include <QQuickWindow>
 #include <QApplication>
+#include <QScopedPointer>
 #include <QStyleFactory>
+#include <QCommandLineParser>
 #include <QQmlApplicationEngine>
 
 #include <AppInfo.h>
+#include <Misc/Tracer.h>
 #include <Misc/Utilities.h>
+#include <Misc/StatsServer.h>
+#include <Misc/StartupProfiler.h>
+#include <Misc/MemoryMonitor.h>
+#include <Misc/LatencyMonitor.h>
+#include <Network/Bridge.h>
+#include <Network/ControlServer.h>
+#include <Network/WebSocketServer.h>
+#include <Plot/Dataset.h>
+#include <Plot/FieldStatistics.h>
 #include <Serial/Console.h>
 #include <Serial/Manager.h>
+#include <Serial/Statistics.h>
+#include <Serial/Subscription.h>
+#include <CLI/Streamer.h>
+#include <Decoder/NmeaMonitor.h>
+#include <Decoder/ModbusMonitor.h>
+#include <UI/PlotWidget.h>
 #include <UI/TerminalWidget.h>
 #include <Serial/FileTransmission.h>
+#include <Benchmark/FuzzBenchmark.h>
+#include <Benchmark/PlotBenchmark.h>
+#include <Benchmark/DecoderBenchmark.h>
+#include <Benchmark/ConsoleBenchmark.h>
+
+#ifdef Q_OS_UNIX
+#    include <Misc/SharedRing.h>
+#    include <Benchmark/PtyBenchmark.h>
+#endif
 
 #ifdef Q_OS_WIN
 #    include <windows.h>
 #endif
 
+/**
+ * Returns @c true if the command line arguments contain the given @a option. This is
+ * used to obtain options that must be known before the application object is created.
+ */
+static bool HasOption(int argc, char **argv, const char *option)
+{
+    // Match "--option" & "--option=value", but not other options with the same prefix
+    const uint length = qstrlen(option);
+    for (int i = 1; i < argc; ++i)
+    {
+        if (qstrncmp(argv[i], option, length) == 0
+            && (argv[i][length] == '\0' || argv[i][length] == '='))
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * Maximum memory used by the plot history, set with the --plot-memory option
+ */
+static qint64 PLOT_MEMORY_LIMIT = 0;
+
+/**
+ * Returns the instance of the given singleton class to QML. Modules registered with
+ * this function are only created when a QML window uses them for the first time.
+ */
+template<typename T>
+static QObject *QmlSingleton(QQmlEngine *engine, QJSEngine *scriptEngine)
+{
+    Q_UNUSED(scriptEngine);
+
+    auto instance = T::getInstance();
+    engine->setObjectOwnership(instance, QQmlEngine::CppOwnership);
+    return instance;
+}
+
+/**
+ * Returns the plot dataset to QML, applying the memory limit of the plot history
+ */
+static QObject *QmlDataset(QQmlEngine *engine, QJSEngine *scriptEngine)
+{
+    Plot::Dataset::getInstance()->setMemoryLimit(PLOT_MEMORY_LIMIT);
+    return QmlSingleton<Plot::Dataset>(engine, scriptEngine);
+}
+
 /**
  * @brief Entry-point function of the application
  *
@@ -48,6 +122,9 @@
  */
 int main(int argc, char **argv)
 {
+    // Start measuring the startup time
+    auto profiler = Misc::StartupProfiler::getInstance();
+
     // Fix console output on Windows (https://stackoverflow.com/a/41701133)
     // This code will only execute if the application is started from the comamnd prompt
 #ifdef _WIN32
@@ -62,27 +139,284 @@ int main(int argc, char **argv)
     }
 #endif
 
+    // Benchmarks do not need a visible user interface
+    if (HasOption(argc, argv, "--benchmark"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
     // Set application attributes
     QApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
 
+    // The headless mode does not load any GUI module
+    const bool headless = HasOption(argc, argv, "--headless")
+        || HasOption(argc, argv, "--list-ports") || HasOption(argc, argv, "--sniff")
+        || HasOption(argc, argv, "--broadcast");
+
     // Init. application
-    QApplication app(argc, argv);
-    app.setApplicationName(APP_NAME);
-    app.setApplicationVersion(APP_VERSION);
-    app.setOrganizationName(APP_DEVELOPER);
-    app.setOrganizationDomain(APP_SUPPORT_URL);
-    app.setStyle(QStyleFactory::create("Fusion"));
+    QScopedPointer<QCoreApplication> app;
+    if (headless)
+        app.reset(new QCoreApplication(argc, argv));
+    else
+    {
+        app.reset(new QApplication(argc, argv));
+        QApplication::setStyle(QStyleFactory::create("Fusion"));
+    }
 
-    // Init application modules
+    // Set application info
+    app->setApplicationName(APP_NAME);
+    app->setApplicationVersion(APP_VERSION);
+    app->setOrganizationName(APP_DEVELOPER);
+    app->setOrganizationDomain(APP_SUPPORT_URL);
+    profiler->mark("Application object");
+
+    // Set command line options
+    QCommandLineParser parser;
+    parser.setApplicationDescription(APP_NAME);
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption benchmark("benchmark",
+                                 "Run the given benchmark suite (console, decoder, "
+                                 "fuzz, plot, pty).",
+                                 "suite");
+    QCommandLineOption benchmarkOutput("benchmark-output",
+                                       "Write the JSON benchmark report to <file>.",
+                                       "file");
+    QCommandLineOption benchmarkMaxSize("benchmark-max-size",
+                                        "Size of the largest benchmark input.", "bytes",
+                                        "104857600");
+    QCommandLineOption benchmarkRate("benchmark-rate",
+                                     "Bytes per second written by the pty benchmark "
+                                     "(0 = as fast as possible).",
+                                     "bytes", "0");
+    QCommandLineOption benchmarkDuration("benchmark-duration",
+                                         "Duration of the pty benchmark.", "seconds",
+                                         "10");
+    QCommandLineOption latencyReport("latency-report",
+                                     "Write the latency distribution of the data "
+                                     "pipeline to <file> when the application exits.",
+                                     "file");
+    QCommandLineOption trace("trace",
+                             "Record trace events & write them to <file> (Chrome "
+                             "trace-event format) when the application exits.",
+                             "file");
+    QCommandLineOption memoryLog("memory-log",
+                                 "Write a summary of the memory used by each buffer to "
+                                 "the log every <seconds>.",
+                                 "seconds");
+    QCommandLineOption statsPort("stats-port",
+                                 "Serve the serial port statistics over HTTP on "
+                                 "localhost:<port> (/stats & /metrics).",
+                                 "port");
+    QCommandLineOption startupProfile("startup-profile",
+                                      "Exit after rendering the first frame (the "
+                                      "startup time of each phase is written to the "
+                                      "log).");
+    QCommandLineOption bridgePort("bridge-port",
+                                  "Share the serial port with other applications "
+                                  "through the given TCP <port>.",
+                                  "port");
+    QCommandLineOption bridgeAddress("bridge-address",
+                                     "Address used by the TCP bridge (default: "
+                                     "127.0.0.1).",
+                                     "address", "127.0.0.1");
+    QCommandLineOption bridgePolicy("bridge-policy",
+                                    "Policy applied to slow TCP bridge clients: block, "
+                                    "drop-oldest, drop-newest or disconnect (default).",
+                                    "policy", "disconnect");
+    QCommandLineOption bridgeQueue("bridge-queue",
+                                   "Size of the queue of each TCP bridge client (in "
+                                   "bytes, default: 8 MB).",
+                                   "bytes", "8388608");
+    QCommandLineOption controlSocket("control-socket",
+                                     "Accept automation commands (newline-delimited "
+                                     "JSON) on the local socket with the given <name> "
+                                     "or path.",
+                                     "name");
+    QCommandLineOption webSocketPort("websocket-port",
+                                     "Stream received lines to browser dashboards "
+                                     "through a WebSocket server on localhost:<port>.",
+                                     "port");
+    QCommandLineOption plotMemory("plot-memory",
+                                  "Maximum memory used by the plot history before old "
+                                  "samples are discarded (default: 1024 MB).",
+                                  "MB", "1024");
+#ifdef Q_OS_UNIX
+    QCommandLineOption shmRing("shm-ring",
+                               "Publish received & transmitted data in the POSIX "
+                               "shared memory object with the given <name>.",
+                               "name");
+    QCommandLineOption shmSize("shm-size",
+                               "Size of the shared memory ring data area (in bytes, "
+                               "default: 4 MB).",
+                               "bytes", "4194304");
+#endif
+    parser.addOption(benchmark);
+    parser.addOption(benchmarkOutput);
+    parser.addOption(benchmarkMaxSize);
+    parser.addOption(benchmarkRate);
+    parser.addOption(benchmarkDuration);
+    parser.addOption(latencyReport);
+    parser.addOption(trace);
+    parser.addOption(memoryLog);
+    parser.addOption(statsPort);
+    parser.addOption(startupProfile);
+    parser.addOption(bridgePort);
+    parser.addOption(bridgeAddress);
+    parser.addOption(bridgePolicy);
+    parser.addOption(bridgeQueue);
+    parser.addOption(controlSocket);
+    parser.addOption(webSocketPort);
+    parser.addOption(plotMemory);
+#ifdef Q_OS_UNIX
+    parser.addOption(shmRing);
+    parser.addOption(shmSize);
+#endif
+    CLI::Streamer::addOptions(parser);
+    parser.process(*app);
+    profiler->mark("Command line parsing");
+
+    // Start recording trace events
+    auto tracer = Misc::Tracer::getInstance();
+    if (parser.isSet(trace))
+    {
+        auto path = parser.value(trace);
+        tracer->setEnabled(true);
+        QObject::connect(app.data(), &QCoreApplication::aboutToQuit, tracer,
+                         [=]() { tracer->write(path); });
+    }
+
+    // Run benchmark suite & exit
+    if (parser.isSet(benchmark))
+    {
+        auto suite = parser.value(benchmark);
+        auto output = parser.value(benchmarkOutput);
+        auto maxSize = parser.value(benchmarkMaxSize).toLongLong();
+        auto rate = parser.value(benchmarkRate).toLongLong();
+        auto duration = parser.value(benchmarkDuration).toInt();
+
+        // Run suite
+        int code = EXIT_FAILURE;
+        if (suite == "console")
+            code = Benchmark::ConsoleBenchmark(maxSize).exec(output);
+        else if (suite == "decoder")
+            code = Benchmark::DecoderBenchmark(maxSize).exec(output);
+        else if (suite == "fuzz")
+            code = Benchmark::FuzzBenchmark(maxSize).exec(output);
+        else if (suite == "plot")
+            code = Benchmark::PlotBenchmark(maxSize).exec(output);
+#ifdef Q_OS_UNIX
+        else if (suite == "pty")
+            code = Benchmark::PtyBenchmark(rate, duration).exec(output);
+#endif
+        else
+            qWarning() << "Unknown benchmark suite" << suite;
+
+        // Write trace events
+        if (tracer->enabled())
+            tracer->write(parser.value(trace));
+
+        return code;
+    }
+
+    // Start collecting serial port statistics
+    auto statistics = Serial::Statistics::getInstance();
+    if (parser.isSet(statsPort))
+    {
+        auto port = parser.value(statsPort).toUShort();
+        if (!Misc::StatsServer::getInstance()->listen(port))
+            return EXIT_FAILURE;
+    }
+
+    // Share the serial port through TCP
+    if (parser.isSet(bridgePort))
+    {
+        auto policy = Serial::Subscription::Policy::Disconnect;
+        if (!Serial::Subscription::policyFromName(parser.value(bridgePolicy), policy))
+        {
+            qWarning() << "Invalid TCP bridge policy" << parser.value(bridgePolicy);
+            return EXIT_FAILURE;
+        }
+
+        auto port = parser.value(bridgePort).toUShort();
+        auto address = QHostAddress(parser.value(bridgeAddress));
+        auto bridge = Network::Bridge::getInstance();
+        bridge->setQueuePolicy(policy, parser.value(bridgeQueue).toLongLong());
+        if (!bridge->listen(port, address))
+            return EXIT_FAILURE;
+    }
+
+    // Publish the data stream in shared memory
+#ifdef Q_OS_UNIX
+    if (parser.isSet(shmRing))
+    {
+        auto size = parser.value(shmSize).toLongLong();
+        if (!Misc::SharedRing::getInstance()->open(parser.value(shmRing), size))
+            return EXIT_FAILURE;
+
+        QObject::connect(app.data(), &QCoreApplication::aboutToQuit,
+                         Misc::SharedRing::getInstance(), &Misc::SharedRing::close);
+    }
+#endif
+
+    // Stream received data to browser dashboards
+    if (parser.isSet(webSocketPort))
+    {
+        auto port = parser.value(webSocketPort).toUShort();
+        if (!Network::WebSocketServer::getInstance()->listen(port))
+            return EXIT_FAILURE;
+    }
+
+    // Accept automation commands through a local socket
+    if (parser.isSet(controlSocket))
+    {
+        if (!Network::ControlServer::getInstance()->listen(parser.value(controlSocket)))
+            return EXIT_FAILURE;
+    }
+
+    // Stream data without loading the user interface & exit
+    if (headless)
+        return CLI::Streamer().exec(parser);
+
+    // Create QML engine
     QQmlApplicationEngine engine;
+    profiler->mark("QML engine creation");
+
+    // Init application modules
     auto manager = Serial::Manager::getInstance();
     auto console = Serial::Console::getInstance();
     auto utilities = Misc::Utilities::getInstance();
+    auto memoryMonitor = Misc::MemoryMonitor::getInstance();
+    auto latencyMonitor = Misc::LatencyMonitor::getInstance();
     auto fileTransmission = Serial::FileTransmission::getInstance();
+    profiler->mark("Singleton init");
+
+    // Limit the memory used by the plot history
+    PLOT_MEMORY_LIMIT = parser.value(plotMemory).toLongLong() * 1024 * 1024;
+
+    // Log memory usage periodically
+    if (parser.isSet(memoryLog))
+        memoryMonitor->setLogInterval(parser.value(memoryLog).toInt());
+
+    // Write latency report when the application exits
+    if (parser.isSet(latencyReport))
+    {
+        auto path = parser.value(latencyReport);
+        QObject::connect(app.data(), &QCoreApplication::aboutToQuit, latencyMonitor,
+                         [=]() { latencyMonitor->dump(path); });
+    }
 
     // Register custom QML properties
+    qmlRegisterType<UI::PlotWidget>("UI", 1, 0, "PlotWidget");
     qmlRegisterType<UI::TerminalWidget>("UI", 1, 0, "TerminalWidget");
 
+    // Register modules that are created when their window is opened
+    qmlRegisterSingletonType<Plot::Dataset>("Plot", 1, 0, "Dataset", QmlDataset);
+    qmlRegisterSingletonType<Decoder::ModbusMonitor>(
+        "Decoder", 1, 0, "ModbusMonitor", QmlSingleton<Decoder::ModbusMonitor>);
+    qmlRegisterSingletonType<Decoder::NmeaMonitor>(
+        "Decoder", 1, 0, "NmeaMonitor", QmlSingleton<Decoder::NmeaMonitor>);
+    qmlRegisterSingletonType<Plot::FieldStatistics>(
+        "Plot", 1, 0, "FieldStatistics", QmlSingleton<Plot::FieldStatistics>);
+
     // Configure dark UI
     Misc::Utilities::configureDarkUi();
 
@@ -92,18 +426,34 @@ int main(int argc, char **argv)
     c->setContextProperty("Cpp_AppIcon", "qrc" APP_ICON);
     c->setContextProperty("Cpp_Serial_Manager", manager);
     c->setContextProperty("Cpp_Serial_Console", console);
+    c->setContextProperty("Cpp_Serial_Statistics", statistics);
+    c->setContextProperty("Cpp_Misc_Tracer", tracer);
     c->setContextProperty("Cpp_Misc_Utilities", utilities);
-    c->setContextProperty("Cpp_AppName", app.applicationName());
-    c->setContextProperty("Cpp_AppVersion", app.applicationVersion());
-    c->setContextProperty("Cpp_AppOrganization", app.organizationName());
+    c->setContextProperty("Cpp_Misc_MemoryMonitor", memoryMonitor);
+    c->setContextProperty("Cpp_Misc_LatencyMonitor", latencyMonitor);
+    c->setContextProperty("Cpp_AppName", app->applicationName());
+    c->setContextProperty("Cpp_AppVersion", app->applicationVersion());
+    c->setContextProperty("Cpp_AppOrganization", app->organizationName());
     c->setContextProperty("Cpp_Serial_FileTransmission", fileTransmission);
-    c->setContextProperty("Cpp_AppOrganizationDomain", app.organizationDomain());
+    c->setContextProperty("Cpp_AppOrganizationDomain", app->organizationDomain());
     engine.load(QUrl(QStringLiteral("qrc:/qml/main.qml")));
 
     // QML error, exit
     if (engine.rootObjects().isEmpty())
         return EXIT_FAILURE;
 
+    // Finish measuring the startup time when the first frame is rendered
+    profiler->mark("QML loading");
+    auto window = qobject_cast<QQuickWindow *>(engine.rootObjects().first());
+    if (window)
+        QObject::connect(window, &QQuickWindow::frameSwapped, profiler,
+                         &Misc::StartupProfiler::finish);
+
+    // Exit after startup (used to measure the startup time)
+    if (parser.isSet(startupProfile))
+        QObject::connect(profiler, &Misc::StartupProfiler::finished, app.data(),
+                         &QCoreApplication::quit, Qt::QueuedConnection);
+
     // Enter application event loop
-    return app.exec();
+    return app->exec();
 }